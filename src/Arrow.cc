@@ -0,0 +1,397 @@
+#include <cstring>
+#include <memory>
+#include <new>
+
+#include "Common.h"
+#include "Arrow.h"
+
+namespace EDM_Arrow {
+    //------------------------------------------------------------
+    // Exported schema: child schemas are owned here, each child
+    // owns its name
+    //------------------------------------------------------------
+    struct SchemaData {
+        std::vector< ArrowSchema >   children;
+        std::vector< ArrowSchema * > childPointers;
+    };
+
+    struct ChildSchemaData {
+        std::string name;
+    };
+
+    //------------------------------------------------------------
+    // Exported array: child arrays are owned here, each child holds
+    // the column-major values of its column and owns its buffers
+    //------------------------------------------------------------
+    struct ArrayData {
+        const void                 *structBuffers[ 1 ];
+        std::vector< ArrowArray >   children;
+        std::vector< ArrowArray * > childPointers;
+    };
+
+    struct ChildArrayData {
+        DataFrame< double > values;  // shared by the children
+        const void         *buffers[ 2 ];
+    };
+
+    //------------------------------------------------------------
+    // Release callbacks. A child moved out of an exported struct
+    // by the consumer is released on its own: the parent releases
+    // the children not yet released.
+    //------------------------------------------------------------
+    void ReleaseChildSchema( ArrowSchema *schema ) {
+        delete static_cast< ChildSchemaData * >( schema->private_data );
+        schema->release = nullptr;
+    }
+
+    void ReleaseSchema( ArrowSchema *schema ) {
+        SchemaData *data = static_cast< SchemaData * >( schema->private_data );
+        for ( size_t i = 0; i < data->children.size(); i++ ) {
+            if ( data->children[ i ].release ) {
+                data->children[ i ].release( &data->children[ i ] );
+            }
+        }
+        delete data;
+        schema->release = nullptr;
+    }
+
+    void ReleaseChildArray( ArrowArray *array ) {
+        delete static_cast< ChildArrayData * >( array->private_data );
+        array->release = nullptr;
+    }
+
+    void ReleaseArray( ArrowArray *array ) {
+        ArrayData *data = static_cast< ArrayData * >( array->private_data );
+        for ( size_t i = 0; i < data->children.size(); i++ ) {
+            if ( data->children[ i ].release ) {
+                data->children[ i ].release( &data->children[ i ] );
+            }
+        }
+        delete data;
+        array->release = nullptr;
+    }
+
+    //------------------------------------------------------------
+    // Imported schema or array, moved out of the producer's
+    // structure: released by the producer's callback when the last
+    // holder is done with it
+    //------------------------------------------------------------
+    template < class S >
+    void ReleaseMoved( S *moved ) {
+        if ( moved->release ) {
+            moved->release( moved );
+        }
+        delete moved;
+    }
+
+    template < class S >
+    std::shared_ptr< S > Move( S *from ) {
+        S *moved = new ( std::nothrow ) S( *from );
+        if ( not moved ) {
+            from->release( from );
+            throw std::bad_alloc();
+        }
+        from->release = nullptr;
+        return std::shared_ptr< S >( moved, ReleaseMoved< S > );
+    }
+
+    //------------------------------------------------------------
+    // true if bit i of a validity bitmap is set, or there is none
+    //------------------------------------------------------------
+    bool Valid( const uint8_t *validity, int64_t i ) {
+        return not validity or ( validity[ i / 8 ] & ( 1 << ( i % 8 ) ) );
+    }
+
+    // Validity bitmap of array, nullptr if it has no nulls
+    const uint8_t *Validity( const ArrowArray *array ) {
+        if ( array->n_buffers < 1 or array->null_count == 0 ) {
+            return nullptr;
+        }
+        return static_cast< const uint8_t * >( array->buffers[ 0 ] );
+    }
+
+    //------------------------------------------------------------
+    // Value row of a float64 ("g") or float32 ("f") array, nan if
+    // the validity bitmap marks it null
+    //------------------------------------------------------------
+    double Value( const ArrowArray *array, bool float32, int64_t row ) {
+        int64_t i = array->offset + row;
+
+        if ( not Valid( Validity( array ), i ) ) {
+            return NAN;
+        }
+        if ( float32 ) {
+            return static_cast< const float * >( array->buffers[ 1 ] )[ i ];
+        }
+        return static_cast< const double * >( array->buffers[ 1 ] )[ i ];
+    }
+
+    //------------------------------------------------------------
+    void Release( ArrowSchema *schema, ArrowArray *array ) {
+        if ( array  and array->release  ) { array->release( array ); }
+        if ( schema and schema->release ) { schema->release( schema ); }
+    }
+}
+
+//----------------------------------------------------------------
+// ImportArrow() : DataFrame of a struct array ("+s") of float64 or
+// float32 columns, or of a single such array. Columns are named by
+// the child schema names. Null values, and rows the struct marks
+// null, are nan.
+//
+// Zero-copy: float64 columns without nulls whose values are one
+// column after the other, as a single column, or the struct of
+// ExportArrow(), are used in place. The DataFrame holds the array
+// until its values are copied or it is destroyed.
+//
+// Otherwise the columns are copied, column by column, into a
+// column-major DataFrame: float64 columns without nulls with one
+// memcpy each, other columns value by value. A DataFrame is one
+// block of values: separate column buffers, as of most tables of
+// several columns, cannot be used in place.
+//
+// schema and array are moved in: the caller's structures are
+// marked released on return or exception.
+//----------------------------------------------------------------
+DataFrame< double > ImportArrow( ArrowSchema *schema, ArrowArray *array ) {
+    using namespace EDM_Arrow;
+
+    if ( not schema or not array or not schema->release or
+         not array->release ) {
+        Release( schema, array );
+        throw std::runtime_error( "ImportArrow(): schema or array is "
+                                  "null or released.\n" );
+    }
+
+    // Moved in: released by the last holder, or as errors unwind
+    std::shared_ptr< ArrowArray > imported;
+    try {
+        imported = Move( array );
+    }
+    catch ( ... ) {
+        schema->release( schema );
+        throw;
+    }
+    std::shared_ptr< ArrowSchema > importedSchema = Move( schema );
+
+    // Columns: the children of a struct, or the array itself
+    std::vector< ArrowSchema * > columnSchema;
+    std::vector< ArrowArray  * > columnArray;
+
+    bool isStruct = std::string( importedSchema->format ) == "+s";
+
+    if ( isStruct ) {
+        if ( importedSchema->n_children != imported->n_children ) {
+            throw std::runtime_error( "ImportArrow(): schema and array "
+                                      "children differ.\n" );
+        }
+        for ( int64_t i = 0; i < importedSchema->n_children; i++ ) {
+            columnSchema.push_back( importedSchema->children[ i ] );
+            columnArray.push_back ( imported->children      [ i ] );
+        }
+    }
+    else {
+        columnSchema.push_back( importedSchema.get() );
+        columnArray.push_back ( imported.get() );
+    }
+
+    size_t N_columns = columnSchema.size();
+    size_t N_rows    = imported->length;
+
+    // Offset and validity of the struct array apply to its children
+    int64_t        structOffset   = isStruct ? imported->offset : 0;
+    const uint8_t *structValidity = isStruct ? Validity( imported.get() )
+                                             : nullptr;
+
+    std::vector< bool >        float32( N_columns );
+    std::vector< std::string > names  ( N_columns );
+
+    for ( size_t col = 0; col < N_columns; col++ ) {
+        std::string format( columnSchema[ col ]->format );
+        names[ col ] = columnSchema[ col ]->name ?
+                       columnSchema[ col ]->name : "";
+        if ( names[ col ].empty() ) {
+            names[ col ] = "V" + std::to_string( col );
+        }
+
+        if ( ( format != "g" and format != "f" ) or
+             columnArray[ col ]->n_buffers != 2 or
+             columnArray[ col ]->length < structOffset + (int64_t) N_rows ) {
+            std::stringstream errMsg;
+            errMsg << "ImportArrow(): column " << names[ col ]
+                   << " format " << format << " is not float64 (g) or"
+                   << " float32 (f) of " << structOffset + N_rows
+                   << " rows.\n";
+            throw std::runtime_error( errMsg.str() );
+        }
+        float32[ col ] = format == "f";
+    }
+
+    //------------------------------------------------------------
+    // Values in place: float64, no nulls, column after column
+    //------------------------------------------------------------
+    const double *values = nullptr;
+    bool          inPlace = N_columns and not structValidity;
+
+    for ( size_t col = 0; inPlace and col < N_columns; col++ ) {
+        const ArrowArray *column = columnArray[ col ];
+        if ( float32[ col ] or Validity( column ) ) {
+            inPlace = false;
+            break;
+        }
+
+        const double *first =
+            static_cast< const double * >( column->buffers[ 1 ] ) +
+            column->offset + structOffset;
+        if ( col == 0 ) {
+            values = first;
+        }
+        inPlace = first == values + col * N_rows;
+    }
+
+    if ( inPlace ) {
+        DataFrame< double > data( N_rows, N_columns, values, imported,
+                                  DataFrameLayout::ColumnMajor );
+        data.ColumnNames() = names;
+        data.BuildColumnNameIndex();
+        return data;
+    }
+
+    DataFrame< double > data( N_rows, N_columns,
+                              DataFrameLayout::ColumnMajor );
+    data.ColumnNames() = names;
+    data.BuildColumnNameIndex();
+
+    for ( size_t col = 0; col < N_columns and N_rows; col++ ) {
+        const ArrowArray *column = columnArray[ col ];
+        double           *out    = data.Write( 0, col );
+
+        if ( not structValidity and not float32[ col ] and
+             not Validity( column ) ) {
+            const double *in =
+                static_cast< const double * >( column->buffers[ 1 ] );
+            memcpy( out, in + column->offset + structOffset,
+                    N_rows * sizeof( double ) );
+            continue;
+        }
+        for ( size_t row = 0; row < N_rows; row++ ) {
+            out[ row ] = Valid( structValidity, structOffset + row ) ?
+                Value( column, float32[ col ], structOffset + row ) : NAN;
+        }
+    }
+
+    return data;
+}
+
+//----------------------------------------------------------------
+// ExportArrow() : Struct array of the float64 columns of data,
+// named by the column names. The caller (consumer) owns schema and
+// array and must call their release callbacks.
+//
+// Zero-copy of a column-major DataFrame: the children buffers are
+// its columns, each child holds a copy-on-write share of the
+// values until it is released. A row-major DataFrame is copied
+// once to column-major values the children share.
+//----------------------------------------------------------------
+void ExportArrow( const DataFrame< double > &data,
+                  ArrowSchema               *schema,
+                  ArrowArray                *array ) {
+    using namespace EDM_Arrow;
+
+    size_t N_rows    = data.NRows();
+    size_t N_columns = data.NColumns();
+
+    std::vector< std::string > columnNames = data.ColumnNames();
+
+    // Columns of data as one column-major block, Stride() apart
+    const DataFrame< double > columns =
+        data.Layout() == DataFrameLayout::ColumnMajor ? data :
+        data.ToLayout( DataFrameLayout::ColumnMajor );
+
+    // Held here until all are allocated, then passed to the consumer
+    std::unique_ptr< SchemaData > schemaData( new SchemaData() );
+    std::unique_ptr< ArrayData >  arrayData ( new ArrayData()  );
+
+    std::vector< std::unique_ptr< ChildSchemaData > > childSchema;
+    std::vector< std::unique_ptr< ChildArrayData > >  childArray;
+
+    schemaData->children.resize( N_columns );
+    schemaData->childPointers.resize( N_columns );
+    arrayData->children.resize( N_columns );
+    arrayData->childPointers.resize( N_columns );
+
+    for ( size_t col = 0; col < N_columns; col++ ) {
+        childSchema.emplace_back( new ChildSchemaData() );
+        childSchema.back()->name = col < columnNames.size() ?
+            columnNames[ col ] : "V" + std::to_string( col );
+
+        childArray.emplace_back( new ChildArrayData() );
+        childArray.back()->values = columns;
+    }
+
+    //------------------------------------------------------------
+    // Schema
+    //------------------------------------------------------------
+    for ( size_t col = 0; col < N_columns; col++ ) {
+        ArrowSchema &child = schemaData->children[ col ];
+        child.format       = "g";
+        child.name         = childSchema[ col ]->name.c_str();
+        child.metadata     = nullptr;
+        child.flags        = ARROW_FLAG_NULLABLE;
+        child.n_children   = 0;
+        child.children     = nullptr;
+        child.dictionary   = nullptr;
+        child.release      = ReleaseChildSchema;
+        child.private_data = childSchema[ col ].release();
+
+        schemaData->childPointers[ col ] = &child;
+    }
+
+    schema->format       = "+s";
+    schema->name         = "";
+    schema->metadata     = nullptr;
+    schema->flags        = 0;
+    schema->n_children   = N_columns;
+    schema->children     = N_columns ? schemaData->childPointers.data()
+                                     : nullptr;
+    schema->dictionary   = nullptr;
+    schema->release      = ReleaseSchema;
+    schema->private_data = schemaData.release();
+
+    //------------------------------------------------------------
+    // Array
+    //------------------------------------------------------------
+    arrayData->structBuffers[ 0 ] = nullptr;
+
+    for ( size_t col = 0; col < N_columns; col++ ) {
+        ChildArrayData *childData = childArray[ col ].release();
+        childData->buffers[ 0 ] = nullptr; // no nulls
+        childData->buffers[ 1 ] = columns.Data() + col * columns.Stride();
+
+        ArrowArray &child  = arrayData->children[ col ];
+        child.length       = N_rows;
+        child.null_count   = 0;
+        child.offset       = 0;
+        child.n_buffers    = 2;
+        child.n_children   = 0;
+        child.buffers      = childData->buffers;
+        child.children     = nullptr;
+        child.dictionary   = nullptr;
+        child.release      = ReleaseChildArray;
+        child.private_data = childData;
+
+        arrayData->childPointers[ col ] = &child;
+    }
+
+    array->length       = N_rows;
+    array->null_count   = 0;
+    array->offset       = 0;
+    array->n_buffers    = 1;
+    array->n_children   = N_columns;
+    array->buffers      = arrayData->structBuffers;
+    array->children     = N_columns ? arrayData->childPointers.data()
+                                    : nullptr;
+    array->dictionary   = nullptr;
+    array->release      = ReleaseArray;
+    array->private_data = arrayData.release();
+}
@@ -1,103 +1,349 @@
 
 #include "AuxFunc.h"
 
+namespace EDM_AuxFunc {
+    //------------------------------------------------------------
+    // Multivariate or embedded block of the param columns
+    //------------------------------------------------------------
+    template < class T >
+    DataFrame<T> EmbedBlock( const DataFrameView<T> &dataIn,
+                             const Parameters       &param ) {
+        if ( param.embedded ) {
+            // Data is multivariable block, no embedding needed
+            // Select the specified columns. The block is copied once,
+            // to the aligned rows neighbor searches read in place.
+            if ( param.columnNames.size() ) {
+                return DataFrame<T>( dataIn.Columns( param.columnNames ),
+                                     true );
+            }
+            else if ( param.columnIndex.size() ) {
+                return DataFrame<T>( dataIn.Columns( param.columnIndex ),
+                                     true );
+            }
+            throw std::runtime_error( "EmbedNN(): colNames and "
+                                      " colIndex are empty.\n" );
+        }
+        // embedded = false: Create the embedding block
+        // dataBlock will have tau * (E-1) fewer rows than dataIn
+        return Embed( dataIn, param.E, param.tau,
+                      param.columns_str, param.verbose, param.exec );
+    }
+
+    //------------------------------------------------------------
+    // Target (library) vector, as double
+    //------------------------------------------------------------
+    template < class T >
+    std::valarray<double> TargetVector( const DataFrameView<T> &dataIn,
+                                        const Parameters       &param ) {
+        std::valarray<T> target;
+        if ( param.targetIndex ) {
+            target = dataIn.Column( param.targetIndex );
+        }
+        else if ( param.targetName.size() ) {
+            target = dataIn.VectorColumnName( param.targetName );
+        }
+        else {
+            // Default to first column, column i=0 is time
+            target = dataIn.Column( 1 );
+        }
+        std::valarray<double> target_vec( target.size() );
+        for ( size_t i = 0; i < target.size(); i++ ) {
+            target_vec[ i ] = target[ i ];
+        }
+        return target_vec;
+    }
+
+    // Rows removed from dataIn, target by the embedding
+    size_t EmbedShift( const Parameters &param ) {
+        // If we support negtive tau, this will change
+        // For now, assume only positive tau is allowed
+        return param.embedded ? 0 : std::max( 0, param.tau * (param.E - 1) );
+    }
+
+    //------------------------------------------------------------
+    // Embedding cache key of the neighbors of dataNN: a hash of
+    // the embedding values and the FindNeighbors() parameters
+    //------------------------------------------------------------
+    std::string NeighborsKey( const DataEmbedNN &dataNN,
+                              const Parameters  &param ) {
+        std::stringstream key;
+        key << "Neighbors ";
+        if ( dataNN.embedding.NColumns() ) {
+            const DataFrameView<double> &view = dataNN.embedding.View();
+            key << "EmbeddingView " << view.NRows() << "x" << view.NColumns()
+                << " tau " << param.tau << " " << HashValues( view );
+        }
+        else if ( dataNN.dataFrameFloat.NRows() ) {
+            const DataFrame<float> &block = dataNN.dataFrameFloat;
+            key << "float32 " << block.NRows() << "x" << block.NColumns()
+                << " " << HashValues( block.View() );
+        }
+        else {
+            const DataFrame<double> &block = dataNN.dataFrame;
+            key << "DataFrame " << block.NRows() << "x" << block.NColumns()
+                << " " << HashValues( block.View() );
+        }
+        key << " E "    << param.E   << " embedded " << param.embedded
+            << " knn "  << param.knn << " Tp "       << param.Tp
+            << " noNeighborLimit " << param.noNeighborLimit
+            << " lib "  << param.library.size()    << " "
+            << HashValues( param.library )
+            << " pred " << param.prediction.size() << " "
+            << HashValues( param.prediction );
+        return key.str();
+    }
+
+    //------------------------------------------------------------
+    // Neighbors of dataNN: found in the shared embedding cache if
+    // it is enabled, then in the neighbor index directory if it is
+    // configured, else of search(). Then cached and saved.
+    //------------------------------------------------------------
+    template < class Search >
+    Neighbors CachedNeighbors( const DataEmbedNN &dataNN,
+                               const Parameters  &param,
+                               Search             search ) {
+        EmbeddingCache &cache     = SharedEmbeddingCache();
+        std::string     directory = NeighborIndexDirectory();
+        if ( not cache.Enabled() and directory.empty() ) {
+            return search();
+        }
+
+        std::string         key = NeighborsKey( dataNN, param );
+        EmbeddingCacheEntry entry;
+        Neighbors           neighbors;
+
+        if ( cache.Enabled() and cache.Find( key, entry ) ) {
+            neighbors.neighbors = entry.neighbors;
+            neighbors.distances = entry.distances;
+            return neighbors;
+        }
+
+        std::string fileName = NeighborIndexFileName( key );
+
+        if ( directory.empty() or
+             not ReadNeighborIndex( directory, fileName, key, neighbors ) ) {
+            neighbors = search();
+            if ( directory.size() ) {
+                WriteNeighborIndex( directory, fileName, key, neighbors );
+            }
+        }
+
+        if ( cache.Enabled() ) {
+            entry.neighbors = neighbors.neighbors;
+            entry.distances = neighbors.distances;
+            cache.Insert( key, entry );
+        }
+        return neighbors;
+    }
+}
+
 //----------------------------------------------------------
 // Common code for Simplex and Smap that embeds, extracts
 // the target vector and computes neighbors.
 // Note that the time column is not returned in the embedding
 // dataBlock.
 //----------------------------------------------------------
-DataEmbedNN EmbedNN( DataFrame<double> dataIn,
-                     Parameters        param,
-                     bool              checkDataRows )
+DataEmbedNN EmbedNN( const DataFrameView<double> &dataIn,
+                     Parameters                  param,
+                     bool                        checkDataRows )
+{
+    DataEmbedNN dataEmbedNN = EmbedData( dataIn, param, checkDataRows );
+
+    //----------------------------------------------------------
+    // Nearest neighbors, of the embedding cache if enabled
+    //----------------------------------------------------------
+    dataEmbedNN.neighbors = EDM_AuxFunc::CachedNeighbors(
+        dataEmbedNN, param, [&]() {
+            if ( dataEmbedNN.embedding.NColumns() ) {
+                return FindNeighbors( dataEmbedNN.embedding, param );
+            }
+            return FindNeighbors( dataEmbedNN.dataFrame, param );
+        } );
+
+    return dataEmbedNN;
+}
+
+//----------------------------------------------------------
+// Embedding and target vector of EmbedNN() without neighbors.
+// Used directly when neighbors are derived elsewhere, for
+// example shared by several grid points in ParameterSweep().
+//----------------------------------------------------------
+DataEmbedNN EmbedData( const DataFrameView<double> &dataIn,
+                       Parameters                  param,
+                       bool                        checkDataRows )
 {
     if ( checkDataRows ) {
         CheckDataRows( param, dataIn, "EmbedNN" );
     }
     
     //----------------------------------------------------------
-    // Extract or embedd data block
+    // Extract data block, or embed: the embedding view reads the
+    // dataIn columns in place, it is not copied to a data block
     //----------------------------------------------------------
-    DataFrame<double> dataBlock; // Multivariate or embedded DataFrame
+    DataFrame<double>     dataBlock;
+    EmbeddingView<double> embedding;
 
     if ( param.embedded ) {
-        // Data is multivariable block, no embedding needed
-        // Select the specified columns 
-        if ( param.columnNames.size() ) {
-            dataBlock = dataIn.DataFrameFromColumnNames(param.columnNames);
-        }
-        else if ( param.columnIndex.size() ) {
-            dataBlock = dataIn.DataFrameFromColumnIndex(param.columnIndex);
-        }
-        else {
-            throw std::runtime_error( "EmbedNN(): colNames and "
-                                      " colIndex are empty.\n" );
-        }
+        dataBlock = EDM_AuxFunc::EmbedBlock( dataIn, param );
     }
     else {
-        // embedded = false: Create the embedding block
-        // dataBlock will have tau * (E-1) fewer rows than dataIn
-        dataBlock = Embed( dataIn, param.E, param.tau,
-                           param.columns_str, param.verbose );
+        embedding = EmbedView( dataIn, param.E, param.tau,
+                               param.columns_str, param.verbose );
     }
     
     //----------------------------------------------------------
     // Get target (library) vector
     //----------------------------------------------------------
-    std::valarray<double> target_vec;
-    if ( param.targetIndex ) {
-        target_vec = dataIn.Column( param.targetIndex );
-    }
-    else if ( param.targetName.size() ) {
-        target_vec = dataIn.VectorColumnName( param.targetName );
-    }
-    else {
-        // Default to first column, column i=0 is time
-        target_vec = dataIn.Column( 1 );
-    }
+    std::valarray<double> target_vec = EDM_AuxFunc::TargetVector( dataIn,
+                                                                   param );
     
     //----------------------------------------------------------
-    // If data was embedded, remove dataIn, target rows as needed
+    // If data was embedded, remove dataIn, target rows as needed.
+    // dataIn rows are a view, not copied.
     //----------------------------------------------------------
-    if ( not param.embedded ) {
-        // If we support negtive tau, this will change
-        // For now, assume only positive tau is allowed
-        size_t shift = std::max(0, param.tau * (param.E - 1) );
-        
-        std::valarray<double> target_vec_embed( dataIn.NRows() - shift );
-        target_vec_embed = target_vec[ std::slice( shift,
-                                                   target_vec.size() - shift,
-                                                   1 ) ];
-        target_vec = target_vec_embed;
-
-        DataFrame<double> dataInEmbed( dataIn.NRows() - shift,
-                                       dataIn.NColumns(),
-                                       dataIn.ColumnNames() );
-        
-        for ( size_t row = 0; row < dataInEmbed.NRows(); row++ ) {
-            dataInEmbed.WriteRow( row, dataIn.Row( row + shift ) );
-        }
-        dataIn = dataInEmbed;
-    }
+    size_t shift = EDM_AuxFunc::EmbedShift( param );
+
+    std::valarray<double> target_vec_embed =
+        target_vec[ std::slice( shift, target_vec.size() - shift, 1 ) ];
+
+    DataFrameView<double> dataInEmbed =
+        dataIn.Rows( shift, dataIn.NRows() - shift );
     
-    //----------------------------------------------------------
-    // Nearest neighbors
-    //----------------------------------------------------------
-    Neighbors neighbors = FindNeighbors( dataBlock, param );
+    // Create struct to return the objects, neighbors are empty
+    DataEmbedNN dataEmbedNN = DataEmbedNN( dataInEmbed, dataBlock, 
+                                           target_vec_embed, Neighbors() );
+    dataEmbedNN.embedding = embedding;
+    return dataEmbedNN;
+}
+
+//----------------------------------------------------------
+// EmbedData() of the sink overloads of Simplex() and SMap():
+// the embedding is made once, as aligned rows that the blocks
+// of SinkNeighbors() search in place
+//----------------------------------------------------------
+DataEmbedNN EmbedSink( const DataFrameView<double> &dataIn,
+                       Parameters                   param )
+{
+    DataEmbedNN dataEmbedNN = EmbedData( dataIn, param );
+
+    dataEmbedNN.dataFrame = EmbeddingBlock( dataEmbedNN );
+    dataEmbedNN.embedding = EmbeddingView<double>();
+
+    if ( param.embedded and
+         param.E != dataEmbedNN.dataFrame.NColumns() ) {
+        std::stringstream errMsg;
+        errMsg << "EmbedNN(): The number of dataFrame columns ("
+               << dataEmbedNN.dataFrame.NColumns() << ") does not match "
+               << "the embedding dimension E (" << param.E << ")\n";
+        throw std::runtime_error( errMsg.str() );
+    }
+    return dataEmbedNN;
+}
+
+//----------------------------------------------------------
+// Neighbors of a block of prediction rows: the buffers of
+// neighbors are reused while the block size is unchanged
+//----------------------------------------------------------
+void SinkNeighbors( const DataEmbedNN &dataNN,
+                    const Parameters  &param,
+                    size_t             rowStart,
+                    size_t             rowStop,
+                    Neighbors         &neighbors )
+{
+    size_t N_rows = rowStop - rowStart;
+
+    if ( neighbors.neighbors.NRows() != N_rows ) {
+        neighbors.neighbors = DataFrame<size_t>( N_rows, param.knn );
+        neighbors.distances = DataFrame<double>( N_rows, param.knn );
+    }
+
+    // Rows per pool block: about 64k distance evaluations
+    size_t grain = std::max( (size_t) 1,
+                             65536 / ( param.library.size() + 1 ) );
+
+    param.exec.Pool().ParallelForRange(
+        N_rows, grain,
+        [&]( size_t start, size_t stop ) {
+            FindNeighborRows( dataNN.dataFrame, param, neighbors,
+                              rowStart + start, rowStart + stop, rowStart );
+        },
+        param.exec.nThreads );
+}
+
+//----------------------------------------------------------
+// EmbedNN() of float32 data: the embedding and neighbor
+// search are float32, projections are computed in double
+//----------------------------------------------------------
+DataEmbedNN EmbedNN( const DataFrameView<float> &dataIn,
+                     Parameters                 param,
+                     bool                       checkDataRows )
+{
+    DataEmbedNN dataEmbedNN = EmbedData( dataIn, param, checkDataRows );
+
+    dataEmbedNN.neighbors = EDM_AuxFunc::CachedNeighbors(
+        dataEmbedNN, param, [&]() {
+            return FindNeighbors( dataEmbedNN.dataFrameFloat, param );
+        } );
+    return dataEmbedNN;
+}
+
+//----------------------------------------------------------
+// EmbedData() of float32 data. The time column is converted
+// to double for the output, held by dataInTime.
+//----------------------------------------------------------
+DataEmbedNN EmbedData( const DataFrameView<float> &dataIn,
+                       Parameters                 param,
+                       bool                       checkDataRows )
+{
+    std::shared_ptr< DataFrame<double> > dataInTime =
+        std::make_shared< DataFrame<double> >(
+            dataIn.Columns( std::vector< size_t >( 1, 0 ) ) );
+
+    if ( checkDataRows ) {
+        CheckDataRows( param, *dataInTime, "EmbedNN" );
+    }
+
+    DataFrame<float> dataBlock = EDM_AuxFunc::EmbedBlock( dataIn, param );
+
+    std::valarray<double> target_vec = EDM_AuxFunc::TargetVector( dataIn,
+                                                                   param );
 
-    // Create struct to return the objects
-    DataEmbedNN dataEmbedNN = DataEmbedNN( dataIn, dataBlock, 
-                                           target_vec, neighbors );
+    size_t shift = EDM_AuxFunc::EmbedShift( param );
+
+    std::valarray<double> target_vec_embed =
+        target_vec[ std::slice( shift, target_vec.size() - shift, 1 ) ];
+
+    DataEmbedNN dataEmbedNN = DataEmbedNN(
+        dataInTime->View().Rows( shift, dataIn.NRows() - shift ),
+        DataFrame<double>(), target_vec_embed, Neighbors() );
+
+    dataEmbedNN.dataFrameFloat = dataBlock;
+    dataEmbedNN.dataInTime     = dataInTime;
     return dataEmbedNN;
 }
 
+//----------------------------------------------------------
+// Embedding as a double DataFrame: copied from the embedding
+// view, or converted from float32 data
+//----------------------------------------------------------
+DataFrame<double> EmbeddingBlock( const DataEmbedNN &dataNN )
+{
+    if ( dataNN.embedding.NColumns() ) {
+        return MakeBlock( dataNN.embedding );
+    }
+    if ( dataNN.dataFrameFloat.NRows() and not dataNN.dataFrame.NRows() ) {
+        return DataFrame<double>( dataNN.dataFrameFloat.View(), true );
+    }
+    return dataNN.dataFrame;
+}
+
 //----------------------------------------------------------
 // Common code to Simplex and Smap for output generation
 //----------------------------------------------------------
 DataFrame<double> FormatOutput( Parameters            param,
                                 size_t                N_row,
                                 std::valarray<double> predictions,
-                                DataFrame<double>     dataFrameIn,
+                                const DataFrameView<double> &dataFrameIn,
                                 std::valarray<double> target_vec,
                                 bool                  checkDataRows )
 {
@@ -152,12 +398,55 @@ DataFrame<double> FormatOutput( Parameters            param,
     return dataFrame;
 }
 
+//----------------------------------------------------------
+// Rows [outStart, outStop) of the FormatOutput() table to sink.
+// predictions[ i ] is the prediction of row predStart + i, and
+// must hold the predictions of output rows [outStart, outStop).
+//----------------------------------------------------------
+void SinkOutput( const Parameters            &param,
+                 size_t                       N_row,
+                 size_t                       outStart,
+                 size_t                       outStop,
+                 const std::valarray<double> &predictions,
+                 size_t                       predStart,
+                 const DataFrameView<double> &dataFrameIn,
+                 const std::valarray<double> &target_vec,
+                 ResultSink                  &sink )
+{
+    size_t Tp     = param.Tp;
+    size_t pred_0 = param.prediction[0];
+
+    std::vector< double > rows( ( outStop - outStart ) * 3 );
+
+    for ( size_t row = outStart; row < outStop; row++ ) {
+        double *out = &rows[ ( row - outStart ) * 3 ];
+
+        if ( row < N_row ) {
+            out[ 0 ] = dataFrameIn( pred_0 + row, 0 );
+            out[ 1 ] = target_vec[ pred_0 + row ];
+        }
+        else {
+            // Tp times at end as FormatOutput(): sums from the last time
+            double time = dataFrameIn( pred_0 + N_row - 1, 0 );
+            for ( size_t i = N_row; i <= row; i++ ) {
+                time = time + param.Tp;
+            }
+            out[ 0 ] = time;
+            out[ 1 ] = NAN;
+        }
+
+        out[ 2 ] = row < Tp ? NAN : predictions[ row - Tp - predStart ];
+    }
+
+    sink.Rows( rows.data(), outStop - outStart );
+}
+
 //----------------------------------------------------------
 // 
 //----------------------------------------------------------
-void CheckDataRows( Parameters        param,
-                    DataFrame<double> dataFrameIn,
-                    std::string       call )
+void CheckDataRows( Parameters                   param,
+                    const DataFrameView<double> &dataFrameIn,
+                    std::string                  call )
 {
     //-----------------------------------------------------------------
     // Validate the dataFrameIn rows against the lib and pred indices
@@ -166,19 +455,19 @@ void CheckDataRows( Parameters        param,
     size_t prediction_max_i = param.prediction[param.prediction.size()-1] + 1;
     size_t library_max_i    = param.library   [param.library.size()   -1] + 1;
 
-    if ( dataFrameIn.Column( 0 ).size() < prediction_max_i ) {
+    if ( dataFrameIn.NRows() < prediction_max_i ) {
         std::stringstream errMsg;
         errMsg << call << "(): The prediction index "
                << prediction_max_i
                << " exceeds the number of data rows "
-               << dataFrameIn.Column( 0 ).size();
+               << dataFrameIn.NRows();
         throw std::runtime_error( errMsg.str() );
     }
-    if ( dataFrameIn.Column( 0 ).size() < library_max_i ) {
+    if ( dataFrameIn.NRows() < library_max_i ) {
         std::stringstream errMsg;
         errMsg << call << "(): The library index " << library_max_i
                << " exceeds the number of data rows "
-               << dataFrameIn.Column( 0 ).size();
+               << dataFrameIn.NRows();
         throw std::runtime_error( errMsg.str() );
     }
 }
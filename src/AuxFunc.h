@@ -8,18 +8,30 @@
 
 //----------------------------------------------------------------
 // Data Input, embedding and NN structure to accomodate
-// common initial processing in Simplex and Smap
+// common initial processing in Simplex and Smap.
+// dataIn is a view of the caller's data rows aligned with the
+// embedding: the caller's DataFrame must outlive the DataEmbedNN.
+//
+// Of data that is not embedded: embedding reads the caller's data
+// in place and dataFrame is empty, see EmbeddingBlock().
+// Of float32 data: dataFrameFloat is the embedding, dataFrame is
+// empty, and dataIn views the time column converted to double.
 //----------------------------------------------------------------
 struct DataEmbedNN {
-    DataFrame<double>     dataIn;
+    DataFrameView<double> dataIn;
     DataFrame<double>     dataFrame;
     std::valarray<double> targetVec;
     Neighbors             neighbors;
+
+    EmbeddingView<double> embedding;
+
+    DataFrame<float>                     dataFrameFloat;
+    std::shared_ptr< DataFrame<double> > dataInTime;
     
     // Constructors
     DataEmbedNN() {}
     
-    DataEmbedNN( DataFrame<double>     dataIn,
+    DataEmbedNN( DataFrameView<double> dataIn,
                  DataFrame<double>     dataFrame,
                  std::valarray<double> targetVec,
                  Neighbors             neighbors ) :
@@ -28,18 +40,63 @@ struct DataEmbedNN {
 };
 
 // Prototypes
-DataEmbedNN EmbedNN( DataFrame<double> dataIn,
-                     Parameters        param,
-                     bool              checkDataRows = true );
+DataEmbedNN EmbedNN( const DataFrameView<double> &dataIn,
+                     Parameters                  param,
+                     bool                        checkDataRows = true );
+
+DataEmbedNN EmbedData( const DataFrameView<double> &dataIn,
+                       Parameters                  param,
+                       bool                        checkDataRows = true );
+
+// float32 data: embedding and neighbors in float32
+DataEmbedNN EmbedNN( const DataFrameView<float> &dataIn,
+                     Parameters                 param,
+                     bool                       checkDataRows = true );
+
+DataEmbedNN EmbedData( const DataFrameView<float> &dataIn,
+                       Parameters                 param,
+                       bool                       checkDataRows = true );
+
+// Embedding of dataNN as double: dataFrame, MakeBlock() of the
+// embedding view, or of dataFrameFloat. Rows are aligned.
+DataFrame<double> EmbeddingBlock( const DataEmbedNN &dataNN );
     
 DataFrame<double> FormatOutput( Parameters            param,
                                 size_t                N_row,
                                 std::valarray<double> predictions,
-                                DataFrame<double>     dataFrameIn,
+                                const DataFrameView<double> &dataFrameIn,
                                 std::valarray<double> target_vec,
                                 bool                  checkDataRows = true );
 
-void CheckDataRows( Parameters        param,
-                    DataFrame<double> dataFrameIn,
-                    std::string       call );
+// Prediction rows projected between pushes to a ResultSink
+const size_t sinkBlockRows = 4096;
+
+// EmbedData() for a ResultSink: dataFrame is the aligned embedding,
+// neighbors are left empty for SinkNeighbors()
+DataEmbedNN EmbedSink( const DataFrameView<double> &dataIn,
+                       Parameters                   param );
+
+// Neighbors of prediction rows [rowStart, rowStop) of the dataFrame
+// of dataNN, into rows [0, rowStop - rowStart) of neighbors: one
+// block of neighbors is held, not those of all prediction rows
+void SinkNeighbors( const DataEmbedNN &dataNN,
+                    const Parameters  &param,
+                    size_t             rowStart,
+                    size_t             rowStop,
+                    Neighbors         &neighbors );
+
+// Rows [outStart, outStop) of the FormatOutput() table to sink
+void SinkOutput( const Parameters            &param,
+                 size_t                       N_row,
+                 size_t                       outStart,
+                 size_t                       outStop,
+                 const std::valarray<double> &predictions,
+                 size_t                       predStart,
+                 const DataFrameView<double> &dataFrameIn,
+                 const std::valarray<double> &target_vec,
+                 ResultSink                  &sink );
+
+void CheckDataRows( Parameters                   param,
+                    const DataFrameView<double> &dataFrameIn,
+                    std::string                  call );
 #endif
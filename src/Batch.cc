@@ -0,0 +1,310 @@
+
+#include "Common.h"
+
+namespace EDM_Batch {
+    //------------------------------------------------------------
+    // Buffers of one pool task, reused for each series it projects
+    //------------------------------------------------------------
+    struct Buffers {
+        std::vector< size_t > neighbors; // knn library rows
+        std::vector< double > distances; // knn distances
+        std::vector< double > weights;   // knn weights
+        std::vector< std::pair< double, size_t > > nearest; // sort of knn
+    };
+
+    //------------------------------------------------------------
+    // Simplex projection of the last predRows embedded rows of x
+    // from the preceding rows, written to rows [outRow, outRow +
+    // predRows + Tp) of out as: Series Time Observations Predictions
+    //
+    // Same arithmetic as Simplex() with lib = "1 N_lib" and
+    // pred = "N_lib+1 N_lib+predRows" on the embedded series, but
+    // the delay vectors are read from x instead of an embedding.
+    //------------------------------------------------------------
+    void SimplexSeries( const std::valarray< double > &x,
+                        const std::valarray< double > *time,
+                        size_t                         series_i,
+                        int                            predRows,
+                        int                            E,
+                        int                            Tp,
+                        int                            knn,
+                        int                            tau,
+                        Buffers                       &buffers,
+                        DataFrame< double >           &out,
+                        size_t                         outRow )
+    {
+        size_t shift  = tau * ( E - 1 );
+        size_t N_lib  = x.size() - shift - predRows;
+        double minWeight = 1.E-6;
+
+        buffers.neighbors.resize( knn );
+        buffers.distances.resize( knn );
+        buffers.weights.resize( knn );
+        buffers.nearest.resize( knn );
+
+        size_t *k_NN_neighbors = buffers.neighbors.data();
+        double *k_NN_distances = buffers.distances.data();
+        double *weights        = buffers.weights.data();
+
+        for ( int row = 0; row < predRows + Tp; row++ ) {
+            size_t out_i = outRow + row;
+            out( out_i, 0 ) = series_i;
+
+            // Time, observations: Tp rows past the data as FormatOutput()
+            if ( row < predRows ) {
+                size_t t = N_lib + row + shift;
+                out( out_i, 1 ) = time ? (*time)[ t ] : t + 1;
+                out( out_i, 2 ) = x[ t ];
+            }
+            else {
+                out( out_i, 1 ) = out( out_i - 1, 1 ) + Tp;
+                out( out_i, 2 ) = NAN;
+            }
+            if ( row < Tp ) {
+                out( out_i, 3 ) = NAN;
+            }
+        }
+
+        for ( int row = 0; row < predRows; row++ ) {
+            size_t pred_row = N_lib + row;
+
+            //----------------------------------------------------
+            // Neighbors: as FindNeighbors()
+            //----------------------------------------------------
+            for ( int k = 0; k < knn; k++ ) {
+                k_NN_neighbors[ k ] = 0;
+                k_NN_distances[ k ] = DISTANCE_MAX;
+            }
+
+            for ( size_t lib_row = 0; lib_row < N_lib; lib_row++ ) {
+                if ( lib_row + Tp >= N_lib ) {
+                    continue;
+                }
+
+                // Delay vectors: embedded row r, column e is
+                // x[ r + shift - e * tau ]
+                double sum = 0;
+                for ( int e = 0; e < E; e++ ) {
+                    double delta = x[ pred_row + shift - e * tau ] -
+                                   x[ lib_row  + shift - e * tau ];
+                    sum += delta * delta;
+                }
+                double d_i = sqrt( sum );
+
+                double *max_it = std::max_element( k_NN_distances,
+                                                   k_NN_distances + knn );
+                if ( d_i < *max_it ) {
+                    size_t max_i = max_it - k_NN_distances;
+                    k_NN_neighbors[ max_i ] = lib_row;
+                    k_NN_distances[ max_i ] = d_i;
+                }
+            }
+
+            if ( *std::max_element( k_NN_distances,
+                                    k_NN_distances + knn ) > DISTANCE_LIMIT ) {
+                std::stringstream errMsg;
+                errMsg << "SimplexBatch(): series " << series_i
+                       << " library is too small to resolve " << knn
+                       << " knn neighbors." << std::endl;
+                throw std::runtime_error( errMsg.str() );
+            }
+
+            // Nearest first, ties by library row
+            for ( int k = 0; k < knn; k++ ) {
+                buffers.nearest[ k ] = std::make_pair( k_NN_distances[ k ],
+                                                       k_NN_neighbors[ k ] );
+            }
+            std::sort( buffers.nearest.begin(), buffers.nearest.end() );
+            for ( int k = 0; k < knn; k++ ) {
+                k_NN_distances[ k ] = buffers.nearest[ k ].first;
+                k_NN_neighbors[ k ] = buffers.nearest[ k ].second;
+            }
+
+            //----------------------------------------------------
+            // Projection: as SimplexProjection()
+            //----------------------------------------------------
+            double minDistance = *std::min_element( k_NN_distances,
+                                                    k_NN_distances + knn );
+
+            for ( int k = 0; k < knn; k++ ) {
+                double w;
+                if ( minDistance == 0 ) {
+                    w = k_NN_distances[ k ] > 0 ?
+                        exp( -k_NN_distances[ k ] / minDistance ) : 1;
+                }
+                else {
+                    w = exp( -k_NN_distances[ k ] / minDistance );
+                }
+                weights[ k ] = std::max( w, minWeight );
+            }
+
+            // Summation order of the valarray sum() in SimplexProjection()
+            double weightSum = weights[ 0 ];
+            for ( int k = 1; k < knn; k++ ) {
+                weightSum += weights[ k ];
+            }
+            double predSum = weights[ knn - 1 ] *
+                             x[ k_NN_neighbors[ knn - 1 ] + Tp + shift ];
+            for ( int k = knn - 1; k-- > 0; ) {
+                predSum += weights[ k ] *
+                           x[ k_NN_neighbors[ k ] + Tp + shift ];
+            }
+
+            out( outRow + row + Tp, 3 ) = predSum / weightSum;
+        }
+    }
+
+    //------------------------------------------------------------
+    // Validate and project all series into one DataFrame
+    //------------------------------------------------------------
+    DataFrame< double > Batch(
+        const std::vector< std::valarray< double > > &series,
+        const std::valarray< double >                *time,
+        int predRows, int E, int Tp, int knn, int tau,
+        ExecutionContext exec )
+    {
+        if ( E < 1 or tau < 1 or Tp < 0 or predRows < 1 ) {
+            std::stringstream errMsg;
+            errMsg << "SimplexBatch(): E, tau and predRows must be positive"
+                   << ", Tp must be non-negative." << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+        if ( knn < 1 ) {
+            knn = E + 1;
+        }
+        if ( knn < E + 1 ) {
+            std::stringstream errMsg;
+            errMsg << "SimplexBatch(): knn of " << knn
+                   << " is less than E+1 = " << E + 1 << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+
+        // Output rows of each series
+        size_t shift = tau * ( E - 1 );
+        std::vector< size_t > outRow( series.size() + 1, 0 );
+
+        for ( size_t i = 0; i < series.size(); i++ ) {
+            if ( series[ i ].size() < shift + predRows + 1 ) {
+                std::stringstream errMsg;
+                errMsg << "SimplexBatch(): series " << i << " of "
+                       << series[ i ].size() << " rows is too short for E "
+                       << E << " tau " << tau << " and predRows "
+                       << predRows << std::endl;
+                throw std::runtime_error( errMsg.str() );
+            }
+            outRow[ i + 1 ] = outRow[ i ] + predRows + Tp;
+        }
+
+        DataFrame< double > out( outRow.back(), 4,
+                                 "Series Time Observations Predictions" );
+
+        exec.Pool().ParallelForRange(
+            series.size(), 16,
+            [&]( size_t start, size_t stop ) {
+                Buffers buffers;
+                for ( size_t i = start; i < stop; i++ ) {
+                    SimplexSeries( series[ i ], time, i, predRows,
+                                   E, Tp, knn, tau, buffers,
+                                   out, outRow[ i ] );
+                }
+            },
+            exec.nThreads );
+
+        return out;
+    }
+}
+
+//----------------------------------------------------------------
+// SimplexBatch() : Simplex forecasts of many series.
+// The last predRows (embedded) rows of each series are predicted
+// from the preceding rows.
+// API Overload 1: Explicit data file path/name
+//     Implemented as a wrapper to API Overload 2:
+//----------------------------------------------------------------
+DataFrame<double> SimplexBatch( std::string pathIn,
+                                std::string dataFile,
+                                std::string pathOut,
+                                std::string predictFile,
+                                std::string columns,
+                                int         predRows,
+                                int         E,
+                                int         Tp,
+                                int         knn,
+                                int         tau,
+                                ExecutionContext exec ) {
+
+    // DataFrame constructor loads time and columns, or all columns
+    DataFrame< double > dataFrameIn( pathIn, dataFile, columns );
+
+    DataFrame< double > batch = SimplexBatch( dataFrameIn, pathOut,
+                                              predictFile, columns,
+                                              predRows, E, Tp, knn, tau,
+                                              exec );
+    return batch;
+}
+
+//----------------------------------------------------------------
+// API Overload 2: Wide DataFrame, one series per column.
+// Column 0 is time. columns = "" : all other columns.
+//----------------------------------------------------------------
+DataFrame<double> SimplexBatch( const DataFrameView< double > &data,
+                                std::string                    pathOut,
+                                std::string                    predictFile,
+                                std::string                    columns,
+                                int                            predRows,
+                                int                            E,
+                                int                            Tp,
+                                int                            knn,
+                                int                            tau,
+                                ExecutionContext               exec ) {
+
+    std::vector< std::valarray< double > > series;
+
+    if ( columns.size() ) {
+        std::vector<std::string> columnNames = SplitString( columns,
+                                                            " \t,\n" );
+        for ( auto ci = columnNames.begin(); ci != columnNames.end(); ++ci ) {
+            series.push_back( data.VectorColumnName( *ci ) );
+        }
+    }
+    else {
+        for ( size_t col = 1; col < data.NColumns(); col++ ) {
+            series.push_back( data.Column( col ) );
+        }
+    }
+
+    std::valarray< double > time = data.Column( 0 );
+
+    DataFrame< double > batch = EDM_Batch::Batch( series, &time, predRows,
+                                                  E, Tp, knn, tau, exec );
+
+    if ( predictFile.size() ) {
+        batch.WriteData( pathOut, predictFile );
+    }
+
+    return batch;
+}
+
+//----------------------------------------------------------------
+// API Overload 3: Collection of series, time is the row number
+//----------------------------------------------------------------
+DataFrame<double> SimplexBatch(
+    const std::vector< std::valarray< double > > &series,
+    std::string      pathOut,
+    std::string      predictFile,
+    int              predRows,
+    int              E,
+    int              Tp,
+    int              knn,
+    int              tau,
+    ExecutionContext exec ) {
+
+    DataFrame< double > batch = EDM_Batch::Batch( series, nullptr, predRows,
+                                                  E, Tp, knn, tau, exec );
+
+    if ( predictFile.size() ) {
+        batch.WriteData( pathOut, predictFile );
+    }
+
+    return batch;
+}
@@ -1,16 +1,7 @@
-
 #include <cstdlib>
 #include <random>
 #include <chrono>
 
-#ifdef CCM_THREADED // Defined in makefile
-// Two explicit CrossMap() threads are invoked. One for forward mapping, 
-// one for inverse mapping.  The call signature of CrossMap() is
-// dependent on which path is used.  This should probably be unified 
-// to use the same signature.
-#include <thread>
-#endif
-
 #include "Common.h"
 #include "Embed.h"
 #include "AuxFunc.h"
@@ -18,17 +9,41 @@
 //----------------------------------------------------------------
 // forward declarations
 //----------------------------------------------------------------
-#ifdef CCM_THREADED
-void CrossMap( Parameters p, DataFrame< double > df,
-               const DataFrame< double > & LibStats );
-#else
-DataFrame< double > CrossMap( Parameters p, DataFrame< double > df );
-#endif
+namespace EDM_CCM {
+    // CCM() of DataFrame values of type T
+    template < class T >
+    DataFrame< double > CCM( const DataFrameView< T > &dataFrameIn,
+                             std::string pathOut,
+                             std::string predictFile,
+                             int         E,
+                             int         Tp,
+                             int         knn,
+                             int         tau,
+                             std::string columns,
+                             std::string target,
+                             std::string libSizes_str,
+                             int         sample,
+                             bool        random,
+                             unsigned    seed,
+                             bool        verbose,
+                             ExecutionContext exec );
+
+    // CCMDistances() of the shared embedding cache, if enabled
+    template < class T >
+    DataFrame< T > CachedDistances( const DataFrame< T > &dataBlock,
+                                    const Parameters     &param );
+}
 
-DataFrame< double > CCMDistances( DataFrame< double > dataBlock,
-                                  Parameters param );
+template < class T >
+DataFrame< double > CrossMap( Parameters                p,
+                              const DataFrameView< T > &df );
 
-Neighbors CCMNeighbors( DataFrame< double > Distances,
+template < class T >
+DataFrame< T > CCMDistances( const DataFrame< T > &dataBlock,
+                             Parameters            param );
+
+template < class T >
+Neighbors CCMNeighbors( const DataFrame< T > &Distances,
                         std::vector< size_t > lib_i, Parameters param );
 
 DataFrame<double> SimplexProjection( Parameters  param,
@@ -54,13 +69,15 @@ DataFrame <double > CCM( std::string pathIn,
                          int         sample,
                          bool        random,
                          unsigned    seed,
-                         bool        verbose )
+                         bool        verbose,
+                         ExecutionContext exec )
 {
 
     //----------------------------------------------------------
     // Load data to dataFrameIn
     //----------------------------------------------------------
-    DataFrame< double > dataFrameIn( pathIn, dataFile );
+    DataFrame< double > dataFrameIn( pathIn, dataFile,
+                                     DataColumns( columns, target ) );
 
     DataFrame <double > PredictLibRho = CCM( dataFrameIn,
                                              pathOut,
@@ -75,7 +92,8 @@ DataFrame <double > CCM( std::string pathIn,
                                              sample,
                                              random,
                                              seed,
-                                             verbose );
+                                             verbose,
+                                             exec );
     return PredictLibRho;
 }
 
@@ -83,7 +101,32 @@ DataFrame <double > CCM( std::string pathIn,
 // API Overload 2: DataFrame passed in
 //   Implemented a wrapper for CrossMap()
 //----------------------------------------------------------------
-DataFrame <double > CCM( DataFrame< double > dataFrameIn,
+DataFrame <double > CCM( const DataFrameView< double > &dataFrameIn,
+                         std::string pathOut,
+                         std::string predictFile,
+                         int         E,
+                         int         Tp,
+                         int         knn,
+                         int         tau,
+                         std::string columns,
+                         std::string target,
+                         std::string libSizes_str,
+                         int         sample,
+                         bool        random,
+                         unsigned    seed,
+                         bool        verbose,
+                         ExecutionContext exec )
+{
+    return EDM_CCM::CCM( dataFrameIn, pathOut, predictFile, E, Tp, knn,
+                         tau, columns, target, libSizes_str, sample,
+                         random, seed, verbose, exec );
+}
+
+//----------------------------------------------------------------
+// API Overload 2: float32 DataFrame passed in
+//   Embeddings and distances are float32
+//----------------------------------------------------------------
+DataFrame <double > CCM( const DataFrameView< float > &dataFrameIn,
                          std::string pathOut,
                          std::string predictFile,
                          int         E,
@@ -96,7 +139,33 @@ DataFrame <double > CCM( DataFrame< double > dataFrameIn,
                          int         sample,
                          bool        random,
                          unsigned    seed,
-                         bool        verbose )
+                         bool        verbose,
+                         ExecutionContext exec )
+{
+    return EDM_CCM::CCM( dataFrameIn, pathOut, predictFile, E, Tp, knn,
+                         tau, columns, target, libSizes_str, sample,
+                         random, seed, verbose, exec );
+}
+
+//----------------------------------------------------------------
+// CCM() of DataFrame values of type T
+//----------------------------------------------------------------
+template < class T >
+DataFrame< double > EDM_CCM::CCM( const DataFrameView< T > &dataFrameIn,
+                                  std::string pathOut,
+                                  std::string predictFile,
+                                  int         E,
+                                  int         Tp,
+                                  int         knn,
+                                  int         tau,
+                                  std::string columns,
+                                  std::string target,
+                                  std::string libSizes_str,
+                                  int         sample,
+                                  bool        random,
+                                  unsigned    seed,
+                                  bool        verbose,
+                                  ExecutionContext exec )
 {
     if ( not columns.size() ) {
         throw std::runtime_error("CCM() must specify the column to embed.");
@@ -114,6 +183,7 @@ DataFrame <double > CCM( DataFrame< double > dataFrameIn,
                                    columns, target, false, verbose,
                                    "", "", "", 0, 0, 0, 0,
                                    libSizes_str, sample, random, seed );
+    param.exec = exec;
 
     if ( param.columnNames.size() > 1 ) {
         std::cout << "WARNING: CCM() Only the first column will be mapped.\n";
@@ -135,25 +205,20 @@ DataFrame <double > CCM( DataFrame< double > dataFrameIn,
     std::cout << inverseParam;
 #endif
 
-#ifdef CCM_THREADED
-    DataFrame<double> col_to_target( param.librarySizes.size(), 4,
-                                     "LibSize rho RMSE MAE" );
-    DataFrame<double> target_to_col( param.librarySizes.size(), 4,
-                                     "LibSize rho RMSE MAE" );
-
-    std::thread CrossMapColTarget( CrossMap, param, dataFrameIn,
-                                   std::ref( col_to_target ) );
-    
-    std::thread CrossMapTargetCol( CrossMap, inverseParam, dataFrameIn,
-                                   std::ref( target_to_col ) );
-
-    CrossMapColTarget.join();
-    CrossMapTargetCol.join();
-#else    
-    DataFrame< double > col_to_target = CrossMap( param, dataFrameIn );
-
-    DataFrame< double > target_to_col = CrossMap( inverseParam, dataFrameIn );
-#endif
+    //-----------------------------------------------------------------
+    // Forward and inverse mappings are run as two pool tasks. Each
+    // CrossMap() distributes its subsamples over the same pool.
+    //-----------------------------------------------------------------
+    DataFrame< double > col_to_target;
+    DataFrame< double > target_to_col;
+
+    param.exec.Pool().ParallelFor(
+        2,
+        [&]( size_t i ) {
+            if ( i == 0 ) { col_to_target = CrossMap( param, dataFrameIn ); }
+            else { target_to_col = CrossMap( inverseParam, dataFrameIn ); }
+        },
+        param.exec.nThreads );
     
     //-----------------------------------------------------------------
     // Output
@@ -185,17 +250,9 @@ DataFrame <double > CCM( DataFrame< double > dataFrameIn,
 // Worker function for CCM.
 // Return DataFrame of rho, RMSE, MAE values for param.librarySizes
 //----------------------------------------------------------------
-#ifdef CCM_THREADED
-void CrossMap( Parameters paramCCM,
-               DataFrame< double > dataFrameIn,
-               const DataFrame< double > & LibStatsIn ) {
-    
-    DataFrame< double > & LibStats =
-        const_cast<DataFrame< double > &>(LibStatsIn);
-#else
-DataFrame< double > CrossMap( Parameters paramCCM,
-                              DataFrame< double > dataFrameIn ) {
-#endif
+template < class T >
+DataFrame< double > CrossMap( Parameters                paramCCM,
+                              const DataFrameView< T > &dataFrameIn ) {
     
     if ( paramCCM.verbose ) {
         std::stringstream msg;
@@ -214,33 +271,27 @@ DataFrame< double > CrossMap( Parameters paramCCM,
     //----------------------------------------------------------
     // Generate embedding on data to be cross mapped (-c column)
     //----------------------------------------------------------
-    DataFrame<double> dataBlock;
-
-    dataBlock = Embed( dataFrameIn, paramCCM.E, paramCCM.tau,
-                       paramCCM.columnNames[0], paramCCM.verbose );
+    DataFrame< T > dataBlock = Embed( dataFrameIn, paramCCM.E, paramCCM.tau,
+                                      paramCCM.columnNames[0],
+                                      paramCCM.verbose, paramCCM.exec );
 
     size_t N_row = dataBlock.NRows();
 
     // JP: This removal of partial data rows is also done in EmbedNN()
     //     Should investigate how to avoid this duplication
     //----------------------------------------------------------
-    // Remove dataFrameIn, target rows as needed
+    // Remove dataFrameIn, target rows as needed: a view, not copied
     //----------------------------------------------------------
     // If we support negtive tau, this will change
     // For now, assume only positive tau is allowed
     size_t shift = std::max(0, paramCCM.tau * (paramCCM.E - 1) );
     
-    DataFrame<double> dataInEmbed( dataFrameIn.NRows() - shift,
-                                   dataFrameIn.NColumns(),
-                                   dataFrameIn.ColumnNames() );
-    
-    for ( size_t row = 0; row < dataInEmbed.NRows(); row++ ) {
-        dataInEmbed.WriteRow( row, dataFrameIn.Row( row + shift ) );
-    }
+    DataFrameView< T > dataInEmbed =
+        dataFrameIn.Rows( shift, dataFrameIn.NRows() - shift );
 
 #ifdef DEBUG_ALL
     std::cout << ">>>> CrossMap() dataInEmbed-----------------------\n";
-    std::cout << dataInEmbed;
+    std::cout << DataFrame< T >( dataInEmbed );
     std::cout << "<<<< dataInEmbed----------------------------------\n";
     std::cout << ">>>> dataBlock------------------------------------\n";
     std::cout << dataBlock;
@@ -258,6 +309,10 @@ DataFrame< double > CrossMap( Parameters paramCCM,
     // Validate converts lib_str, pred_str to library & prediction vectors
     paramCCM.Validate();
 
+    // The subsample SimplexProjection() output is not written to disk,
+    // CCM() writes the library size statistics
+    paramCCM.predictOutputFile = "";
+
     //-----------------------------------------------------------------
     // Set the number of samples
     //-----------------------------------------------------------------
@@ -289,7 +344,8 @@ DataFrame< double > CrossMap( Parameters paramCCM,
     // Distance for all possible pred : lib E-dimensional vector pairs
     // Distances is a square Matrix of all row to to row distances
     //-----------------------------------------------------------------
-    DataFrame< double > Distances = CCMDistances( dataBlock, paramCCM );
+    DataFrame< T > Distances = EDM_CCM::CachedDistances( dataBlock,
+                                                         paramCCM );
 
 #ifdef DEBUG_ALL
     std::cout << "CrossMap() " << paramCCM.columnNames[0] << " to "
@@ -300,11 +356,9 @@ DataFrame< double > CrossMap( Parameters paramCCM,
     //----------------------------------------------------------
     // Predictions
     //----------------------------------------------------------
-#ifndef CCM_THREADED
     // Output DataFrame
     DataFrame<double> LibStats( paramCCM.librarySizes.size(), 4,
                                 "LibSize rho RMSE MAE" );
-#endif
     
     // Loop for library sizes
     for ( size_t lib_size_i = 0;
@@ -324,11 +378,16 @@ DataFrame< double > CrossMap( Parameters paramCCM,
         std::valarray< double > RMSE( maxSamples );
         std::valarray< double > MAE ( maxSamples );
 
+        // Row indices of each subsample. These are drawn sequentially
+        // so that the RNG sequence does not depend on thread scheduling
+        std::vector< std::vector< size_t > > lib_samples( maxSamples );
+
         // Loop for subsamples
         for ( size_t n = 0; n < maxSamples; n++ ) {
             
             // Vector of row indices to include in this lib_size evaluation
-            std::vector< size_t > lib_i( lib_size );
+            std::vector< size_t > &lib_i = lib_samples[ n ];
+            lib_i.resize( lib_size );
 
             if ( paramCCM.randomLib ) {
                 // Uniform random sample of rows, with replacement
@@ -381,6 +440,14 @@ DataFrame< double > CrossMap( Parameters paramCCM,
                 std::cout << lib_i[i] << " ";
             } std::cout << std::endl;
 #endif
+        } // for ( n = 0; n < maxSamples; n++ )
+
+        //--------------------------------------------------------------
+        // Evaluate the subsamples over the thread pool
+        //--------------------------------------------------------------
+        auto EvalSample = [&]( size_t n ) {
+            
+            const std::vector< size_t > &lib_i = lib_samples[ n ];
 
             //----------------------------------------------------------
             // Nearest neighbors : Local CCMNeighbors() function
@@ -395,16 +462,20 @@ DataFrame< double > CrossMap( Parameters paramCCM,
                                                 dataInEmbed.ColumnNames() );
             
             for ( size_t i = 0; i < lib_i.size(); i++ ) {
-                dataFrameLib_i.WriteRow( i, dataInEmbed.Row( lib_i[ i ] ) ) ;
+                for ( size_t col = 0; col < dataInEmbed.NColumns(); col++ ) {
+                    dataFrameLib_i( i, col ) = dataInEmbed( lib_i[ i ], col );
+                }
             }
 
             std::valarray<double> targetVec =
                 dataFrameLib_i.VectorColumnName( paramCCM.targetName );
             
             //----------------------------------------------------------
-            // Pack embedding, target, neighbors for SimplexProjection
+            // Pack target, neighbors for SimplexProjection, which does
+            // not use the embedding
             //----------------------------------------------------------
-            DataEmbedNN embedNN = DataEmbedNN( dataFrameLib_i, dataBlock,
+            DataEmbedNN embedNN = DataEmbedNN( dataFrameLib_i,
+                                               DataFrame< double >(),
                                                targetVec,  neighbors );
 
             //----------------------------------------------------------
@@ -426,7 +497,10 @@ DataFrame< double > CrossMap( Parameters paramCCM,
             RMSE[ n ] = ve.RMSE;
             MAE [ n ] = ve.MAE;
             
-        } // for ( n = 0; n < maxSamples; n++ )
+        };
+
+        paramCCM.exec.Pool().ParallelFor( maxSamples, EvalSample,
+                                          paramCCM.exec.nThreads );
 
         std::valarray< double > statVec( 4 );
         statVec[ 0 ] = lib_size;
@@ -437,9 +511,38 @@ DataFrame< double > CrossMap( Parameters paramCCM,
         LibStats.WriteRow( lib_size_i, statVec );
     } // for ( lib_size : param.librarySizes ) 
 
-#ifndef CCM_THREADED
     return LibStats;
-#endif
+}
+
+//---------------------------------------------------------------------
+// CCMDistances() found in the shared embedding cache if it is enabled,
+// else computed and cached. Keyed by a hash of the dataBlock values:
+// repeated CCM() of a column reuse the distances.
+//---------------------------------------------------------------------
+template < class T >
+DataFrame< T > EDM_CCM::CachedDistances( const DataFrame< T > &dataBlock,
+                                         const Parameters     &param ) {
+
+    EmbeddingCache &cache = SharedEmbeddingCache();
+    if ( not cache.Enabled() ) {
+        return CCMDistances( dataBlock, param );
+    }
+
+    std::stringstream key;
+    key << "CCMDistances " << ( sizeof( T ) == sizeof( float ) ?
+                                "float32 " : "" )
+        << dataBlock.NRows() << "x" << dataBlock.NColumns() << " "
+        << HashValues( dataBlock.View() ) << " E " << param.E;
+
+    EmbeddingCacheEntry entry;
+    if ( cache.Find( key.str(), entry ) ) {
+        return entry.Block< T >();
+    }
+
+    DataFrame< T > Distances = CCMDistances( dataBlock, param );
+    entry.Block< T >() = Distances;
+    cache.Insert( key.str(), entry );
+    return Distances;
 }
 
 //--------------------------------------------------------------------- 
@@ -450,46 +553,60 @@ DataFrame< double > CrossMap( Parameters paramCCM,
 // Matrix elements D[i,j] hold the distance between the E-dimensional
 // phase space point (vector) between rows (observations) i and j.
 //---------------------------------------------------------------------
-DataFrame< double > CCMDistances( DataFrame< double > dataBlock,
-                                  Parameters param ) {
+template < class T >
+DataFrame< T > CCMDistances( const DataFrame< T > &dataBlockIn,
+                             Parameters            param ) {
     
-    size_t N_row = dataBlock.NRows();
+    size_t N_row = dataBlockIn.NRows();
 
     size_t E = param.E;
 
-    DataFrame< double > D = DataFrame< double >( N_row, N_row );
+    DataFrame< T > D = DataFrame< T >( N_row, N_row );
 
     // Initialise D to DISTANCE_MAX to avoid sort() : Add init constructor?
-    std::valarray< double > row_init( DISTANCE_MAX, N_row );
+    // DISTANCE_MAX exceeds float32: infinity, also never a neighbor
+    T distanceMax = std::numeric_limits< T >::max() < DISTANCE_MAX ?
+                    std::numeric_limits< T >::infinity() : DISTANCE_MAX;
+    std::valarray< T > row_init( distanceMax, N_row );
     for ( size_t row = 0; row < N_row; row++ ) {
         D.WriteRow( row, row_init );
     }
 
-    for ( size_t row = 0; row < N_row; row++ ) {
-        // Get E-dimensional vector from this library row
-        std::valarray< double > v1_ = dataBlock.Row( row );
-        // The first column (i=0) is NOT time, use it
-        std::valarray< double > v1 = v1_[ std::slice( 0, E, 1 ) ];
-
-        // Only compute upper triangular D, the diagonal and
-        // lower left are redundant: (col < N_row - 1); row >= col
-        for ( size_t col = 0; col < N_row - 1; col++ ) {
-            // Avoid redundant computations
-            if ( row >= col ) {
-                continue; // Computed in upper triangle, copied below
-            }
-            
-            // Find distance between vector (v) and other library vector
-            std::valarray< double > v2_ = dataBlock.Row( col );
+    // Rows of the embedding are read in place
+    DataFrame< T > dataBlock =
+        dataBlockIn.ToLayout( DataFrameLayout::RowMajor );
+    const T *values = dataBlock.Data();
+    size_t   stride = dataBlock.Stride();
+
+    // Rows of D are distributed over the thread pool
+    auto DistanceRows = [&]( size_t rowStart, size_t rowStop ) {
+        for ( size_t row = rowStart; row < rowStop; row++ ) {
+            // E-dimensional vector of this library row
             // The first column (i=0) is NOT time, use it
-            std::valarray< double > v2 = v2_[ std::slice( 0, E, 1 ) ];
+            const T *v1 = values + row * stride;
+
+            // Only compute upper triangular D, the diagonal and
+            // lower left are redundant: (col < N_row - 1); row >= col
+            for ( size_t col = 0; col < N_row - 1; col++ ) {
+                // Avoid redundant computations
+                if ( row >= col ) {
+                    continue; // Computed in upper triangle, copied below
+                }
             
-            D( row, col ) = Distance( v1, v2, DistanceMetric::Euclidean );
+                // Find distance between vector (v) and other library vector
+                const T *v2 = values + col * stride;
             
-            // Insert degenerate values since D[i,j] = D[j,i]
-            D( col, row ) = D( row, col );
-        }
-    }
+                D( row, col ) = Distance( v1, v2, E,
+                                          DistanceMetric::Euclidean );
+            
+                // Insert degenerate values since D[i,j] = D[j,i]
+                D( col, row ) = D( row, col );
+            }
+        } // for ( row = rowStart; row < rowStop; row++ )
+    };
+
+    param.exec.Pool().ParallelForRange( N_row, 16, DistanceRows,
+                                        param.exec.nThreads );
     return D;
 }
 
@@ -507,7 +624,8 @@ DataFrame< double > CCMDistances( DataFrame< double > dataBlock,
 // from 0 to len(lib_i)-1.
 //
 //---------------------------------------------------------------------
-Neighbors CCMNeighbors( DataFrame< double >   DistancesIn,
+template < class T >
+Neighbors CCMNeighbors( const DataFrame< T >  &DistancesIn,
                         std::vector< size_t > lib_i,
                         Parameters            param ) {
 
@@ -550,7 +668,8 @@ Neighbors CCMNeighbors( DataFrame< double >   DistancesIn,
   
         // Take Distances( row, col ) a row at a time
         // col represent the other row distance
-        std::valarray< double > dist_row = DistancesIn.Row( row_i );
+        const T *dist_row = DistancesIn.Data() +
+                            row_i * DistancesIn.Stride();
         
         // These new column indices are with respect to the lib_i vector
         // not the original Distances with all other columns
@@ -0,0 +1,154 @@
+
+#include <iomanip>
+
+#include "Common.h"
+
+//----------------------------------------------------------------
+// Nominal bytes of the entry DataFrames
+//----------------------------------------------------------------
+size_t EmbeddingCacheEntry::Bytes() const {
+    return block.NRows()      * block.NColumns()      * sizeof( double ) +
+           blockFloat.NRows() * blockFloat.NColumns() * sizeof( float  ) +
+           neighbors.NRows()  * neighbors.NColumns()  * sizeof( size_t ) +
+           distances.NRows()  * distances.NColumns()  * sizeof( double );
+}
+
+//----------------------------------------------------------------
+EmbeddingCache::EmbeddingCache( size_t maxBytes ) :
+    maxBytes( maxBytes ), bytes( 0 ), hits( 0 ), misses( 0 ),
+    evictions( 0 ) {}
+
+//----------------------------------------------------------------
+// Entry of key, made most recent
+//----------------------------------------------------------------
+bool EmbeddingCache::Find( const std::string   &key,
+                           EmbeddingCacheEntry &entry ) {
+    std::lock_guard< std::mutex > lock( mtx );
+
+    auto ii = index.find( key );
+    if ( ii == index.end() ) {
+        misses++;
+        return false;
+    }
+    items.splice( items.begin(), items, ii->second );
+    entry = ii->second->second;
+    hits++;
+    return true;
+}
+
+//----------------------------------------------------------------
+// Insert or replace the entry of key, most recent
+//----------------------------------------------------------------
+void EmbeddingCache::Insert( const std::string         &key,
+                             const EmbeddingCacheEntry &entry ) {
+    size_t entryBytes = entry.Bytes();
+
+    std::lock_guard< std::mutex > lock( mtx );
+
+    if ( entryBytes > maxBytes ) {
+        return;
+    }
+
+    auto ii = index.find( key );
+    if ( ii != index.end() ) {
+        bytes -= ii->second->second.Bytes();
+        items.erase( ii->second );
+        index.erase( ii );
+    }
+
+    Evict( maxBytes - entryBytes );
+
+    items.push_front( Item( key, entry ) );
+    index[ key ] = items.begin();
+    bytes       += entryBytes;
+}
+
+//----------------------------------------------------------------
+// Remove least recent entries until at most toBytes are cached
+//----------------------------------------------------------------
+void EmbeddingCache::Evict( size_t toBytes ) {
+    while ( bytes > toBytes and items.size() ) {
+        bytes -= items.back().second.Bytes();
+        index.erase( items.back().first );
+        items.pop_back();
+        evictions++;
+    }
+}
+
+//----------------------------------------------------------------
+void EmbeddingCache::Resize( size_t maxBytes ) {
+    std::lock_guard< std::mutex > lock( mtx );
+    this->maxBytes = maxBytes;
+    Evict( maxBytes );
+
+    if ( not maxBytes ) {
+        items.clear();
+        index.clear();
+    }
+}
+
+void EmbeddingCache::Clear() {
+    std::lock_guard< std::mutex > lock( mtx );
+    items.clear();
+    index.clear();
+    bytes = 0;
+}
+
+size_t EmbeddingCache::Entries() const {
+    std::lock_guard< std::mutex > lock( mtx );
+    return items.size();
+}
+
+//----------------------------------------------------------------
+// Library wide cache
+//----------------------------------------------------------------
+EmbeddingCache &SharedEmbeddingCache() {
+    static EmbeddingCache cache;
+    return cache;
+}
+
+void ConfigureEmbeddingCache( size_t maxBytes ) {
+    SharedEmbeddingCache().Resize( maxBytes );
+}
+
+//----------------------------------------------------------------
+// Hash of values in cache keys
+//----------------------------------------------------------------
+std::ostream &operator<<( std::ostream &os, const ValuesHash &hash ) {
+    std::stringstream digits;
+    digits << std::hex << std::setfill( '0' ) << std::setw( 16 )
+           << hash.fnv << std::setw( 16 ) << hash.splitmix;
+    return os << digits.str();
+}
+
+//----------------------------------------------------------------
+// Persistent neighbor index directory
+//----------------------------------------------------------------
+namespace EDM_Cache {
+    std::mutex  indexMutex;
+    std::string indexDirectory;
+}
+
+void ConfigureNeighborIndex( std::string directory ) {
+    if ( directory.size() and directory.back() != '/' ) {
+        directory += '/';
+    }
+    std::lock_guard< std::mutex > lock( EDM_Cache::indexMutex );
+    EDM_Cache::indexDirectory = directory;
+}
+
+std::string NeighborIndexDirectory() {
+    std::lock_guard< std::mutex > lock( EDM_Cache::indexMutex );
+    return EDM_Cache::indexDirectory;
+}
+
+std::string NeighborIndexFileName( const std::string &key ) {
+    uint64_t hash = HashOffset;
+    for ( size_t i = 0; i < key.size(); i++ ) {
+        hash = ( hash ^ (unsigned char) key[ i ] ) * 1099511628211ULL;
+    }
+    std::stringstream fileName;
+    fileName << "neighbors_" << std::hex << std::setw( 16 )
+             << std::setfill( '0' ) << hash << ".edmnn";
+    return fileName.str();
+}
@@ -0,0 +1,162 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#include "DataFrame.h"
+
+//----------------------------------------------------------------
+// Values of an EmbeddingCache entry. Entries share the values of
+// the DataFrames inserted and found (copy-on-write), not copied.
+//----------------------------------------------------------------
+struct EmbeddingCacheEntry {
+    DataFrame< double > block;      // embedding, or CCM distances
+    DataFrame< float  > blockFloat; // of float32 data
+    DataFrame< size_t > neighbors;  // Neighbors of EmbedNN()
+    DataFrame< double > distances;
+
+    // block, or blockFloat, of values of type T
+    template < class T > DataFrame< T > &Block();
+
+    size_t Bytes() const;
+};
+
+template <> inline DataFrame< double > &EmbeddingCacheEntry::Block() {
+    return block;
+}
+template <> inline DataFrame< float > &EmbeddingCacheEntry::Block() {
+    return blockFloat;
+}
+
+//----------------------------------------------------------------
+// EmbeddingCache
+// Size bounded, least recently used cache of embedding blocks and
+// neighbors. Keys hold the parameters a result depends on and a
+// hash of the data values, see HashValues(). Thread safe: engines
+// running concurrently share the cache.
+//
+// The cache is opt-in: SharedEmbeddingCache() holds no entries
+// until ConfigureEmbeddingCache() gives it a size.
+//----------------------------------------------------------------
+class EmbeddingCache {
+
+public:
+    EmbeddingCache( size_t maxBytes = 0 );
+
+    // Entry of key, made most recent. false if not cached.
+    bool Find( const std::string &key, EmbeddingCacheEntry &entry );
+
+    // Insert or replace the entry of key, evicting the least recent
+    // entries over MaxBytes(). Entries over MaxBytes() are not cached.
+    void Insert( const std::string &key, const EmbeddingCacheEntry &entry );
+
+    // MaxBytes 0 disables the cache
+    void Resize( size_t maxBytes );
+    void Clear();
+
+    bool   Enabled()   const { return maxBytes > 0; }
+    size_t MaxBytes()  const { return maxBytes;     }
+    size_t Bytes()     const { return bytes;        }
+    size_t Entries()   const;
+    size_t Hits()      const { return hits;         }
+    size_t Misses()    const { return misses;       }
+    size_t Evictions() const { return evictions;    }
+
+private:
+    typedef std::pair< std::string, EmbeddingCacheEntry > Item;
+
+    mutable std::mutex mtx;
+    std::list< Item >  items; // most recent first
+    std::unordered_map< std::string, std::list< Item >::iterator > index;
+
+    std::atomic< size_t > maxBytes;
+    std::atomic< size_t > bytes;
+    std::atomic< size_t > hits;
+    std::atomic< size_t > misses;
+    std::atomic< size_t > evictions;
+
+    void Evict( size_t toBytes ); // mtx locked
+};
+
+// Library wide cache, disabled until configured
+EmbeddingCache &SharedEmbeddingCache();
+
+// Size of the shared cache in bytes: 0 disables and clears it
+void ConfigureEmbeddingCache( size_t maxBytes );
+
+// Directory of persistent neighbor index files, shared by processes
+// (see WriteNeighborIndex()): "" (default) disables them. Neighbors
+// not in the shared cache are read from, or saved to, the directory.
+void        ConfigureNeighborIndex( std::string directory );
+std::string NeighborIndexDirectory();
+
+// Neighbor index file name of a cache key: a hash of the key
+std::string NeighborIndexFileName( const std::string &key );
+
+//----------------------------------------------------------------
+// Hash of values: two independent 64 bit hashes of the value bits
+// in order, values that hash equal give equal results. Each value
+// is mixed by the murmur3 fmix64 finalizer before FNV-1a combines
+// it, and by splitmix64 in the second hash: changes of single bits,
+// such as sign flips, do not cancel between values.
+//----------------------------------------------------------------
+const uint64_t HashOffset = 14695981039346656037ULL;
+
+struct ValuesHash {
+    uint64_t fnv      = HashOffset;
+    uint64_t splitmix = 0x9E3779B97F4A7C15ULL;
+
+    void Add( uint64_t bits ) {
+        uint64_t mixed = bits;
+        mixed ^= mixed >> 33; mixed *= 0xFF51AFD7ED558CCDULL;
+        mixed ^= mixed >> 33; mixed *= 0xC4CEB9FE1A85EC53ULL;
+        mixed ^= mixed >> 33;
+        fnv = ( fnv ^ mixed ) * 1099511628211ULL;
+
+        mixed = splitmix ^ bits;
+        mixed += 0x9E3779B97F4A7C15ULL;
+        mixed = ( mixed ^ ( mixed >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+        mixed = ( mixed ^ ( mixed >> 27 ) ) * 0x94D049BB133111EBULL;
+        splitmix = mixed ^ ( mixed >> 31 );
+    }
+
+    bool operator==( const ValuesHash &hash ) const {
+        return fnv == hash.fnv and splitmix == hash.splitmix;
+    }
+    bool operator!=( const ValuesHash &hash ) const {
+        return not ( *this == hash );
+    }
+};
+
+// 32 hex digits of both hashes, as in cache keys
+std::ostream &operator<<( std::ostream &os, const ValuesHash &hash );
+
+template < class T >
+ValuesHash HashValues( const DataFrameView< T > &view,
+                       ValuesHash                hash = ValuesHash() ) {
+    for ( size_t row = 0; row < view.NRows(); row++ ) {
+        for ( size_t col = 0; col < view.NColumns(); col++ ) {
+            T        value = view( row, col );
+            uint64_t bits  = 0;
+            std::memcpy( &bits, &value, sizeof( T ) );
+            hash.Add( bits );
+        }
+    }
+    return hash;
+}
+
+inline ValuesHash HashValues( const std::vector< size_t > &values,
+                              ValuesHash hash = ValuesHash() ) {
+    for ( size_t i = 0; i < values.size(); i++ ) {
+        hash.Add( values[ i ] );
+    }
+    return hash;
+}
+#endif
@@ -180,3 +180,24 @@ VectorError ComputeError( std::valarray< double > obsIn,
     
     return vectorError;
 }
+
+//----------------------------------------------------------------
+// Columns of a data file used by an API call, for the column
+// projection of DataFrame( path, fileName, columns ).
+// Returns "" (all columns) if the call uses column indices or the
+// default target, column 1.
+//----------------------------------------------------------------
+std::string DataColumns( std::string columns, std::string target ) {
+
+    std::vector< std::string > names = SplitString( columns, " \t,\n" );
+
+    if ( names.empty() or target.empty() or OnlyDigits( target ) ) {
+        return "";
+    }
+    for ( auto ni = names.begin(); ni != names.end(); ++ni ) {
+        if ( OnlyDigits( *ni ) ) {
+            return "";
+        }
+    }
+    return columns + " " + target;
+}
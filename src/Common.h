@@ -9,7 +9,11 @@
 #include <cctype>
 #include <cmath>
 
+#include "ThreadPool.h"
 #include "DataFrame.h" // has #include Common.h
+#include "ResultSink.h"
+#include "Arrow.h"
+#include "Cache.h"
 
 // Normally, macros are eschewed
 // Define the initial maximum distance for neigbor distances to avoid sort()
@@ -38,6 +42,22 @@ struct SMapValues {
     DataFrame< double > coefficients;
 };
 
+// Return structure of ParameterSearch()
+struct SearchValues {
+    DataFrame< double > Best;       // Winning configuration
+    DataFrame< double > Configs;    // All configurations at their last round
+    DataFrame< double > Rounds;     // Prediction rows & configurations
+    size_t              evaluations;// Prediction rows projected
+    size_t              exhaustive; // Prediction rows of ParameterSweep()
+};
+
+// Return structure of RollingOrigin()
+struct RollingValues {
+    DataFrame< double > Folds;       // Fold lib, pred and skill
+    DataFrame< double > Skill;       // Pooled and mean skill of the folds
+    DataFrame< double > Predictions; // Fold, Time, Observations, Predictions
+};
+
 // Return structure of Multiview()
 struct MultiviewValues {
     DataFrame< double > Combo_rho;
@@ -67,11 +87,30 @@ bool        OnlyDigits( std::string str );
 std::vector<std::string> SplitString( std::string inString, 
                                       std::string delimeters );
 
+// Columns to load for an API call with columns and target
+std::string DataColumns( std::string columns, std::string target );
+
 VectorError ComputeError( std::valarray< double > obs,
                           std::valarray< double > pred );
 
+// Arrow C Data Interface : Arrow.h Arrow.cc
+// ImportArrow() moves schema and array in, and releases them once the
+// DataFrame is done with them. The consumer of ExportArrow() calls the
+// schema and array release callbacks. Zero-copy: import of float64
+// columns without nulls stored one after the other, export of a
+// column-major DataFrame. Other tables are copied once.
+DataFrame< double > ImportArrow( struct ArrowSchema *schema,
+                                 struct ArrowArray  *array );
+
+void ExportArrow( const DataFrame< double > &data,
+                  struct ArrowSchema        *schema,
+                  struct ArrowArray         *array );
+
 // API functions Embed() and MakeBlock() are in Embed.h Embed.cc
 
+// Data arguments are DataFrameView: a DataFrame, or a view of its
+// rows and columns, is used in place without a copy.
+
 DataFrame<double> Simplex( std::string pathIn       = "./data/",
                            std::string dataFile     = "",
                            std::string pathOut      = "./",
@@ -85,9 +124,27 @@ DataFrame<double> Simplex( std::string pathIn       = "./data/",
                            std::string colNames     = "",
                            std::string targetName   = "",
                            bool        embedded     = false,
-                           bool        verbose      = true );
+                           bool        verbose      = true,
+                           ExecutionContext exec = ExecutionContext() );
+
+DataFrame<double> Simplex( const DataFrameView< double > &,
+                           std::string pathOut      = "./",
+                           std::string predictFile  = "",
+                           std::string lib          = "",
+                           std::string pred         = "",
+                           int         E            = 0,
+                           int         Tp           = 1,
+                           int         knn          = 0,
+                           int         tau          = 1,
+                           std::string colNames     = "",
+                           std::string targetName   = "",
+                           bool        embedded     = false,
+                           bool        verbose      = true,
+                           ExecutionContext exec = ExecutionContext() );
 
-DataFrame<double> Simplex( DataFrame< double >,
+// float32 data: the embedding and neighbor search are float32,
+// projections and the output are double
+DataFrame<double> Simplex( const DataFrameView< float > &,
                            std::string pathOut      = "./",
                            std::string predictFile  = "",
                            std::string lib          = "",
@@ -99,7 +156,24 @@ DataFrame<double> Simplex( DataFrame< double >,
                            std::string colNames     = "",
                            std::string targetName   = "",
                            bool        embedded     = false,
-                           bool        verbose      = true );
+                           bool        verbose      = true,
+                           ExecutionContext exec = ExecutionContext() );
+
+// Predictions pushed to sink in blocks of rows as they are projected,
+// no output DataFrame is built
+void Simplex( const DataFrameView< double > &,
+              ResultSink &sink,
+              std::string lib          = "",
+              std::string pred         = "",
+              int         E            = 0,
+              int         Tp           = 1,
+              int         knn          = 0,
+              int         tau          = 1,
+              std::string colNames     = "",
+              std::string targetName   = "",
+              bool        embedded     = false,
+              bool        verbose      = true,
+              ExecutionContext exec = ExecutionContext() );
 
 SMapValues SMap( std::string pathIn          = "./data/",
                  std::string dataFile        = "",
@@ -117,9 +191,10 @@ SMapValues SMap( std::string pathIn          = "./data/",
                  std::string smapFile        = "",
                  std::string jacobians       = "",
                  bool        embedded        = false,
-                 bool        verbose         = true );
+                 bool        verbose         = true,
+                 ExecutionContext exec = ExecutionContext() );
 
-SMapValues SMap( DataFrame< double >,
+SMapValues SMap( const DataFrameView< double > &,
                  std::string pathOut         = "./",
                  std::string predictFile     = "",
                  std::string lib             = "",
@@ -134,7 +209,45 @@ SMapValues SMap( DataFrame< double >,
                  std::string smapFile        = "",
                  std::string jacobians       = "",
                  bool        embedded        = false,
-                 bool        verbose         = true );
+                 bool        verbose         = true,
+                 ExecutionContext exec = ExecutionContext() );
+
+// float32 data: the SMap design matrix is solved in double
+SMapValues SMap( const DataFrameView< float > &,
+                 std::string pathOut         = "./",
+                 std::string predictFile     = "",
+                 std::string lib             = "",
+                 std::string pred            = "",
+                 int         E               = 0,
+                 int         Tp              = 1,
+                 int         knn             = 0,
+                 int         tau             = 1,
+                 double      theta           = 0,
+                 std::string columns         = "",
+                 std::string target          = "",
+                 std::string smapFile        = "",
+                 std::string jacobians       = "",
+                 bool        embedded        = false,
+                 bool        verbose         = true,
+                 ExecutionContext exec = ExecutionContext() );
+
+// Predictions and coefficients pushed to the sinks in blocks of rows
+// as they are projected, no output DataFrames are built
+void SMap( const DataFrameView< double > &,
+           ResultSink &predictionSink,
+           ResultSink *coefficientSink = nullptr,
+           std::string lib             = "",
+           std::string pred            = "",
+           int         E               = 0,
+           int         Tp              = 1,
+           int         knn             = 0,
+           int         tau             = 1,
+           double      theta           = 0,
+           std::string columns         = "",
+           std::string target          = "",
+           bool        embedded        = false,
+           bool        verbose         = true,
+           ExecutionContext exec = ExecutionContext() );
 
 DataFrame<double> CCM( std::string pathIn       = "./data/",
                        std::string dataFile     = "",
@@ -150,9 +263,10 @@ DataFrame<double> CCM( std::string pathIn       = "./data/",
                        int         sample       = 0,
                        bool        random       = true,
                        unsigned    seed         = 0,     // seed=0: use RNG
-                       bool        verbose      = true );
+                       bool        verbose      = true,
+                       ExecutionContext exec = ExecutionContext() );
 
-DataFrame<double> CCM( DataFrame< double >,
+DataFrame<double> CCM( const DataFrameView< double > &,
                        std::string pathOut      = "./",
                        std::string predictFile  = "",
                        int         E            = 0,
@@ -165,7 +279,25 @@ DataFrame<double> CCM( DataFrame< double >,
                        int         sample       = 0,
                        bool        random       = true,
                        unsigned    seed         = 0,     // seed=0: use RNG
-                       bool        verbose      = true );
+                       bool        verbose      = true,
+                       ExecutionContext exec = ExecutionContext() );
+
+// float32 data: embeddings and the distance matrix are float32
+DataFrame<double> CCM( const DataFrameView< float > &,
+                       std::string pathOut      = "./",
+                       std::string predictFile  = "",
+                       int         E            = 0,
+                       int         Tp           = 0,
+                       int         knn          = 0,
+                       int         tau          = 1,
+                       std::string colNames     = "",
+                       std::string targetName   = "",
+                       std::string libSizes_str = "",
+                       int         sample       = 0,
+                       bool        random       = true,
+                       unsigned    seed         = 0,     // seed=0: use RNG
+                       bool        verbose      = true,
+                       ExecutionContext exec = ExecutionContext() );
 
 DataFrame<double> EmbedDimension( std::string pathIn      = "./data/",
                                   std::string dataFile    = "",
@@ -179,9 +311,10 @@ DataFrame<double> EmbedDimension( std::string pathIn      = "./data/",
                                   std::string targetName  = "",
                                   bool        embedded    = false,
                                   bool        verbose     = true,
-                                  unsigned    nThreads    = 4 );
+                                  unsigned    nThreads    = 4,
+                                  ExecutionContext exec = ExecutionContext() );
 
-DataFrame<double> EmbedDimension( DataFrame< double >,
+DataFrame<double> EmbedDimension( const DataFrameView< double > &,
                                   std::string pathOut     = "./",
                                   std::string predictFile = "",
                                   std::string lib         = "",
@@ -192,7 +325,8 @@ DataFrame<double> EmbedDimension( DataFrame< double >,
                                   std::string targetName  = "",
                                   bool        embedded    = false,
                                   bool        verbose     = true,
-                                  unsigned    nThreads    = 4 );
+                                  unsigned    nThreads    = 4,
+                                  ExecutionContext exec = ExecutionContext() );
 
 DataFrame<double> PredictInterval( std::string pathIn      = "./data/",
                                    std::string dataFile    = "",
@@ -206,9 +340,10 @@ DataFrame<double> PredictInterval( std::string pathIn      = "./data/",
                                    std::string targetName  = "",
                                    bool        embedded    = false,
                                    bool        verbose     = true,
-                                   unsigned    nThreads    = 4 );
+                                   unsigned    nThreads    = 4,
+                                   ExecutionContext exec = ExecutionContext() );
 
-DataFrame<double> PredictInterval( DataFrame< double >,
+DataFrame<double> PredictInterval( const DataFrameView< double > &,
                                    std::string pathOut     = "./",
                                    std::string predictFile = "",
                                    std::string lib         = "",
@@ -219,7 +354,8 @@ DataFrame<double> PredictInterval( DataFrame< double >,
                                    std::string targetName  = "",
                                    bool        embedded    = false,
                                    bool        verbose     = true,
-                                   unsigned    nThreads    = 4 );
+                                   unsigned    nThreads    = 4,
+                                   ExecutionContext exec = ExecutionContext() );
 
 DataFrame<double> PredictNonlinear( std::string pathIn      = "./data/",
                                     std::string dataFile    = "",
@@ -234,9 +370,10 @@ DataFrame<double> PredictNonlinear( std::string pathIn      = "./data/",
                                     std::string targetName  = "",
                                     bool        embedded    = false,
                                     bool        verbose     = true,
-                                    unsigned    nThreads    = 4 );
+                                    unsigned    nThreads    = 4,
+                                    ExecutionContext exec = ExecutionContext() );
 
-DataFrame<double> PredictNonlinear( DataFrame< double >,
+DataFrame<double> PredictNonlinear( const DataFrameView< double > &,
                                     std::string pathOut     = "./",
                                     std::string predictFile = "",
                                     std::string lib         = "",
@@ -248,7 +385,173 @@ DataFrame<double> PredictNonlinear( DataFrame< double >,
                                     std::string targetName  = "",
                                     bool        embedded    = false,
                                     bool        verbose     = true,
-                                    unsigned    nThreads    = 4 );
+                                    unsigned    nThreads    = 4,
+                                    ExecutionContext exec = ExecutionContext() );
+
+// ParameterSweep(): Lists of E, Tp, tau, knn, theta. theta = "" : Simplex
+DataFrame<double> ParameterSweep( std::string pathIn      = "./data/",
+                                  std::string dataFile    = "",
+                                  std::string pathOut     = "./",
+                                  std::string predictFile = "",
+                                  std::string lib         = "",
+                                  std::string pred        = "",
+                                  std::string E           = "1 2 3 4 5",
+                                  std::string Tp          = "1",
+                                  std::string tau         = "1",
+                                  std::string knn         = "0",
+                                  std::string theta       = "",
+                                  std::string colNames    = "",
+                                  std::string targetName  = "",
+                                  bool        embedded    = false,
+                                  bool        verbose     = true,
+                                  ExecutionContext exec = ExecutionContext() );
+
+DataFrame<double> ParameterSweep( const DataFrameView< double > &,
+                                  std::string pathOut     = "./",
+                                  std::string predictFile = "",
+                                  std::string lib         = "",
+                                  std::string pred        = "",
+                                  std::string E           = "1 2 3 4 5",
+                                  std::string Tp          = "1",
+                                  std::string tau         = "1",
+                                  std::string knn         = "0",
+                                  std::string theta       = "",
+                                  std::string colNames    = "",
+                                  std::string targetName  = "",
+                                  bool        embedded    = false,
+                                  bool        verbose     = true,
+                                  ExecutionContext exec = ExecutionContext() );
+
+// ParameterSearch(): Successive halving over the ParameterSweep() grid
+SearchValues ParameterSearch( std::string pathIn      = "./data/",
+                              std::string dataFile    = "",
+                              std::string pathOut     = "./",
+                              std::string predictFile = "",
+                              std::string lib         = "",
+                              std::string pred        = "",
+                              std::string E           = "1 2 3 4 5",
+                              std::string Tp          = "1",
+                              std::string tau         = "1",
+                              std::string knn         = "0",
+                              std::string theta       = "",
+                              std::string colNames    = "",
+                              std::string targetName  = "",
+                              bool        embedded    = false,
+                              bool        verbose     = true,
+                              size_t      minRows     = 0,
+                              double      eta         = 2,
+                              ExecutionContext exec = ExecutionContext() );
+
+SearchValues ParameterSearch( const DataFrameView< double > &,
+                              std::string pathOut     = "./",
+                              std::string predictFile = "",
+                              std::string lib         = "",
+                              std::string pred        = "",
+                              std::string E           = "1 2 3 4 5",
+                              std::string Tp          = "1",
+                              std::string tau         = "1",
+                              std::string knn         = "0",
+                              std::string theta       = "",
+                              std::string colNames    = "",
+                              std::string targetName  = "",
+                              bool        embedded    = false,
+                              bool        verbose     = true,
+                              size_t      minRows     = 0,
+                              double      eta         = 2,
+                              ExecutionContext exec = ExecutionContext() );
+
+// RollingOrigin(): Expanding library, predRows predictions per fold
+RollingValues RollingOrigin( std::string pathIn      = "./data/",
+                             std::string dataFile    = "",
+                             std::string pathOut     = "./",
+                             std::string predictFile = "",
+                             std::string lib         = "",
+                             int         predRows    = 0,
+                             int         step        = 0,
+                             int         folds       = 0,
+                             Method      method      = Method::Simplex,
+                             int         E           = 0,
+                             int         Tp          = 1,
+                             int         knn         = 0,
+                             int         tau         = 1,
+                             double      theta       = 0,
+                             std::string colNames    = "",
+                             std::string targetName  = "",
+                             bool        embedded    = false,
+                             bool        verbose     = true,
+                             ExecutionContext exec = ExecutionContext() );
+
+RollingValues RollingOrigin( const DataFrameView< double > &,
+                             std::string pathOut     = "./",
+                             std::string predictFile = "",
+                             std::string lib         = "",
+                             int         predRows    = 0,
+                             int         step        = 0,
+                             int         folds       = 0,
+                             Method      method      = Method::Simplex,
+                             int         E           = 0,
+                             int         Tp          = 1,
+                             int         knn         = 0,
+                             int         tau         = 1,
+                             double      theta       = 0,
+                             std::string colNames    = "",
+                             std::string targetName  = "",
+                             bool        embedded    = false,
+                             bool        verbose     = true,
+                             ExecutionContext exec = ExecutionContext() );
+
+// SimplexBatch(): Simplex of the last predRows rows of many series
+DataFrame<double> SimplexBatch( std::string pathIn      = "./data/",
+                                std::string dataFile    = "",
+                                std::string pathOut     = "./",
+                                std::string predictFile = "",
+                                std::string columns     = "",
+                                int         predRows    = 1,
+                                int         E           = 0,
+                                int         Tp          = 1,
+                                int         knn         = 0,
+                                int         tau         = 1,
+                                ExecutionContext exec = ExecutionContext() );
+
+DataFrame<double> SimplexBatch( const DataFrameView< double > &,
+                                std::string pathOut     = "./",
+                                std::string predictFile = "",
+                                std::string columns     = "",
+                                int         predRows    = 1,
+                                int         E           = 0,
+                                int         Tp          = 1,
+                                int         knn         = 0,
+                                int         tau         = 1,
+                                ExecutionContext exec = ExecutionContext() );
+
+DataFrame<double> SimplexBatch(
+    const std::vector< std::valarray< double > > &series,
+    std::string      pathOut     = "./",
+    std::string      predictFile = "",
+    int              predRows    = 1,
+    int              E           = 0,
+    int              Tp          = 1,
+    int              knn         = 0,
+    int              tau         = 1,
+    ExecutionContext exec        = ExecutionContext() );
+
+// SimplexStream(): Simplex reading the data file in chunks of rows
+DataFrame<double> SimplexStream( std::string pathIn      = "./data/",
+                                 std::string dataFile    = "",
+                                 std::string pathOut     = "./",
+                                 std::string predictFile = "",
+                                 std::string lib         = "",
+                                 std::string pred        = "",
+                                 int         E           = 0,
+                                 int         Tp          = 1,
+                                 int         knn         = 0,
+                                 int         tau         = 1,
+                                 std::string colNames    = "",
+                                 std::string targetName  = "",
+                                 bool        embedded    = false,
+                                 bool        verbose     = true,
+                                 size_t      chunkRows   = 65536,
+                                 ExecutionContext exec = ExecutionContext() );
 
 MultiviewValues Multiview( std::string pathIn      = "./",
                            std::string dataFile    = "",
@@ -264,9 +567,10 @@ MultiviewValues Multiview( std::string pathIn      = "./",
                            std::string target      = "",
                            int         multiview   = 0,
                            bool        verbose     = false,
-                           unsigned    nThreads    = 4 );
+                           unsigned    nThreads    = 4,
+                           ExecutionContext exec = ExecutionContext() );
 
-MultiviewValues Multiview( DataFrame< double >,
+MultiviewValues Multiview( const DataFrameView< double > &,
                            std::string pathOut     = "./",
                            std::string predictFile = "",
                            std::string lib         = "",
@@ -279,5 +583,6 @@ MultiviewValues Multiview( DataFrame< double >,
                            std::string target      = "",
                            int         multiview   = 0,
                            bool        verbose     = false,
-                           unsigned    nThreads    = 4 );
+                           unsigned    nThreads    = 4,
+                           ExecutionContext exec = ExecutionContext() );
 #endif
@@ -11,33 +11,121 @@
 #include <iomanip>
 #include <fstream>
 #include <iterator>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 
 #include "Common.h"
+#include "DataIO.h"
 
 // Since #include DataFrame.h is in Common.h, need forward declaration
 extern std::vector<std::string> SplitString( std::string inString, 
                                              std::string delimeters = "," );
 extern bool OnlyDigits( std::string str );
 
-// Type definition for CSV NamedData to pair column names & column data
-typedef std::vector<std::pair<std::string, std::vector<double>>> NamedData;
+template <class T> class DataFrameView;
+
+//----------------------------------------------------------------
+// Order of DataFrame values: rows, or columns, are contiguous
+//----------------------------------------------------------------
+enum class DataFrameLayout { RowMajor, ColumnMajor };
+
+// Alignment of DataFrame storage, and the width rows of an aligned
+// DataFrame are padded to, in bytes
+const size_t DataFrameAlignment = 64;
+const size_t DataFrameSIMDWidth = 32;
+
+//----------------------------------------------------------------
+// Column names and name to column index map, shared by copies of
+// a DataFrame
+//----------------------------------------------------------------
+struct DataFrameNames {
+    std::vector< std::string >      columnNames;
+    std::map< std::string, size_t > columnNameToIndex;
+};
+
+// Names of DataFrames without column names
+inline std::shared_ptr< DataFrameNames > NoDataFrameNames() {
+    static std::shared_ptr< DataFrameNames > noNames =
+        std::make_shared< DataFrameNames >();
+    return noNames;
+}
+
+//----------------------------------------------------------------
+// Bytes of DataFrame values shared by copies, and bytes copied
+// when a shared DataFrame is first mutated or a view is copied
+//----------------------------------------------------------------
+struct DataFrameCopyCounts {
+    std::atomic< size_t > bytesShared;
+    std::atomic< size_t > bytesCopied;
+};
+
+inline DataFrameCopyCounts &DataFrameCopies() {
+    static DataFrameCopyCounts counts;
+    return counts;
+}
+
+//----------------------------------------------------------------
+// Transfer ReadCSV() values into DataFrame elements: moved for
+// DataFrame<double>, converted otherwise
+//----------------------------------------------------------------
+template <class T>
+void MoveElements( std::valarray<T> &elements, std::valarray<double> &values ) {
+    elements.resize( values.size() );
+    for ( size_t i = 0; i < values.size(); i++ ) {
+        elements[ i ] = values[ i ];
+    }
+}
+inline void MoveElements( std::valarray<double> &elements,
+                          std::valarray<double> &values ) {
+    elements = std::move( values );
+}
 
 //----------------------------------------------------------------
 // DataFrame class
-// Data container is a single, contiguous valarray.
+// Data container is a single, contiguous valarray, the values of
+// a memory mapped binary DataFrame file, or of an imported Arrow
+// array held in place.
 // DataFrame element access is through the () operator: (row,col).
+// Values are row-major, or column-major, see Layout(), ToLayout().
+// Rows (columns if column-major) of an aligned DataFrame start on a
+// DataFrameSIMDWidth boundary, padded with zeros, see Stride().
+//
+// Copies share the values and names (copy-on-write): the storage
+// of a shared DataFrame is copied by its first write. Reads of a
+// mutable DataFrame do not copy. Pointers from Write() are valid
+// until the next copy.
 //----------------------------------------------------------------
 template <class T>
 class DataFrame {
     
-    std::valarray<T> elements;
-    size_t           n_columns;
-    size_t           n_rows;
+    std::shared_ptr< std::valarray<T> > elements;
+    size_t                              n_columns;
+    size_t                              n_rows;
     
-    std::vector< std::string >      columnNames;
-    std::map< std::string, size_t > columnNameToIndex;
+    std::shared_ptr< DataFrameNames > names;
     
     size_t maxRowPrint;
+
+    // Values: elements, or the data block of a mapped binary file.
+    // Mapped pages are private to the process, writes are not
+    // carried to the file.
+    T                            *data;
+    std::shared_ptr< MappedFile > mapped;
+
+    // Holder of values in place in memory of another library, as an
+    // imported Arrow array. They are never written: copied first.
+    std::shared_ptr< const void > owner;
+
+    DataFrameLayout layout  = DataFrameLayout::RowMajor;
+    bool            aligned = false;
+    size_t          padding = 0;  // zeros after each row (column)
+
+    // Set once values, names are known not shared: Detach()
+    mutable std::atomic< bool > ownValues;
+    mutable std::atomic< bool > ownNames;
+    std::mutex                  detachMutex;
     
 public:
     //-----------------------------------------------------------------
@@ -48,33 +136,89 @@ public:
     //-----------------------------------------------------------------
     // Constructors
     //-----------------------------------------------------------------
-    DataFrame() {}
+    DataFrame() : n_columns( 0 ), n_rows( 0 ),
+                  names( NoDataFrameNames() ), maxRowPrint( 10 ),
+                  data( nullptr ), ownValues( true ), ownNames( false ) {}
     
     //-----------------------------------------------------------------
-    // Load data from CSV file path/fileName, populate DataFrame
+    // Load data from file path/fileName, populate DataFrame.
+    // A binary DataFrame file or a NumPy .npy file (see DataIO.h)
+    // is mapped: the values are used in place if the file dtype is
+    // T and rows are contiguous. The arrays of a NumPy .npz file
+    // are copied as columns. Otherwise the file is parsed as CSV.
+    //
+    // columns: whitespace delimited names. If given, only the first
+    // (time) column and these columns are loaded, in file order.
     //-----------------------------------------------------------------
-    DataFrame( std::string path, std::string fileName ):
-         maxRowPrint( 10 )
+    DataFrame( std::string path, std::string fileName,
+               std::string columns = "" ):
+         n_columns( 0 ), n_rows( 0 ), names( NoDataFrameNames() ),
+         maxRowPrint( 10 ), data( nullptr ), ownValues( true ),
+         ownNames( false )
     {
-        NamedData csvInput = ReadData (path, fileName);
-        SetupDataFrame (csvInput); // Process csvInput into a DataFrame
+        std::vector< std::string > colNames;
+        if ( columns.size() ) {
+            colNames = SplitString( columns, " \t,\n" );
+        }
+
+        std::shared_ptr< MappedFile > file =
+            std::make_shared< MappedFile >( path + fileName );
+
+        if ( IsBinaryFile( *file ) ) {
+            LoadBinary( ReadBinary( file, path + fileName ), colNames );
+            return;
+        }
+        if ( IsNpyFile( *file ) ) {
+            LoadBinary( ReadNpy( file, path + fileName ), colNames );
+            return;
+        }
+        if ( IsNpzFile( *file ) ) {
+            LoadColumns( ReadNpz( file, path + fileName ), colNames );
+            return;
+        }
+
+        CSVData csv = ReadCSV( *file, path + fileName, colNames );
+
+        n_rows    = csv.n_rows;
+        n_columns = csv.columnNames.size();
+        Names().columnNames = csv.columnNames;
+        BuildColumnNameIndex();
+
+        elements = std::make_shared< std::valarray<T> >();
+        MoveElements( *elements, csv.elements );
+        Own();
     }
     
     //-----------------------------------------------------------------
-    // Empty DataFrame of size (row, columns), no column names
+    // Empty DataFrame of size (row, columns), no column names.
+    // aligned: rows (columns if column-major) are padded, see Pad()
     //-----------------------------------------------------------------
-    DataFrame( size_t rows, size_t columns ):
-        n_rows( rows ), n_columns( columns ), elements( columns * rows ),
-        maxRowPrint( 10 ) {}
+    DataFrame( size_t          rows,
+               size_t          columns,
+               DataFrameLayout layout  = DataFrameLayout::RowMajor,
+               bool            aligned = false ):
+        n_rows( rows ), n_columns( columns ), names( NoDataFrameNames() ),
+        maxRowPrint( 10 ), layout( layout ), ownValues( true ),
+        ownNames( false )
+    {
+        if ( aligned ) {
+            Pad();
+        }
+        Allocate();
+    }
     
     //-----------------------------------------------------------------
     // Empty DataFrame of size (rows, columns) with column names in a
     // single whitespace delimited string. 
     //-----------------------------------------------------------------
     DataFrame( size_t rows, size_t columns, std::string colNames ):
-        n_rows( rows ), n_columns( columns ), elements( columns * rows ),
-        columnNames( std::vector<std::string>(columns) ), maxRowPrint( 10 )
+        n_rows( rows ), n_columns( columns ),
+        elements( std::make_shared< std::valarray<T> >( columns * rows ) ),
+        names( std::make_shared< DataFrameNames >() ), maxRowPrint( 10 ),
+        ownValues( true ), ownNames( true )
     {
+        names->columnNames = std::vector<std::string>( columns );
+        Own();
         BuildColumnNameIndex( colNames );
     }
     
@@ -84,40 +228,235 @@ public:
     //-----------------------------------------------------------------
     DataFrame( size_t rows, size_t columns,
                std::vector< std::string > columnNames ):
-        n_rows( rows ), n_columns( columns ), elements( columns * rows ),
-        columnNames( columnNames ), maxRowPrint( 10 )
+        n_rows( rows ), n_columns( columns ),
+        elements( std::make_shared< std::valarray<T> >( columns * rows ) ),
+        names( std::make_shared< DataFrameNames >() ), maxRowPrint( 10 ),
+        ownValues( true ), ownNames( true )
     {
+        names->columnNames = columnNames;
+        Own();
         BuildColumnNameIndex();
     }
+
+    //-----------------------------------------------------------------
+    // DataFrame of size (rows, columns) of row-major values in place
+    // in a mapped file, kept mapped by the DataFrame. No column names.
+    //-----------------------------------------------------------------
+    DataFrame( size_t rows, size_t columns, T *values,
+               std::shared_ptr< MappedFile > file ):
+        n_columns( columns ), n_rows( rows ), names( NoDataFrameNames() ),
+        maxRowPrint( 10 ), data( values ), mapped( file ),
+        ownValues( true ), ownNames( false ) {}
+
+    //-----------------------------------------------------------------
+    // DataFrame of size (rows, columns) of values in layout order
+    // held by owner. The values are read in place, copied by the
+    // first write. No column names.
+    //-----------------------------------------------------------------
+    DataFrame( size_t rows, size_t columns, const T *values,
+               std::shared_ptr< const void > owner,
+               DataFrameLayout               layout ):
+        n_columns( columns ), n_rows( rows ), names( NoDataFrameNames() ),
+        maxRowPrint( 10 ), data( const_cast< T * >( values ) ),
+        owner( owner ), layout( layout ), ownValues( false ),
+        ownNames( false ) {}
+
+    //-----------------------------------------------------------------
+    // Copy: values, names and a mapped file are shared, not copied
+    //-----------------------------------------------------------------
+    DataFrame( const DataFrame &D ):
+        elements( D.elements ), n_columns( D.n_columns ),
+        n_rows( D.n_rows ), names( D.names ),
+        maxRowPrint( D.maxRowPrint ), data( D.data ), mapped( D.mapped ),
+        owner( D.owner ), layout( D.layout ), aligned( D.aligned ),
+        padding( D.padding ),
+        ownValues( false ), ownNames( false )
+    {
+        D.ownValues = false;
+        D.ownNames  = false;
+        DataFrameCopies().bytesShared += size() * sizeof( T );
+    }
+
+    //-----------------------------------------------------------------
+    // Copy of the rows and columns of a view, with their names.
+    // Values of another type are converted, as float from double.
+    // aligned: row-major rows are padded, see Pad()
+    //-----------------------------------------------------------------
+    template <class U>
+    explicit DataFrame( const DataFrameView<U> &view, bool aligned = false );
+
+    template <class U>
+    explicit DataFrame( const DataFrame<U> &D ) : DataFrame( D.View() ) {}
+
+    DataFrame( DataFrame &&D ):
+        elements( std::move( D.elements ) ), n_columns( D.n_columns ),
+        n_rows( D.n_rows ), names( std::move( D.names ) ),
+        maxRowPrint( D.maxRowPrint ), data( D.data ),
+        mapped( std::move( D.mapped ) ), owner( std::move( D.owner ) ),
+        layout( D.layout ),
+        aligned( D.aligned ), padding( D.padding ),
+        ownValues( D.ownValues.load() ), ownNames( D.ownNames.load() )
+    {
+        D.n_rows    = 0;
+        D.n_columns = 0;
+        D.data      = nullptr;
+        D.names     = NoDataFrameNames();
+        D.ownValues = true;
+        D.ownNames  = false;
+    }
+
+    DataFrame &operator=( DataFrame D ) {
+        elements.swap( D.elements );
+        std::swap( n_columns, D.n_columns );
+        std::swap( n_rows,    D.n_rows    );
+        names.swap( D.names );
+        std::swap( maxRowPrint, D.maxRowPrint );
+        std::swap( data, D.data );
+        mapped.swap( D.mapped );
+        owner.swap( D.owner );
+        std::swap( layout, D.layout );
+        std::swap( aligned, D.aligned );
+        std::swap( padding, D.padding );
+        ownValues = D.ownValues.exchange( ownValues );
+        ownNames  = D.ownNames.exchange( ownNames );
+        return *this;
+    }
    
+    //-----------------------------------------------------------------
+    // Value of a mutable DataFrame, as T &: reads do not copy shared
+    // values, writes copy them first
+    //-----------------------------------------------------------------
+    class Reference {
+        DataFrame &frame;
+        size_t     index;
+    public:
+        Reference( DataFrame &frame, size_t index ) :
+            frame( frame ), index( index ) {}
+
+        operator T() const { return frame.data[ index ]; }
+
+        Reference &operator=( T value ) {
+            frame.Detach();
+            frame.data[ index ] = value;
+            return *this;
+        }
+        Reference &operator=( const Reference &R ) { return *this = T( R ); }
+
+        Reference &operator+=( T value ) { return *this = T( *this ) + value; }
+        Reference &operator-=( T value ) { return *this = T( *this ) - value; }
+        Reference &operator*=( T value ) { return *this = T( *this ) * value; }
+        Reference &operator/=( T value ) { return *this = T( *this ) / value; }
+    };
+
     //-----------------------------------------------------------------
     // Fortran style element access operators M(row,col)
     //-----------------------------------------------------------------
-    T &operator()( size_t row, size_t column ) {
-        return elements[ row * n_columns + column ];
+    Reference operator()( size_t row, size_t column ) {
+        return Reference( *this, Index( row, column ) );
     }
     T operator()( size_t row, size_t column ) const {
-        return elements[ row * n_columns + column ];
+        return data[ Index( row, column ) ];
+    }
+
+    // Value (row,col) to write through, and the values after it in
+    // Layout() order: shared values are copied first
+    T *Write( size_t row, size_t column ) {
+        Detach();
+        return data + Index( row, column );
+    }
+
+    // Offset of value (row,col) in Data()
+    size_t Index( size_t row, size_t column ) const {
+        return layout == DataFrameLayout::RowMajor ?
+            row    * ( n_columns + padding ) + column :
+            column * ( n_rows    + padding ) + row;
     }
 
     //-----------------------------------------------------------------
     // Member Accessors
     //-----------------------------------------------------------------
-    std::valarray<T>  Elements() const { return elements; }
-    std::valarray<T> &Elements()       { return elements; }
+    // Values in Layout() order, without padding
+    std::valarray<T> Elements() const {
+        if ( not padding ) {
+            return std::valarray<T>( data, size() );
+        }
+        std::valarray<T> values( size() );
+        for ( size_t i = 0; i < Outer(); i++ ) {
+            std::copy( data + i * Stride(), data + i * Stride() + Inner(),
+                       &values[ i * Inner() ] );
+        }
+        return values;
+    }
+    // Values of a mapped file or an owner, or of an aligned DataFrame,
+    // are first copied into unpadded elements
+    std::valarray<T> &Elements() {
+        Detach();
+        if ( mapped or owner or aligned or not elements ) {
+            elements = std::make_shared< std::valarray<T> >(
+                static_cast< const DataFrame & >( *this ).Elements() );
+            aligned = false;
+            padding = 0;
+            Own();
+        }
+        return *elements;
+    }
+    bool Mapped()  const { return mapped != nullptr; }
+    bool Aligned() const { return aligned; }
+
+    // Values in Layout() order, rows (columns) Stride() apart
+    const T *Data() const { return data; }
+
+    DataFrameLayout Layout() const { return layout; }
+
+    // Offset between rows, columns if column-major, of Data()
+    size_t Stride() const { return Inner() + padding; }
+
+    //-----------------------------------------------------------------
+    // DataFrame with the values in layout order, aligned and padded
+    // if aligned: shares the values if already so, else a copy
+    //-----------------------------------------------------------------
+    DataFrame ToLayout( DataFrameLayout toLayout,
+                        bool            toAligned = false ) const {
+        if ( toLayout == layout and toAligned == aligned ) {
+            return *this;
+        }
+        DataFrame D( n_rows, n_columns, toLayout, toAligned );
+        D.names       = names;
+        D.ownNames    = false;
+        ownNames      = false;
+        D.maxRowPrint = maxRowPrint;
+
+        // Contiguous writes
+        bool toRowMajor = toLayout == DataFrameLayout::RowMajor;
+        for ( size_t i = 0; i < D.Outer(); i++ ) {
+            T *out = D.data + i * D.Stride();
+            for ( size_t j = 0; j < D.Inner(); j++ ) {
+                out[ j ] = data[ toRowMajor ? Index( i, j ) : Index( j, i ) ];
+            }
+        }
+        DataFrameCopies().bytesCopied += size() * sizeof( T );
+        return D;
+    }
+
+    // Non-owning view of all rows and columns, see DataFrameView
+    DataFrameView<T> View() const { return DataFrameView<T>( *this ); }
     
     size_t NColumns() const { return n_columns; }
     size_t NRows()    const { return n_rows;    }
     size_t size()     const { return n_rows * n_columns; }
     
-    std::vector< std::string >  ColumnNames() const { return columnNames; }
-    std::vector< std::string > &ColumnNames()       { return columnNames; }
+    const std::vector< std::string > &ColumnNames() const {
+        return names->columnNames;
+    }
+    std::vector< std::string > &ColumnNames() {
+        return Names().columnNames;
+    }
     
-    std::map< std::string, size_t > ColumnNameToIndex() const {
-        return columnNameToIndex;
+    const std::map< std::string, size_t > &ColumnNameToIndex() const {
+        return names->columnNameToIndex;
     }
     std::map< std::string, size_t > &ColumnNameToIndex() {
-        return columnNameToIndex;
+        return Names().columnNameToIndex;
     }
 
     size_t  MaxRowPrint() const { return maxRowPrint; }
@@ -127,26 +466,38 @@ public:
     // Return column from index col
     //-----------------------------------------------------------------
     std::valarray<T> Column( size_t col ) const {
-        // slice (size_t start, size_t length, size_t stride)
-        return elements[ std::slice( col, n_rows, n_columns ) ];
+        if ( layout == DataFrameLayout::ColumnMajor ) {
+            return std::valarray<T>( data + col * Stride(), n_rows );
+        }
+        std::valarray<T> column( n_rows );
+        for ( size_t row = 0; row < n_rows; row++ ) {
+            column[ row ] = data[ row * Stride() + col ];
+        }
+        return column;
     }
 
     //-----------------------------------------------------------------
     // Return row from index row
     //-----------------------------------------------------------------
     std::valarray<T> Row( size_t row ) const {
-        // slice (size_t start, size_t length, size_t stride)
-        return elements[ std::slice( row * n_columns, n_columns, 1 ) ];
+        if ( layout == DataFrameLayout::RowMajor ) {
+            return std::valarray<T>( data + row * Stride(), n_columns );
+        }
+        std::valarray<T> rowValues( n_columns );
+        for ( size_t col = 0; col < n_columns; col++ ) {
+            rowValues[ col ] = data[ col * Stride() + row ];
+        }
+        return rowValues;
     }
 
     //------------------------------------------------------------------
     // Return data column selected by column name
     //------------------------------------------------------------------
-    std::valarray< double > VectorColumnName( std::string column ) {
+    std::valarray< double > VectorColumnName( std::string column ) const {
         
-        std::vector< std::string >::iterator ci = std::find(columnNames.begin(),
-                                                            columnNames.end(),
-                                                            column );
+        const std::vector< std::string > &columnNames = names->columnNames;
+        std::vector< std::string >::const_iterator ci =
+            std::find( columnNames.begin(), columnNames.end(), column );
         if ( ci == columnNames.end() ) {
             std::stringstream errMsg;
             errMsg << "DataFrame::VectorColumnName() Failed to find column: "
@@ -202,6 +553,8 @@ public:
     DataFrame< double > DataFrameFromColumnNames(
         std::vector<std::string> colNames ) {
 
+        const std::vector< std::string > &columnNames = names->columnNames;
+
         // vector of column indices for DataFrameFromColumnIndex()
         std::vector<size_t> col_i_vec;
         
@@ -257,8 +610,9 @@ public:
                    << n_rows << ". " << row << " was provided.\n";
             throw std::runtime_error( errMsg.str() );
         }
+        Detach();
         for ( size_t i = 0; i < N; i++ ) {
-            (*this)( row, i ) = array[ i ];
+            data[ Index( row, i ) ] = array[ i ];
         }
     }
 
@@ -280,8 +634,9 @@ public:
                    << n_columns << ". " << col << " was provided.\n";
             throw std::runtime_error( errMsg.str() );
         }
+        Detach();
         for ( size_t i = 0; i < N; i++ ) {
-            (*this)( i, col ) = array[ i ];
+            data[ Index( i, col ) ] = array[ i ];
         }
     }
 
@@ -289,6 +644,10 @@ public:
     // Build Column Name Index( std::string colNames )
     //-----------------------------------------------------------------
     void BuildColumnNameIndex( std::string colNames ) {
+        std::vector< std::string >      &columnNames = ColumnNames();
+        std::map< std::string, size_t > &columnNameToIndex =
+            ColumnNameToIndex();
+
         // If colNames provided populate columnNames, columnNameToIndex
         if ( colNames.size() ) {
             columnNames = SplitString( colNames, " ,\t" );
@@ -310,6 +669,10 @@ public:
     // Build Column Name Index
     //-----------------------------------------------------------------
     void BuildColumnNameIndex() {
+        std::vector< std::string >      &columnNames = ColumnNames();
+        std::map< std::string, size_t > &columnNameToIndex =
+            ColumnNameToIndex();
+
         // If columnNames provided, populate columnNameToIndex
         if ( columnNames.size() ) {
             if ( columnNames.size() != n_columns ) {
@@ -366,20 +729,15 @@ public:
     //  Write data to file
     //  @param outputFilePath: path to the file to write to
     //  @param outputFileName: filename to write to 
+    //  @param precision: decimals, or PrecisionRoundTrip, see CSVWriter
+    //  @param exec: rows are formatted in parallel on exec
     //  @return: none
     //------------------------------------------------------------------
-    void WriteData( std::string outputFilePath, std::string outputFileName ) {
+    void WriteData( std::string      outputFilePath,
+                    std::string      outputFileName,
+                    int              precision = 4,
+                    ExecutionContext exec      = ExecutionContext() ) {
         
-        // Vector of strings to hold image of DataFrame for file output
-        std::vector< std::string > fileLines;
-
-        // Stream to ingest each line (row) of the DataFrame
-        std::stringstream lineStr;
-
-        // Set stream precision. This should be a parameter.
-        lineStr.precision( 4 );
-        lineStr.setf( std::ios::fixed, std::ios::floatfield );
-
         // Create column name header if needed
         if ( ColumnNames().size() == 0 ) {
             std::cout << "DataFrame::WriteData(): This data frame has no column"
@@ -395,213 +753,524 @@ public:
                                       " column names does not match the number "
                                       " of data columns.\n" );
         }
-        
-        // Push column name from each column into the string stream
-        for ( size_t colIdx = 0; colIdx < n_columns; colIdx++ ) {
-            lineStr << ColumnNames()[ colIdx ];
 
-            if ( colIdx != n_columns - 1 ) {
-                lineStr << ",";
+        // Values are formatted into the writer buffer, written as it fills
+        CSVWriter writer( outputFilePath, outputFileName, precision );
+
+        DataFrame rowMajor;
+        writer.WriteHeader( ColumnNames() );
+        writer.WriteRows( RowMajorData( rowMajor ), n_rows, n_columns, exec );
+        writer.Close();
+    }
+
+    //------------------------------------------------------------------
+    //  Write data to a binary DataFrame file, see DataIO.h.
+    //  Values are written as float64, or float32 for DataFrame<float>.
+    //------------------------------------------------------------------
+    void WriteBinary( std::string outputFilePath,
+                      std::string outputFileName ) {
+
+        std::vector< std::string > colNames( names->columnNames );
+        if ( colNames.empty() ) {
+            for ( size_t i = 0; i < n_columns; i++ ) {
+                colNames.push_back( "V" + std::to_string( i ) );
             }
         }
 
-        // Push column name header into fileLines container
-        fileLines.push_back( lineStr.str() );
+        DataFrame rowMajor;
+        const T  *rowData = RowMajorData( rowMajor );
 
-        // Reset the stringstream content
-        lineStr.str( std::string() );
-
-        // Iterate through rows of numerical data
-        for ( size_t rowIdx = 0; rowIdx < n_rows; rowIdx++ ) {
-            for ( size_t colIdx = 0; colIdx < n_columns; colIdx++ ) {
+        if ( BinaryTraits<T>::native ) {
+            ::WriteBinary( outputFilePath, outputFileName, colNames,
+                           n_rows, n_columns, BinaryTraits<T>::dtype, rowData );
+        }
+        else {
+            std::valarray< double > values( size() );
+            for ( size_t i = 0; i < size(); i++ ) {
+                values[ i ] = rowData[ i ];
+            }
+            ::WriteBinary( outputFilePath, outputFileName, colNames,
+                           n_rows, n_columns, BinaryDType::Float64,
+                           size() ? &values[ 0 ] : nullptr );
+        }
+    }
 
-                lineStr << (*this) ( rowIdx, colIdx );
+    //------------------------------------------------------------------
+    //  Write data to a NumPy .npy file: a 2-D C ordered array of
+    //  float64, or float32 for DataFrame<float>. Column names are
+    //  not written.
+    //------------------------------------------------------------------
+    void WriteNpy( std::string outputFilePath,
+                   std::string outputFileName ) {
+        DataFrame rowMajor;
+        const T  *rowData = RowMajorData( rowMajor );
 
-                if ( colIdx != n_columns - 1 ) {
-                    lineStr << ",";
-                }
+        if ( BinaryTraits<T>::native ) {
+            ::WriteNpy( outputFilePath, outputFileName, n_rows, n_columns,
+                        BinaryTraits<T>::dtype, rowData );
+        }
+        else {
+            std::valarray< double > values( size() );
+            for ( size_t i = 0; i < size(); i++ ) {
+                values[ i ] = rowData[ i ];
             }
+            ::WriteNpy( outputFilePath, outputFileName, n_rows, n_columns,
+                        BinaryDType::Float64,
+                        size() ? &values[ 0 ] : nullptr );
+        }
+    }
+
+    //------------------------------------------------------------------
+    //  Write data to a NumPy .npz file: one 1-D array per column,
+    //  named by the column name, as numpy.savez()
+    //------------------------------------------------------------------
+    void WriteNpz( std::string outputFilePath,
+                   std::string outputFileName ) {
 
-            // Push row data into fileLines container
-            fileLines.push_back( lineStr.str() );
-            lineStr.str( std::string() );
+        std::vector< std::string > colNames( names->columnNames );
+        if ( colNames.empty() ) {
+            for ( size_t i = 0; i < n_columns; i++ ) {
+                colNames.push_back( "V" + std::to_string( i ) );
+            }
         }
 
-        // Write contents to file
-        std::ofstream outputFile( outputFilePath + outputFileName );
-    
-        if ( outputFile.is_open() ) {
-            
-            std::copy( fileLines.begin(), fileLines.end(),
-                       std::ostream_iterator<std::string>(outputFile,"\n") );
+        DataFrame rowMajor;
+        const T  *rowData = RowMajorData( rowMajor );
 
-            outputFile.close();
+        if ( BinaryTraits<T>::native ) {
+            ::WriteNpz( outputFilePath, outputFileName, colNames,
+                        n_rows, n_columns, BinaryTraits<T>::dtype, rowData );
         }
         else {
-            // Error in state of open() on outputFile
-            std::stringstream errMsg;
-            errMsg << "DataFrame::WriteData(): Failed to open file: "
-                << outputFilePath + outputFileName << ". \n";
-            throw std::runtime_error( errMsg.str() );
+            std::valarray< double > values( size() );
+            for ( size_t i = 0; i < size(); i++ ) {
+                values[ i ] = rowData[ i ];
+            }
+            ::WriteNpz( outputFilePath, outputFileName, colNames,
+                        n_rows, n_columns, BinaryDType::Float64,
+                        size() ? &values[ 0 ] : nullptr );
         }
     }
 
 private:
     //------------------------------------------------------------------
-    // Process csvInput to populate DataFrame
-    // @param csvInput from ReadData()
+    // Values are held in elements, from a DataFrameAlignment boundary
+    // if aligned
     //------------------------------------------------------------------
-    void SetupDataFrame ( NamedData csvInput ) {
-
-        // Setup column names in same order as dataFrame
-        std::vector< std::string > colNames;
-        for ( NamedData::iterator iterate = csvInput.begin(); 
-              iterate != csvInput.end(); iterate++ ) {
-            colNames.push_back( iterate->first );
+    void Own() {
+        data = elements and elements->size() ? &(*elements)[ 0 ] : nullptr;
+        if ( aligned and data ) {
+            uintptr_t address = reinterpret_cast< uintptr_t >( data );
+            size_t    offset  = ( DataFrameAlignment -
+                                  address % DataFrameAlignment ) %
+                                DataFrameAlignment;
+            data += offset / sizeof( T );
         }
-        
-        // setup DataFrame members
-        n_rows      = csvInput.begin()->second.size();
-        n_columns   = csvInput.size();
-        elements    = std::valarray <T> (n_rows * n_columns);
-        columnNames = colNames;
-        BuildColumnNameIndex();
+        mapped.reset();
+        owner.reset();
+    }
 
-        // Transfer each data value into the class valarray 
-        //    Another option is to use the writeColumn() method
-        // csvInput is : pair< string, vector<double> >
-        for ( NamedData::iterator iterate  = csvInput.begin(); 
-                                  iterate != csvInput.end(); iterate++ ) {
-            
-            size_t colIdx = std::distance( csvInput.begin(), iterate );
+    //------------------------------------------------------------------
+    // Zero filled elements for Outer() rows (columns) of Stride()
+    //------------------------------------------------------------------
+    void Allocate() {
+        size_t slack = aligned ? DataFrameAlignment / sizeof( T ) : 0;
+        elements = std::make_shared< std::valarray<T> >(
+            Outer() * Stride() + slack );
+        Own();
+    }
 
-            for ( size_t rowIdx = 0; rowIdx < n_rows; rowIdx++ ) {
-                (*this)( rowIdx, colIdx ) = iterate->second[ rowIdx ];
-            }
+    //------------------------------------------------------------------
+    // Align: pad rows (columns) to a multiple of DataFrameSIMDWidth
+    //------------------------------------------------------------------
+    void Pad() {
+        size_t width = std::max( DataFrameSIMDWidth / sizeof( T ),
+                                 (size_t) 1 );
+        aligned = true;
+        padding = ( width - Inner() % width ) % width;
+    }
+
+    // Rows and values per row, or columns and values per column
+    size_t Outer() const {
+        return layout == DataFrameLayout::RowMajor ? n_rows : n_columns;
+    }
+    size_t Inner() const {
+        return layout == DataFrameLayout::RowMajor ? n_columns : n_rows;
+    }
+
+    //------------------------------------------------------------------
+    // Unpadded row-major values: data, or of a copy into rowMajor
+    //------------------------------------------------------------------
+    const T *RowMajorData( DataFrame &rowMajor ) const {
+        if ( layout == DataFrameLayout::RowMajor and not padding ) {
+            return data;
         }
+        rowMajor = ToLayout( DataFrameLayout::RowMajor );
+        return rowMajor.data;
     }
-    
-    //----------------------------------------------------------------
-    // 
-    //----------------------------------------------------------------
-    NamedData ReadData( std::string path, std::string fileName ) {
-        
-        // Create input file stream and open file for input
-        std::ifstream dataStrm( path + fileName );
-        
-        // Ensure file access is good before reading
-        if ( not dataStrm.is_open() ) {
-            std::stringstream errMsg;
-            errMsg << "ERROR: DataFrame::ReadData() file " << path + fileName
-                   << " is not open for reading." << std::endl;
-            throw std::runtime_error( errMsg.str() );
+
+    //------------------------------------------------------------------
+    // Copy shared values before they are mutated. Concurrent mutable
+    // access of one shared DataFrame copies once.
+    //------------------------------------------------------------------
+    void Detach() {
+        if ( not ownValues.load( std::memory_order_acquire ) ) {
+            DetachValues();
         }
-        if ( not dataStrm.good() ) {
-            std::stringstream errMsg;
-            errMsg << "ERROR: DataFrame::ReadData() file " << path + fileName
-                   << " is not ready for reading." << std::endl;
-            throw std::runtime_error( errMsg.str() );
+    }
+
+    void DetachValues() {
+        std::lock_guard< std::mutex > lock( detachMutex );
+        if ( ownValues.load( std::memory_order_relaxed ) ) {
+            return;
         }
-        
-        // Read fileName into a vector of strings, one line per string
-        std::vector< std::string > dataLines;
-        std::string tmp;
-        
-        while( getline( dataStrm, tmp ) ) {
-            dataLines.push_back( tmp );
+        if ( ( elements and elements.use_count() > 1 ) or
+             ( mapped   and mapped.use_count()   > 1 ) or owner ) {
+            const T *values = data;
+            Allocate();
+            std::copy( values, values + Outer() * Stride(), data );
+            DataFrameCopies().bytesCopied += size() * sizeof( T );
         }
-        dataStrm.close();
-        
-#ifdef DEBUG_ALL
-        std::cout << "------- ReadData() Contents of file "
-                  << fileName << " -------" << std::endl;
-        for( std::vector< std::string >::iterator ci = dataLines.begin();
-             ci != dataLines.end(); ++ci ) {
-            std::cout << *ci << std::endl;
+        ownValues.store( true, std::memory_order_release );
+    }
+
+    // Names, copied first if shared
+    DataFrameNames &Names() {
+        if ( not ownNames.load( std::memory_order_acquire ) ) {
+            std::lock_guard< std::mutex > lock( detachMutex );
+            if ( not ownNames.load( std::memory_order_relaxed ) ) {
+                if ( names.use_count() > 1 ) {
+                    names = std::make_shared< DataFrameNames >( *names );
+                }
+                ownNames.store( true, std::memory_order_release );
+            }
         }
-#endif
-        
-        // Container for data names/vectors
-        NamedData namedData; // pair< string, vector< double >> NamedData;
-        
-        // Container of column names in the same order as in csv file
-        std::vector< std::string > colNames;
+        return *names;
+    }
 
-        // Check first line to see if it's only numeric digits, or a header
-        bool onlyDigits = true;
-        std::vector<std::string> firstLineWords = SplitString( dataLines[0] );
-        
-        for ( auto si =  firstLineWords.begin();
-                   si != firstLineWords.end(); ++si ){
+    //------------------------------------------------------------------
+    // Use the values of a mapped binary file in place, or convert
+    // them into elements. colNames: as DataFrame( path, fileName,
+    // columns ), empty for all columns.
+    //------------------------------------------------------------------
+    void LoadBinary( BinaryData                        binary,
+                     const std::vector< std::string > &colNames ) {
 
-            onlyDigits = OnlyDigits( *si );
-            
-            if ( not onlyDigits ) { break; }
+        // File columns: 0 and colNames in file order
+        std::vector< size_t > fileColumns;
+        std::vector< bool >   keep( binary.n_columns, colNames.empty() );
+        if ( binary.n_columns ) { keep[ 0 ] = true; }
+
+        for ( auto ci = colNames.begin(); ci != colNames.end(); ++ci ) {
+            auto si = std::find( binary.columnNames.begin(),
+                                 binary.columnNames.end(), *ci );
+            if ( si == binary.columnNames.end() ) {
+                std::stringstream errMsg;
+                errMsg << "DataFrame(): Failed to find column " << *ci
+                       << " in binary DataFrame file." << std::endl;
+                throw std::runtime_error( errMsg.str() );
+            }
+            keep[ std::distance( binary.columnNames.begin(), si ) ] = true;
         }
-        if ( onlyDigits ) {
-            // create named columns with generic col names: V1, V2...
-            for (size_t colIdx = 0; colIdx < firstLineWords.size(); colIdx++){
-                colNames.push_back( "V" + std::to_string(colIdx) );
+
+        std::vector< std::string > &columnNames = ColumnNames();
+        columnNames.clear();
+        for ( size_t col = 0; col < binary.n_columns; col++ ) {
+            if ( keep[ col ] ) {
+                fileColumns.push_back( col );
+                columnNames.push_back( binary.columnNames[ col ] );
             }
         }
-        else {
-            // get named columns from header line
-            for (size_t colIdx = 0; colIdx < firstLineWords.size(); colIdx++){
-                colNames.push_back( firstLineWords[colIdx] );  
+
+        n_rows    = binary.n_rows;
+        n_columns = fileColumns.size();
+        BuildColumnNameIndex();
+
+        bool rowMajor = binary.layout == BinaryLayout::RowMajor;
+
+        if ( BinaryTraits<T>::native and
+             binary.dtype  == BinaryTraits<T>::dtype and
+             n_columns     == binary.n_columns and
+             reinterpret_cast< uintptr_t >( binary.data ) % alignof( T )
+             == 0 ) {
+            data   = reinterpret_cast< T * >( binary.data );
+            mapped = binary.file;
+            layout = rowMajor ? DataFrameLayout::RowMajor :
+                                DataFrameLayout::ColumnMajor;
+            return;
+        }
+
+        elements = std::make_shared< std::valarray<T> >( n_rows * n_columns );
+        Own();
+
+        for ( size_t row = 0; row < n_rows; row++ ) {
+            for ( size_t col = 0; col < n_columns; col++ ) {
+                size_t fileCol = fileColumns[ col ];
+                size_t i = rowMajor ? row * binary.n_columns + fileCol :
+                                      fileCol * n_rows       + row;
+                (*this)( row, col ) = BinaryValue( binary, i );
             }
-            // remove header line from read in lines so only numerical after
-            dataLines.erase( dataLines.begin() );
         }
-        
-        // setup each col in namedData with new vec to insert numerical data to
-        for ( size_t colIdx = 0; colIdx < colNames.size(); colIdx++ ) {
-            NamedData::value_type colPair ( colNames[colIdx],
-                                            std::vector<double>());
-            namedData.push_back ( colPair );
+    }
+
+    //------------------------------------------------------------------
+    // Columns of one column arrays (.npz file) converted into
+    // elements. colNames: as LoadBinary().
+    //------------------------------------------------------------------
+    void LoadColumns( const std::vector< BinaryData >  &arrays,
+                      const std::vector< std::string > &colNames ) {
+
+        std::vector< const BinaryData * > keep;
+        for ( size_t col = 0; col < arrays.size(); col++ ) {
+            if ( col == 0 or colNames.empty() or
+                 std::find( colNames.begin(), colNames.end(),
+                            arrays[ col ].columnNames[ 0 ] ) !=
+                 colNames.end() ) {
+                keep.push_back( &arrays[ col ] );
+            }
+        }
+        for ( auto ci = colNames.begin(); ci != colNames.end(); ++ci ) {
+            auto found = std::find_if( arrays.begin(), arrays.end(),
+                [&]( const BinaryData &array ) {
+                    return array.columnNames[ 0 ] == *ci; } );
+            if ( found == arrays.end() ) {
+                std::stringstream errMsg;
+                errMsg << "DataFrame(): Failed to find column " << *ci
+                       << " in .npz file." << std::endl;
+                throw std::runtime_error( errMsg.str() );
+            }
         }
-        
-        // Process each line in dataLines to fill in data vectors
-        for ( size_t lineIdx = 0; lineIdx < dataLines.size(); lineIdx++ ) {
-            std::vector<std::string> words = SplitString(dataLines[ lineIdx ]);
 
-            if ( words.size() != colNames.size() ) {
+        n_rows    = keep.size() ? keep[ 0 ]->n_rows : 0;
+        n_columns = keep.size();
+
+        std::vector< std::string > &columnNames = ColumnNames();
+        columnNames.clear();
+        for ( size_t col = 0; col < n_columns; col++ ) {
+            if ( keep[ col ]->n_rows != n_rows ) {
                 std::stringstream errMsg;
-                errMsg << "ERROR: DataFrame::ReadData() Line " << lineIdx + 1
-                       << " of file " << path + fileName
-                       << " does not have " << colNames.size()
-                       << " columns of data." << std::endl;
+                errMsg << "DataFrame(): .npz array "
+                       << keep[ col ]->columnNames[ 0 ] << " has "
+                       << keep[ col ]->n_rows << " rows, "
+                       << keep[ 0 ]->columnNames[ 0 ] << " has "
+                       << n_rows << "." << std::endl;
                 throw std::runtime_error( errMsg.str() );
             }
-            
-            try {
-                for ( size_t colIdx = 0; colIdx < colNames.size(); colIdx++ ) {
-                    namedData[ colIdx ].second.push_back(
-                        std::stod( words[ colIdx ] ) );
-                }
+            columnNames.push_back( keep[ col ]->columnNames[ 0 ] );
+        }
+        BuildColumnNameIndex();
+
+        elements = std::make_shared< std::valarray<T> >( n_rows * n_columns );
+        Own();
+
+        for ( size_t col = 0; col < n_columns; col++ ) {
+            for ( size_t row = 0; row < n_rows; row++ ) {
+                (*this)( row, col ) = BinaryValue( *keep[ col ], row );
             }
-            catch ( const std::exception& e ) {
-                std::cout << "DataFrame ReadData() Exception:\n";
-                std::cout << e.what() << std::endl;
-                throw std::runtime_error( e.what() );
+        }
+    }
+
+    //------------------------------------------------------------------
+    // Value i of a file data block, which need not be aligned
+    //------------------------------------------------------------------
+    static T BinaryValue( const BinaryData &binary, size_t i ) {
+        if ( binary.dtype == BinaryDType::Float32 ) {
+            float value;
+            memcpy( &value, binary.data + i * sizeof( float ),
+                    sizeof( float ) );
+            return value;
+        }
+        double value;
+        memcpy( &value, binary.data + i * sizeof( double ),
+                sizeof( double ) );
+        return value;
+    }
+};
+
+//----------------------------------------------------------------
+// DataFrameView class
+// Non-owning, read-only view of a row range and a selection of the
+// columns of a DataFrame. Element access is through the () operator:
+// (row,col), as DataFrame.
+//
+// A view of a whole DataFrame, and Rows() of a view, are O(1) and
+// do not allocate. Columns() stores the selected column indices.
+// Values are not copied: the DataFrame must outlive the view and
+// must not be reassigned while the view is used.
+//----------------------------------------------------------------
+template <class T>
+class DataFrameView {
+
+    const DataFrame<T>   *frame;       // column names
+    const T              *values;      // first row of the view
+    size_t                n_rows;
+    size_t                n_columns;
+    size_t                rowStride;   // offset of the next row
+    size_t                columnStride;
+    std::vector< size_t > columnIndex; // frame columns, empty: all
+
+public:
+    //-----------------------------------------------------------------
+    // Constructors: a DataFrame converts to a view of all its values
+    //-----------------------------------------------------------------
+    DataFrameView() : frame( nullptr ), values( nullptr ), n_rows( 0 ),
+                      n_columns( 0 ), rowStride( 0 ), columnStride( 0 ) {}
+
+    DataFrameView( const DataFrame<T> &D ) :
+        frame( &D ), values( D.Data() ), n_rows( D.NRows() ),
+        n_columns( D.NColumns() ), rowStride( D.Index( 1, 0 ) ),
+        columnStride( D.Index( 0, 1 ) ) {}
+
+    //-----------------------------------------------------------------
+    // Element access V(row,col)
+    //-----------------------------------------------------------------
+    T operator()( size_t row, size_t column ) const {
+        return values[ row * rowStride + FrameColumn( column ) * columnStride ];
+    }
+
+    size_t NColumns() const { return n_columns; }
+    size_t NRows()    const { return n_rows;    }
+    size_t size()     const { return n_rows * n_columns; }
+
+    // Column of the viewed DataFrame
+    size_t FrameColumn( size_t column ) const {
+        return columnIndex.empty() ? column : columnIndex[ column ];
+    }
+
+    //-----------------------------------------------------------------
+    // Names of the view columns, empty if the DataFrame has none
+    //-----------------------------------------------------------------
+    std::vector< std::string > ColumnNames() const {
+        std::vector< std::string > names;
+        if ( not frame or frame->ColumnNames().empty() ) {
+            return names;
+        }
+        const std::vector< std::string > &frameNames = frame->ColumnNames();
+        for ( size_t col = 0; col < n_columns; col++ ) {
+            names.push_back( frameNames[ FrameColumn( col ) ] );
+        }
+        return names;
+    }
+
+    //-----------------------------------------------------------------
+    // View column index of column name
+    //-----------------------------------------------------------------
+    size_t ColumnIndex( std::string column ) const {
+        std::vector< std::string > names = ColumnNames();
+        std::vector< std::string >::iterator ci =
+            std::find( names.begin(), names.end(), column );
+
+        if ( ci == names.end() ) {
+            std::stringstream errMsg;
+            errMsg << "DataFrameView::ColumnIndex() Failed to find column: "
+                   << column << " in DataFrame columns:\n[ ";
+            for ( auto cni = names.begin(); cni != names.end(); ++cni ) {
+                errMsg << *cni << " ";
+            } errMsg << "]" << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+        return std::distance( names.begin(), ci );
+    }
+
+    //-----------------------------------------------------------------
+    // Views: rows [start, start + count), and a column selection
+    //-----------------------------------------------------------------
+    DataFrameView Rows( size_t start, size_t count ) const {
+        if ( start + count > n_rows ) {
+            std::stringstream errMsg;
+            errMsg << "DataFrameView::Rows(): rows [" << start << ", "
+                   << start + count << ") exceed the " << n_rows
+                   << " rows of the view.\n";
+            throw std::runtime_error( errMsg.str() );
+        }
+        DataFrameView view( *this );
+        view.values = values + start * rowStride;
+        view.n_rows = count;
+        return view;
+    }
+
+    DataFrameView Columns( const std::vector< size_t > &columns ) const {
+        DataFrameView view( *this );
+        view.columnIndex.resize( columns.size() );
+        view.n_columns = columns.size();
+
+        for ( size_t i = 0; i < columns.size(); i++ ) {
+            if ( columns[ i ] >= n_columns ) {
+                std::stringstream errMsg;
+                errMsg << "DataFrameView::Columns(): A column index ("
+                       << columns[ i ] << ") exceeds the "
+                       << n_columns << " columns of the view.\n";
+                throw std::runtime_error( errMsg.str() );
             }
+            view.columnIndex[ i ] = FrameColumn( columns[ i ] );
         }
+        return view;
+    }
+
+    DataFrameView Columns( const std::vector< std::string > &columns ) const {
+        std::vector< size_t > col_i;
+        for ( auto ci = columns.begin(); ci != columns.end(); ++ci ) {
+            col_i.push_back( ColumnIndex( *ci ) );
+        }
+        return Columns( col_i );
+    }
+
+    //-----------------------------------------------------------------
+    // Values of column col, rows RowStride() apart
+    //-----------------------------------------------------------------
+    const T *ColumnData( size_t col ) const {
+        return values + FrameColumn( col ) * columnStride;
+    }
+    size_t RowStride() const { return rowStride; }
 
-#ifdef DEBUG_ALL
-        std::cout << "------- ReadData() data from "
-                  << fileName << " -------" << std::endl;
-        for ( auto ci = namedData.begin(); ci != namedData.end(); ++ci ) {
-            std::cout << ci->first << " ";
-        } std::cout << std::endl;
+    //-----------------------------------------------------------------
+    // Copies of a column or row
+    //-----------------------------------------------------------------
+    std::valarray<T> Column( size_t col ) const {
+        std::valarray<T> column( n_rows );
+        const T *value = values + FrameColumn( col ) * columnStride;
+        for ( size_t row = 0; row < n_rows; row++ ) {
+            column[ row ] = value[ row * rowStride ];
+        }
+        return column;
+    }
 
-        for (size_t row = 0; row < (namedData.begin()->second).size(); row++){
-            for ( auto ci = namedData.begin(); ci != namedData.end(); ++ci ) {
-                std::vector< double > vec = ci->second;
-                std::cout << vec[ row ] << " ";
-            } std::cout << std::endl;
+    std::valarray<T> Row( size_t row ) const {
+        std::valarray<T> rowValues( n_columns );
+        for ( size_t col = 0; col < n_columns; col++ ) {
+            rowValues[ col ] = (*this)( row, col );
         }
-#endif
-        
-        return namedData;
+        return rowValues;
+    }
+
+    std::valarray<T> VectorColumnName( std::string column ) const {
+        return Column( ColumnIndex( column ) );
     }
 };
+
+//-----------------------------------------------------------------
+// DataFrame of the view values
+//-----------------------------------------------------------------
+template <class T>
+template <class U>
+DataFrame<T>::DataFrame( const DataFrameView<U> &view, bool aligned ) :
+    n_columns( view.NColumns() ), n_rows( view.NRows() ),
+    names( std::make_shared< DataFrameNames >() ), maxRowPrint( 10 ),
+    ownValues( true ), ownNames( true )
+{
+    if ( aligned ) {
+        Pad();
+    }
+    Allocate();
+    names->columnNames = view.ColumnNames();
+    BuildColumnNameIndex();
+    DataFrameCopies().bytesCopied += size() * sizeof( T );
+
+    for ( size_t row = 0; row < n_rows; row++ ) {
+        T *out = data + row * Stride();
+        for ( size_t col = 0; col < n_columns; col++ ) {
+            out[ col ] = static_cast< T >( view( row, col ) );
+        }
+    }
+}
 #endif
@@ -0,0 +1,1127 @@
+
+#include <cstring>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Common.h"
+#include "DataIO.h"
+
+//----------------------------------------------------------------
+// Map fileName, private to this process
+//----------------------------------------------------------------
+MappedFile::MappedFile( std::string fileName ) :
+    data( nullptr ), size( 0 ), mapped( false )
+{
+    int fd = open( fileName.c_str(), O_RDONLY );
+
+    if ( fd < 0 ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: MappedFile() file " << fileName
+               << " is not open for reading." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    struct stat fileStat;
+    if ( fstat( fd, &fileStat ) != 0 or not S_ISREG( fileStat.st_mode ) ) {
+        close( fd );
+        std::stringstream errMsg;
+        errMsg << "ERROR: MappedFile() file " << fileName
+               << " is not ready for reading." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    size = fileStat.st_size;
+
+    if ( size ) {
+        void *map = mmap( nullptr, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE, fd, 0 );
+
+        if ( map != MAP_FAILED ) {
+            madvise( map, size, MADV_SEQUENTIAL );
+            data   = static_cast< char * >( map );
+            mapped = true;
+        }
+        else {
+            // Read the file instead
+            buffer.resize( size );
+            size_t nRead = 0;
+            while ( nRead < size ) {
+                ssize_t n = read( fd, buffer.data() + nRead, size - nRead );
+                if ( n <= 0 ) { break; }
+                nRead += n;
+            }
+            size = nRead;
+            data = buffer.data();
+        }
+    }
+
+    close( fd );
+}
+
+//----------------------------------------------------------------
+MappedFile::~MappedFile() {
+    if ( mapped ) {
+        munmap( data, size );
+    }
+}
+
+namespace EDM_DataIO {
+    // Bytes of CSV text parsed by one task
+    const size_t chunkBytes = 1 << 20;
+
+    // Binary DataFrame file
+    const char     binaryMagic[ 8 ] = { 'c','p','p','E','D','M','D','F' };
+    const uint32_t byteOrder        = 0x01020304;
+
+    //------------------------------------------------------------
+    // Fixed part of the binary DataFrame header
+    //------------------------------------------------------------
+    struct BinaryHeader {
+        char     magic[ 8 ];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t dtype;
+        uint32_t layout;
+        uint64_t n_rows;
+        uint64_t n_columns;
+        uint64_t alignment;
+        uint64_t dataOffset;
+    };
+
+    size_t DTypeSize( BinaryDType dtype ) {
+        return dtype == BinaryDType::Float32 ? sizeof( float ) :
+                                               sizeof( double );
+    }
+
+    //------------------------------------------------------------
+    // Count lines in [begin, end) as getline(): a final line
+    // without a newline counts
+    //------------------------------------------------------------
+    size_t CountLines( const char *begin, const char *end ) {
+        size_t nLines = 0;
+        const char *p = begin;
+        while ( p < end ) {
+            const char *nl = static_cast< const char * >(
+                memchr( p, '\n', end - p ) );
+            nLines++;
+            if ( not nl ) { break; }
+            p = nl + 1;
+        }
+        return nLines;
+    }
+
+    //------------------------------------------------------------
+    // Exact conversion of a plain decimal token: at most 15
+    // significant digits scaled by 10^e, |e| <= 22, are both exact
+    // doubles so one multiply or divide rounds correctly. Returns
+    // false for other tokens, which are left to strtod().
+    //------------------------------------------------------------
+    bool FastDecimal( const char *str, double &value ) {
+        static const double pow10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,
+            1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+            1e18, 1e19, 1e20, 1e21, 1e22 };
+
+        const char *p = str;
+        bool negative = false;
+        if ( *p == '-' or *p == '+' ) { negative = *p++ == '-'; }
+
+        unsigned long long mantissa = 0;
+        int  N_digits = 0;
+        int  exponent = 0;
+        bool digits   = false;
+
+        for ( ; *p >= '0' and *p <= '9'; p++ ) {
+            digits = true;
+            if ( N_digits or *p != '0' ) {
+                if ( ++N_digits > 15 ) { return false; }
+                mantissa = mantissa * 10 + ( *p - '0' );
+            }
+        }
+        if ( *p == '.' ) {
+            for ( p++; *p >= '0' and *p <= '9'; p++ ) {
+                digits = true;
+                if ( N_digits or *p != '0' ) {
+                    if ( ++N_digits > 15 ) { return false; }
+                    mantissa = mantissa * 10 + ( *p - '0' );
+                }
+                exponent--;
+            }
+        }
+        if ( not digits ) { return false; }
+
+        if ( *p == 'e' or *p == 'E' ) {
+            p++;
+            bool negativeExp = false;
+            if ( *p == '-' or *p == '+' ) { negativeExp = *p++ == '-'; }
+            if ( *p < '0' or *p > '9' ) { return false; }
+            int exp = 0;
+            for ( ; *p >= '0' and *p <= '9'; p++ ) {
+                if ( exp > 1000 ) { return false; }
+                exp = exp * 10 + ( *p - '0' );
+            }
+            exponent += negativeExp ? -exp : exp;
+        }
+        if ( *p != '\0' or exponent < -22 or exponent > 22 ) {
+            return false;
+        }
+
+        value = (double) mantissa;
+        value = exponent < 0 ? value / pow10[ -exponent ] :
+                               value * pow10[  exponent ];
+        if ( negative ) { value = -value; }
+        return true;
+    }
+
+    //------------------------------------------------------------
+    // Parse the comma delimited numbers of the line [begin, end)
+    // into values. Tokens follow SplitString(): empty tokens are
+    // skipped, whitespace within a token is removed.
+    // Token i is written to values[ slot[ i ] ], or values[ i ] if
+    // slot is nullptr. Tokens with slot[ i ] < 0 are not parsed.
+    // Returns the number of tokens, tokens beyond N_columns are
+    // not written. Sets errMsg on a token that is not a number.
+    //------------------------------------------------------------
+    size_t ParseLine( const char  *begin,
+                      const char  *end,
+                      double      *values,
+                      size_t       N_columns,
+                      const long  *slot,
+                      std::string &errMsg )
+    {
+        char   token[ 64 ];
+        size_t N_tokens = 0;
+
+        const char *p = begin;
+        while ( p < end ) {
+            const char *q = static_cast< const char * >(
+                memchr( p, ',', end - p ) );
+            if ( not q ) { q = end; }
+
+            if ( q > p ) {
+                long value_i = N_tokens;
+                if ( slot and N_tokens < N_columns ) {
+                    value_i = slot[ N_tokens ];
+                }
+
+                if ( N_tokens < N_columns and value_i >= 0 ) {
+                    // Token without whitespace for strtod()
+                    std::string longToken;
+                    size_t      n = 0;
+                    for ( const char *c = p; c < q; c++ ) {
+                        if ( isspace( static_cast< unsigned char >( *c ) ) ) {
+                            continue;
+                        }
+                        if ( n < sizeof( token ) - 1 ) {
+                            token[ n++ ] = *c;
+                        }
+                        else {
+                            longToken.push_back( *c );
+                        }
+                    }
+                    token[ n ] = '\0';
+
+                    const char *str = token;
+                    if ( longToken.size() ) {
+                        longToken.insert( 0, token );
+                        str = longToken.c_str();
+                    }
+
+                    double value;
+                    if ( not FastDecimal( str, value ) ) {
+                        char *parseEnd;
+                        value = strtod( str, &parseEnd );
+
+                        if ( parseEnd == str ) {
+                            errMsg = "invalid number '" +
+                                     std::string( p, q ) + "'";
+                            return N_tokens;
+                        }
+                    }
+                    values[ value_i ] = value;
+                }
+                N_tokens++;
+            }
+            p = q + 1;
+        }
+        return N_tokens;
+    }
+
+    //------------------------------------------------------------
+    // Column names of a CSV file from its first line.
+    // Returns true if the line is a header, false if all its
+    // tokens are digits: columns are then named V0, V1, ...
+    //------------------------------------------------------------
+    bool ParseHeader( const std::string          &firstLine,
+                      std::vector< std::string > &columnNames )
+    {
+        std::vector< std::string > firstLineWords = SplitString( firstLine );
+
+        bool onlyDigits = true;
+        for ( auto si  = firstLineWords.begin();
+                   si != firstLineWords.end(); ++si ) {
+            onlyDigits = OnlyDigits( *si );
+            if ( not onlyDigits ) { break; }
+        }
+
+        columnNames.clear();
+        if ( onlyDigits ) {
+            for ( size_t col = 0; col < firstLineWords.size(); col++ ) {
+                columnNames.push_back( "V" + std::to_string( col ) );
+            }
+        }
+        else {
+            columnNames = firstLineWords;
+        }
+        return not onlyDigits;
+    }
+
+    //------------------------------------------------------------
+    // Bytes of one formatted value: 309 integer digits of DBL_MAX,
+    // sign, point and up to maxPrecision decimals
+    //------------------------------------------------------------
+    const int    maxPrecision  = 40;
+    const size_t maxValueChars = 360;
+
+    //------------------------------------------------------------
+    // value as printf( "%.*f", precision, value ) into out,
+    // returns the number of chars. Values with at most 15 decimals
+    // and less than 2^53 units of the last decimal are scaled and
+    // rounded to an integer: the product is within one rounding of
+    // the exact scaled value, so the rounding is exact unless the
+    // fraction is that close to a half. Such values, -0 results and
+    // all others are left to snprintf().
+    //------------------------------------------------------------
+    size_t FormatFixed( double value, int precision, char *out ) {
+        static const double pow10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,
+            1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+        static const uint64_t ipow10[] = {
+            1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+            1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+            10000000000ULL, 100000000000ULL, 1000000000000ULL,
+            10000000000000ULL, 100000000000000ULL, 1000000000000000ULL };
+
+        if ( precision <= 15 and std::isfinite( value ) ) {
+            double scaled = std::fabs( value ) * pow10[ precision ];
+
+            if ( scaled < 9007199254740992.0 ) {
+                double whole    = std::floor( scaled );
+                double fraction = scaled - whole;
+
+                uint64_t units = (uint64_t) whole + ( fraction > 0.5 );
+
+                if ( std::fabs( fraction - 0.5 ) > scaled * 2.3E-16 and
+                     not ( units == 0 and std::signbit( value ) ) ) {
+
+                    char *p = out;
+                    if ( std::signbit( value ) ) { *p++ = '-'; }
+
+                    uint64_t integer  = units / ipow10[ precision ];
+                    uint64_t decimals = units % ipow10[ precision ];
+
+                    char digits[ 20 ];
+                    int  N_digits = 0;
+                    do {
+                        digits[ N_digits++ ] = '0' + integer % 10;
+                        integer /= 10;
+                    } while ( integer );
+                    while ( N_digits ) { *p++ = digits[ --N_digits ]; }
+
+                    if ( precision ) {
+                        *p++ = '.';
+                        for ( int i = precision; i-- > 0; ) {
+                            p[ i ] = '0' + decimals % 10;
+                            decimals /= 10;
+                        }
+                        p += precision;
+                    }
+                    return p - out;
+                }
+            }
+        }
+
+        return snprintf( out, maxValueChars, "%.*f", precision, value );
+    }
+
+    //------------------------------------------------------------
+    // Shortest text that strtod() reads back as value. Values of at
+    // most 15 decimals that are an integer number of units of the
+    // last decimal, less than 2^53, over 10^decimals are written as
+    // fixed decimals: that quotient of two exact doubles is what
+    // strtod() returns for the text. Others are the shortest of 15,
+    // 16 or 17 significant digits that reads back.
+    //------------------------------------------------------------
+    size_t FormatRoundTrip( double value, char *out ) {
+        static const double pow10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,
+            1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+        double magnitude = std::fabs( value );
+
+        if ( magnitude >= 1E-5 and magnitude < 9007199254740992.0 ) {
+            for ( int decimals = 0; decimals <= 15; decimals++ ) {
+                double scaled = magnitude * pow10[ decimals ];
+                if ( scaled >= 9007199254740992.0 ) { break; }
+
+                double units = std::floor( scaled + 0.5 );
+                if ( units / pow10[ decimals ] == magnitude ) {
+                    return FormatFixed( value, decimals, out );
+                }
+            }
+        }
+
+        if ( std::isfinite( value ) ) {
+            for ( int digits = 15; digits < 17; digits++ ) {
+                int n = snprintf( out, maxValueChars, "%.*g",
+                                  digits, value );
+                if ( strtod( out, nullptr ) == value ) { return n; }
+            }
+        }
+        return snprintf( out, maxValueChars, "%.17g", value );
+    }
+
+    //------------------------------------------------------------
+    // One CSV row of N_columns values and newline into out, which
+    // holds at least N_columns * maxValueChars chars
+    //------------------------------------------------------------
+    template < class T >
+    size_t FormatRow( const T *row, size_t N_columns,
+                      int precision, char *out ) {
+        char *p = out;
+        for ( size_t col = 0; col < N_columns; col++ ) {
+            if ( precision == PrecisionRoundTrip ) {
+                p += FormatRoundTrip( row[ col ], p );
+            }
+            else {
+                p += FormatFixed( row[ col ], precision, p );
+            }
+            *p++ = col + 1 < N_columns ? ',' : '\n';
+        }
+        return p - out;
+    }
+
+    //------------------------------------------------------------
+    // Message of a line that ParseLine() rejected
+    //------------------------------------------------------------
+    std::string LineError( std::string caller,
+                           std::string fileName,
+                           size_t      line,
+                           size_t      N_columns,
+                           std::string errMsg )
+    {
+        std::stringstream msg;
+        msg << "ERROR: " << caller << " Line " << line
+            << " of file " << fileName;
+        if ( errMsg.size() ) {
+            msg << ": " << errMsg << "." << std::endl;
+        }
+        else {
+            msg << " does not have " << N_columns
+                << " columns of data." << std::endl;
+        }
+        return msg.str();
+    }
+}
+
+//----------------------------------------------------------------
+// ReadCSV() : Load a CSV file as row-major values.
+// The first line is a header unless all its tokens are digits, in
+// which case columns are named V0, V1, ...
+//
+// The file is memory mapped and split into line-aligned chunks.
+// Lines of each chunk are counted in parallel to place the chunk
+// rows, then the chunks are parsed in parallel directly into the
+// output values.
+//
+// If columns are given, only column 0 (time) and the named columns
+// are converted and stored, in file order.
+//----------------------------------------------------------------
+CSVData ReadCSV( std::string                       path,
+                 std::string                       fileName,
+                 const std::vector< std::string > &columns,
+                 ExecutionContext                  exec ) {
+
+    MappedFile file( path + fileName );
+
+    return ReadCSV( file, path + fileName, columns, exec );
+}
+
+//----------------------------------------------------------------
+// ReadCSV() of a mapped file, fileName for messages
+//----------------------------------------------------------------
+CSVData ReadCSV( const MappedFile                 &file,
+                 std::string                       fileName,
+                 const std::vector< std::string > &columns,
+                 ExecutionContext                  exec ) {
+
+    const char *begin = file.Data();
+    const char *end   = begin + file.Size();
+
+    if ( begin == end ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: ReadCSV() file " << fileName
+               << " is empty." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    //------------------------------------------------------------
+    // Check first line to see if it's only numeric digits, or a header
+    //------------------------------------------------------------
+    const char *firstEnd = static_cast< const char * >(
+        memchr( begin, '\n', end - begin ) );
+    if ( not firstEnd ) { firstEnd = end; }
+
+    CSVData csv;
+    const char *body = begin;
+
+    std::vector< std::string > fileColumnNames;
+
+    if ( EDM_DataIO::ParseHeader( std::string( begin, firstEnd ),
+                                  fileColumnNames ) ) {
+        body = firstEnd < end ? firstEnd + 1 : end;
+    }
+
+    size_t N_fileColumns = fileColumnNames.size();
+
+    //------------------------------------------------------------
+    // Column projection: column 0 and the named columns, in file
+    // order. Other columns are not parsed.
+    //------------------------------------------------------------
+    std::vector< long > slot;
+
+    if ( columns.empty() ) {
+        csv.columnNames = fileColumnNames;
+    }
+    else {
+        std::vector< bool > keep( N_fileColumns, false );
+        if ( N_fileColumns ) { keep[ 0 ] = true; }
+
+        for ( auto ci = columns.begin(); ci != columns.end(); ++ci ) {
+            auto si = std::find( fileColumnNames.begin(),
+                                 fileColumnNames.end(), *ci );
+            if ( si == fileColumnNames.end() ) {
+                std::stringstream errMsg;
+                errMsg << "ERROR: ReadCSV() Failed to find column " << *ci
+                       << " in file " << fileName << std::endl;
+                throw std::runtime_error( errMsg.str() );
+            }
+            keep[ std::distance( fileColumnNames.begin(), si ) ] = true;
+        }
+
+        slot.assign( N_fileColumns, -1 );
+        for ( size_t col = 0; col < N_fileColumns; col++ ) {
+            if ( keep[ col ] ) {
+                slot[ col ] = csv.columnNames.size();
+                csv.columnNames.push_back( fileColumnNames[ col ] );
+            }
+        }
+    }
+
+    size_t N_columns = csv.columnNames.size();
+
+    //------------------------------------------------------------
+    // Line-aligned chunks of the body
+    //------------------------------------------------------------
+    size_t N_chunks = std::max( ( end - body ) / EDM_DataIO::chunkBytes,
+                                (size_t) 1 );
+
+    std::vector< const char * > chunk( N_chunks + 1, end );
+    chunk[ 0 ] = body;
+
+    for ( size_t i = 1; i < N_chunks; i++ ) {
+        const char *p = std::max( body + i * ( ( end - body ) / N_chunks ),
+                                  chunk[ i - 1 ] );
+        if ( p > body and p < end and p[ -1 ] != '\n' ) {
+            const char *nl = static_cast< const char * >(
+                memchr( p, '\n', end - p ) );
+            p = nl ? nl + 1 : end;
+        }
+        chunk[ i ] = p;
+    }
+
+    //------------------------------------------------------------
+    // Rows of each chunk
+    //------------------------------------------------------------
+    std::vector< size_t > chunkRow( N_chunks + 1, 0 );
+
+    exec.Pool().ParallelFor(
+        N_chunks,
+        [&]( size_t i ) {
+            chunkRow[ i + 1 ] = EDM_DataIO::CountLines( chunk[ i ],
+                                                        chunk[ i + 1 ] );
+        },
+        exec.nThreads );
+
+    for ( size_t i = 0; i < N_chunks; i++ ) {
+        chunkRow[ i + 1 ] += chunkRow[ i ];
+    }
+
+    csv.n_rows   = chunkRow[ N_chunks ];
+    csv.elements = std::valarray< double >( csv.n_rows * N_columns );
+
+    //------------------------------------------------------------
+    // Parse each chunk into its rows of elements
+    //------------------------------------------------------------
+    std::vector< std::string > chunkError( N_chunks );
+    double *values = csv.elements.size() ? &csv.elements[ 0 ] : nullptr;
+
+    exec.Pool().ParallelFor(
+        N_chunks,
+        [&]( size_t i ) {
+            size_t      row = chunkRow[ i ];
+            const char *p   = chunk[ i ];
+
+            while ( p < chunk[ i + 1 ] ) {
+                const char *nl = static_cast< const char * >(
+                    memchr( p, '\n', chunk[ i + 1 ] - p ) );
+                const char *lineEnd = nl ? nl : chunk[ i + 1 ];
+
+                std::string errMsg;
+                size_t N_tokens = EDM_DataIO::ParseLine(
+                    p, lineEnd, values + row * N_columns, N_fileColumns,
+                    slot.size() ? slot.data() : nullptr, errMsg );
+
+                if ( errMsg.size() or N_tokens != N_fileColumns ) {
+                    chunkError[ i ] = EDM_DataIO::LineError(
+                        "ReadCSV()", fileName, row + 1, N_fileColumns,
+                        errMsg );
+                    return;
+                }
+
+                row++;
+                p = lineEnd + 1;
+            }
+        },
+        exec.nThreads );
+
+    // Report the first error in file order
+    for ( size_t i = 0; i < N_chunks; i++ ) {
+        if ( chunkError[ i ].size() ) {
+            throw std::runtime_error( chunkError[ i ] );
+        }
+    }
+
+    return csv;
+}
+
+//----------------------------------------------------------------
+// Open fileName, read the header
+//----------------------------------------------------------------
+CSVChunkReader::CSVChunkReader( std::string path, std::string fileName,
+                                size_t chunkRows ) :
+    fileName( path + fileName ), stream( path + fileName, std::ios::binary ),
+    chunkRows( std::max( chunkRows, (size_t) 1 ) ), textStart( 0 ),
+    endOfFile( false ), rowsRead( 0 )
+{
+    if ( not stream.is_open() ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: CSVChunkReader() file " << this->fileName
+               << " is not open for reading." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    // First line
+    size_t nl;
+    while ( ( nl = text.find( '\n' ) ) == std::string::npos ) {
+        if ( not ReadBlock() ) { nl = text.size(); break; }
+    }
+
+    if ( nl == 0 and text.empty() ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: CSVChunkReader() file " << this->fileName
+               << " is empty." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    if ( EDM_DataIO::ParseHeader( text.substr( 0, nl ), fileColumnNames ) ) {
+        textStart = std::min( nl + 1, text.size() );
+    }
+
+    // All columns
+    std::vector< size_t > columns( fileColumnNames.size() );
+    for ( size_t col = 0; col < columns.size(); col++ ) {
+        columns[ col ] = col;
+    }
+    SelectColumns( columns );
+}
+
+//----------------------------------------------------------------
+// Keep file columns, in order
+//----------------------------------------------------------------
+void CSVChunkReader::SelectColumns( const std::vector< size_t > &columns ) {
+
+    slot = std::vector< long >( fileColumnNames.size(), -1 );
+    columnNames.clear();
+
+    for ( size_t i = 0; i < columns.size(); i++ ) {
+        if ( columns[ i ] >= fileColumnNames.size() ) {
+            std::stringstream errMsg;
+            errMsg << "ERROR: CSVChunkReader::SelectColumns() column "
+                   << columns[ i ] << " exceeds the " << fileColumnNames.size()
+                   << " columns of file " << fileName << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+        if ( slot[ columns[ i ] ] >= 0 ) {
+            std::stringstream errMsg;
+            errMsg << "ERROR: CSVChunkReader::SelectColumns() column "
+                   << columns[ i ] << " is selected twice." << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+        slot[ columns[ i ] ] = i;
+        columnNames.push_back( fileColumnNames[ columns[ i ] ] );
+    }
+}
+
+//----------------------------------------------------------------
+// Keep file columns by name, in order
+//----------------------------------------------------------------
+void CSVChunkReader::SelectColumns(
+    const std::vector< std::string > &columns ) {
+
+    std::vector< size_t > columnIndex;
+
+    for ( auto ci = columns.begin(); ci != columns.end(); ++ci ) {
+        auto si = std::find( fileColumnNames.begin(),
+                             fileColumnNames.end(), *ci );
+        if ( si == fileColumnNames.end() ) {
+            std::stringstream errMsg;
+            errMsg << "ERROR: CSVChunkReader::SelectColumns() Failed to find "
+                   << "column " << *ci << " in file " << fileName << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+        columnIndex.push_back( std::distance( fileColumnNames.begin(), si ) );
+    }
+
+    SelectColumns( columnIndex );
+}
+
+//----------------------------------------------------------------
+// Append a block of the file to text, false at end of file
+//----------------------------------------------------------------
+bool CSVChunkReader::ReadBlock() {
+
+    if ( endOfFile ) { return false; }
+
+    // Drop parsed text
+    text.erase( 0, textStart );
+    textStart = 0;
+
+    size_t size = text.size();
+    text.resize( size + EDM_DataIO::chunkBytes );
+    stream.read( &text[ size ], EDM_DataIO::chunkBytes );
+    text.resize( size + stream.gcount() );
+
+    if ( stream.gcount() == 0 ) {
+        endOfFile = true;
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------
+// Parse the next rows of the file into chunk
+//----------------------------------------------------------------
+size_t CSVChunkReader::NextChunk( CSVData &chunk ) {
+
+    size_t N_columns = columnNames.size();
+
+    chunk.columnNames = columnNames;
+    if ( chunk.elements.size() != chunkRows * N_columns ) {
+        chunk.elements.resize( chunkRows * N_columns );
+    }
+    double *values = chunk.elements.size() ? &chunk.elements[ 0 ] : nullptr;
+
+    size_t row = 0;
+    while ( row < chunkRows ) {
+        size_t nl = text.find( '\n', textStart );
+
+        if ( nl == std::string::npos ) {
+            if ( ReadBlock() ) { continue; }
+
+            // Last line without a newline
+            if ( textStart == text.size() ) { break; }
+            nl = text.size();
+        }
+
+        std::string errMsg;
+        size_t N_tokens = EDM_DataIO::ParseLine(
+            text.data() + textStart, text.data() + nl,
+            values + row * N_columns, fileColumnNames.size(),
+            slot.data(), errMsg );
+
+        if ( errMsg.size() or N_tokens != fileColumnNames.size() ) {
+            throw std::runtime_error(
+                EDM_DataIO::LineError( "CSVChunkReader()", fileName,
+                                       rowsRead + row + 1,
+                                       fileColumnNames.size(), errMsg ) );
+        }
+
+        textStart = std::min( nl + 1, text.size() );
+        row++;
+    }
+
+    rowsRead    += row;
+    chunk.n_rows = row;
+
+    if ( row < chunkRows ) {
+        // Last chunk
+        std::valarray< double > rows( values, row * N_columns );
+        chunk.elements = std::move( rows );
+    }
+
+    return row;
+}
+
+//----------------------------------------------------------------
+// Open fileName for writing
+//----------------------------------------------------------------
+CSVWriter::CSVWriter( std::string path, std::string fileName,
+                      int precision, size_t bufferBytes ) :
+    fileName( path + fileName ), stream( path + fileName, std::ios::binary ),
+    precision( precision ),
+    buffer( std::max( bufferBytes, EDM_DataIO::maxValueChars ) ), used( 0 )
+{
+    if ( precision < PrecisionRoundTrip or
+         precision > EDM_DataIO::maxPrecision ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: CSVWriter() precision " << precision
+               << " is not in [" << PrecisionRoundTrip << ", "
+               << EDM_DataIO::maxPrecision << "]." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+    if ( not stream.is_open() ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: CSVWriter() Failed to open file: "
+               << this->fileName << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+}
+
+//----------------------------------------------------------------
+// Write what is buffered, errors are left to Close()
+//----------------------------------------------------------------
+CSVWriter::~CSVWriter() {
+    if ( stream.is_open() and used ) {
+        stream.write( buffer.data(), used );
+    }
+}
+
+//----------------------------------------------------------------
+void CSVWriter::WriteHeader( const std::vector< std::string > &columnNames ) {
+    std::string header;
+    for ( size_t col = 0; col < columnNames.size(); col++ ) {
+        header += columnNames[ col ];
+        header += col + 1 < columnNames.size() ? ',' : '\n';
+    }
+    Append( header.data(), header.size() );
+}
+
+//----------------------------------------------------------------
+void CSVWriter::WriteRows( const double *values, size_t n_rows,
+                           size_t n_columns, ExecutionContext exec ) {
+    Rows( values, n_rows, n_columns, exec );
+}
+
+void CSVWriter::WriteRows( const float *values, size_t n_rows,
+                           size_t n_columns, ExecutionContext exec ) {
+    Rows( values, n_rows, n_columns, exec );
+}
+
+//----------------------------------------------------------------
+// Format rows into the buffer. With more than one thread, blocks
+// of rows are formatted in parallel into per block text, a batch
+// of blocks at a time, and appended in row order.
+//----------------------------------------------------------------
+template < class T >
+void CSVWriter::Rows( const T *values, size_t n_rows, size_t n_columns,
+                      ExecutionContext exec ) {
+
+    const size_t blockRows = 4096;
+    size_t rowChars = std::max( n_columns, (size_t) 1 ) *
+                      EDM_DataIO::maxValueChars;
+
+    ThreadPool &pool = exec.Pool();
+    size_t N_tasks = exec.nThreads ?
+        std::min( exec.nThreads, pool.NThreads() ) : pool.NThreads();
+
+    if ( N_tasks < 2 or n_rows < 2 * blockRows ) {
+        if ( buffer.size() < rowChars ) { buffer.resize( rowChars ); }
+
+        for ( size_t row = 0; row < n_rows; row++ ) {
+            if ( buffer.size() - used < rowChars ) { Flush(); }
+            used += EDM_DataIO::FormatRow( values + row * n_columns,
+                                           n_columns, precision,
+                                           buffer.data() + used );
+        }
+        return;
+    }
+
+    std::vector< std::vector< char > > blocks( 2 * N_tasks );
+    std::vector< size_t >              blockSize( blocks.size() );
+
+    for ( size_t first = 0; first < n_rows;
+          first += blocks.size() * blockRows ) {
+
+        size_t N_blocks = std::min( blocks.size(),
+            ( n_rows - first + blockRows - 1 ) / blockRows );
+
+        pool.ParallelFor(
+            N_blocks,
+            [&]( size_t b ) {
+                size_t start = first + b * blockRows;
+                size_t stop  = std::min( start + blockRows, n_rows );
+
+                std::vector< char > &text = blocks[ b ];
+                size_t size = 0;
+                for ( size_t row = start; row < stop; row++ ) {
+                    if ( text.size() - size < rowChars ) {
+                        text.resize( std::max( 2 * text.size(),
+                                               size + rowChars ) );
+                    }
+                    size += EDM_DataIO::FormatRow( values + row * n_columns,
+                                                   n_columns, precision,
+                                                   text.data() + size );
+                }
+                blockSize[ b ] = size;
+            },
+            exec.nThreads );
+
+        for ( size_t b = 0; b < N_blocks; b++ ) {
+            Append( blocks[ b ].data(), blockSize[ b ] );
+        }
+    }
+}
+
+//----------------------------------------------------------------
+void CSVWriter::Append( const char *text, size_t n ) {
+    if ( buffer.size() - used < n ) {
+        Flush();
+        if ( buffer.size() < n ) {
+            stream.write( text, n );
+            return;
+        }
+    }
+    memcpy( buffer.data() + used, text, n );
+    used += n;
+}
+
+//----------------------------------------------------------------
+void CSVWriter::Flush() {
+    if ( used ) {
+        stream.write( buffer.data(), used );
+        used = 0;
+    }
+    if ( not stream.good() ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: CSVWriter() Failed to write file: "
+               << fileName << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+}
+
+//----------------------------------------------------------------
+void CSVWriter::Close() {
+    Flush();
+    stream.close();
+    if ( stream.fail() ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: CSVWriter() Failed to close file: "
+               << fileName << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+}
+
+//----------------------------------------------------------------
+// true if file starts with the binary DataFrame magic
+//----------------------------------------------------------------
+bool IsBinaryFile( const MappedFile &file ) {
+    return file.Size() >= sizeof( EDM_DataIO::binaryMagic ) and
+           memcmp( file.Data(), EDM_DataIO::binaryMagic,
+                   sizeof( EDM_DataIO::binaryMagic ) ) == 0;
+}
+
+//----------------------------------------------------------------
+// ReadBinary() : Validate the header of a mapped binary DataFrame
+// file. The values are not copied: data points into the mapping,
+// which the returned file keeps alive.
+//----------------------------------------------------------------
+BinaryData ReadBinary( std::shared_ptr< MappedFile > file,
+                       std::string                   fileName ) {
+
+    EDM_DataIO::BinaryHeader header;
+
+    if ( not IsBinaryFile( *file ) or file->Size() < sizeof( header ) ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: ReadBinary() file " << fileName
+               << " is not a binary DataFrame file." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    memcpy( &header, file->Data(), sizeof( header ) );
+
+    if ( header.version   != BinaryVersion or
+         header.byteOrder != EDM_DataIO::byteOrder ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: ReadBinary() file " << fileName
+               << " version " << header.version
+               << " or byte order is not supported." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    BinaryData binary;
+    binary.n_rows    = header.n_rows;
+    binary.n_columns = header.n_columns;
+    binary.dtype     = static_cast< BinaryDType  >( header.dtype  );
+    binary.layout    = static_cast< BinaryLayout >( header.layout );
+    binary.file      = file;
+
+    if ( ( binary.dtype  != BinaryDType::Float64    and
+           binary.dtype  != BinaryDType::Float32 )  or
+         ( binary.layout != BinaryLayout::RowMajor  and
+           binary.layout != BinaryLayout::ColumnMajor ) ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: ReadBinary() file " << fileName
+               << " dtype " << header.dtype << " layout " << header.layout
+               << " is not supported." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    // Column names
+    const char *p   = file->Data() + sizeof( header );
+    const char *end = file->Data() + std::min( (size_t) header.dataOffset,
+                                               file->Size() );
+
+    for ( size_t col = 0; col < binary.n_columns; col++ ) {
+        uint32_t length;
+        if ( p + sizeof( length ) > end ) { break; }
+        memcpy( &length, p, sizeof( length ) );
+        p += sizeof( length );
+        if ( p + length > end ) { break; }
+        binary.columnNames.push_back( std::string( p, length ) );
+        p += length;
+    }
+
+    // Values the file holds past dataOffset: n_rows and n_columns
+    // are checked by division, their product can overflow
+    size_t fileValues = header.dataOffset <= file->Size() ?
+        ( file->Size() - header.dataOffset ) /
+        EDM_DataIO::DTypeSize( binary.dtype ) : 0;
+
+    if ( binary.columnNames.size() != binary.n_columns or
+         header.dataOffset > file->Size() or
+         ( binary.n_columns and
+           binary.n_rows > fileValues / binary.n_columns ) ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: ReadBinary() file " << fileName
+               << " is truncated." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    binary.data = file->Data() + header.dataOffset;
+
+    return binary;
+}
+
+//----------------------------------------------------------------
+// Open fileName, write the header and column names padded to the
+// aligned data block. The row count is 0 until Close().
+//----------------------------------------------------------------
+BinaryWriter::BinaryWriter( std::string                       path,
+                            std::string                       fileName,
+                            const std::vector< std::string > &columnNames,
+                            BinaryDType                       dtype ) :
+    fileName( path + fileName ), stream( path + fileName, std::ios::binary ),
+    n_columns( columnNames.size() ), dtype( dtype ), n_rows( 0 )
+{
+    if ( not stream.is_open() ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: BinaryWriter() Failed to open file: "
+               << this->fileName << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    EDM_DataIO::BinaryHeader header;
+    memcpy( header.magic, EDM_DataIO::binaryMagic, sizeof( header.magic ) );
+    header.version   = BinaryVersion;
+    header.byteOrder = EDM_DataIO::byteOrder;
+    header.dtype     = static_cast< uint32_t >( dtype );
+    header.layout    = static_cast< uint32_t >( BinaryLayout::RowMajor );
+    header.n_rows    = 0;
+    header.n_columns = n_columns;
+    header.alignment = BinaryAlignment;
+
+    std::string head( (const char *) &header, sizeof( header ) );
+    for ( size_t col = 0; col < n_columns; col++ ) {
+        uint32_t length = columnNames[ col ].size();
+        head.append( (const char *) &length, sizeof( length ) );
+        head.append( columnNames[ col ] );
+    }
+    head.resize( ( head.size() + BinaryAlignment - 1 ) /
+                 BinaryAlignment * BinaryAlignment, '\0' );
+
+    header.dataOffset = head.size();
+    memcpy( &head[ 0 ], &header, sizeof( header ) );
+
+    stream.write( head.data(), head.size() );
+}
+
+//----------------------------------------------------------------
+void BinaryWriter::WriteRows( const void *values, size_t n_rows ) {
+    stream.write( (const char *) values,
+                  n_rows * n_columns * EDM_DataIO::DTypeSize( dtype ) );
+
+    if ( not stream.good() ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: BinaryWriter() Failed to write file: "
+               << fileName << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+    this->n_rows += n_rows;
+}
+
+//----------------------------------------------------------------
+void BinaryWriter::Close() {
+    uint64_t rows = n_rows;
+    stream.seekp( offsetof( EDM_DataIO::BinaryHeader, n_rows ) );
+    stream.write( (const char *) &rows, sizeof( rows ) );
+    stream.close();
+
+    if ( stream.fail() ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: BinaryWriter() Failed to write file: "
+               << fileName << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+}
+
+//----------------------------------------------------------------
+// WriteBinary() : Write row-major values as a binary DataFrame file
+//----------------------------------------------------------------
+void WriteBinary( std::string                        path,
+                  std::string                        fileName,
+                  const std::vector< std::string > &columnNames,
+                  size_t                             n_rows,
+                  size_t                             n_columns,
+                  BinaryDType                        dtype,
+                  const void                        *data ) {
+
+    if ( columnNames.size() != n_columns ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: WriteBinary() The number of column names ("
+               << columnNames.size() << ") does not match the number"
+               << " of columns (" << n_columns << ")." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    BinaryWriter writer( path, fileName, columnNames, dtype );
+
+    writer.WriteRows( data, n_rows );
+    writer.Close();
+}
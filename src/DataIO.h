@@ -0,0 +1,303 @@
+#ifndef DATAIO_H
+#define DATAIO_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <valarray>
+#include <memory>
+#include <cstdint>
+
+#include "ThreadPool.h"
+
+//----------------------------------------------------------------
+// MappedFile
+// Private memory map of a file: pages are shared with the page
+// cache until written, writes are never carried to the file.
+// Falls back to reading the file into memory where the file
+// cannot be mapped.
+//----------------------------------------------------------------
+class MappedFile {
+
+public:
+    MappedFile( std::string fileName );
+    ~MappedFile();
+
+    char  *Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    char               *data;
+    size_t              size;
+    bool                mapped;
+    std::vector< char > buffer; // unmapped fallback
+
+    MappedFile( const MappedFile & );
+    MappedFile &operator=( const MappedFile & );
+};
+
+//----------------------------------------------------------------
+// CSV file contents: column names and row-major values
+//----------------------------------------------------------------
+struct CSVData {
+    std::vector< std::string > columnNames;
+    size_t                     n_rows;
+    std::valarray< double >    elements;
+};
+
+// Parse a CSV file in parallel line-aligned chunks.
+// columns not empty: keep only column 0 and the named columns.
+CSVData ReadCSV( std::string                       path,
+                 std::string                       fileName,
+                 const std::vector< std::string > &columns =
+                     std::vector< std::string >(),
+                 ExecutionContext                  exec = ExecutionContext() );
+
+CSVData ReadCSV( const MappedFile                 &file,
+                 std::string                       fileName,
+                 const std::vector< std::string > &columns =
+                     std::vector< std::string >(),
+                 ExecutionContext                  exec = ExecutionContext() );
+
+//----------------------------------------------------------------
+// CSVChunkReader
+// Streams a CSV file as chunks of at most chunkRows rows. Memory
+// is bounded by one chunk and one read block of text, not by the
+// file size. SelectColumns() before the first NextChunk() keeps
+// only the given file columns, in the given order; the other
+// columns are not parsed.
+//----------------------------------------------------------------
+class CSVChunkReader {
+
+public:
+    CSVChunkReader( std::string path, std::string fileName,
+                    size_t chunkRows = 65536 );
+
+    const std::vector< std::string > &FileColumnNames() const {
+        return fileColumnNames;
+    }
+    const std::vector< std::string > &ColumnNames() const {
+        return columnNames;
+    }
+
+    void SelectColumns( const std::vector< size_t >      &columns );
+    void SelectColumns( const std::vector< std::string > &columns );
+
+    // Next rows of the file into chunk, returns chunk.n_rows.
+    // 0 : end of file.
+    size_t NextChunk( CSVData &chunk );
+
+    // Data rows returned so far
+    size_t RowsRead() const { return rowsRead; }
+
+private:
+    std::string                fileName;
+    std::ifstream              stream;
+    size_t                     chunkRows;
+    std::vector< std::string > fileColumnNames;
+    std::vector< std::string > columnNames; // selected columns
+    std::vector< long >        slot;        // file column -> chunk column
+    std::string                text;        // read, not yet parsed
+    size_t                     textStart;
+    bool                       endOfFile;
+    size_t                     rowsRead;
+
+    bool ReadBlock();
+};
+
+//----------------------------------------------------------------
+// CSVWriter
+// Buffered CSV output. Values are formatted straight into a block
+// buffer that is written to the file each time it fills, so memory
+// is bounded by the buffer, not by the output size.
+//
+// precision >= 0 : fixed notation with precision decimals, as the
+//                  "%.*f" printf format.
+// PrecisionRoundTrip : the shortest of 15, 16 or 17 significant
+//                  digits that reads back as the same value.
+//
+// WriteRows() formats blocks of rows in parallel on exec, and
+// writes them in order.
+//----------------------------------------------------------------
+const int PrecisionRoundTrip = -1;
+
+class CSVWriter {
+
+public:
+    CSVWriter( std::string path, std::string fileName,
+               int precision = 4, size_t bufferBytes = 1 << 20 );
+    ~CSVWriter();
+
+    void WriteHeader( const std::vector< std::string > &columnNames );
+
+    // n_rows x n_columns row-major values
+    void WriteRows( const double    *values,
+                    size_t           n_rows,
+                    size_t           n_columns,
+                    ExecutionContext exec = ExecutionContext() );
+    void WriteRows( const float     *values,
+                    size_t           n_rows,
+                    size_t           n_columns,
+                    ExecutionContext exec = ExecutionContext() );
+
+    // Write the buffer to the file
+    void Flush();
+
+    // Flush and close the file, errors are thrown
+    void Close();
+
+private:
+    std::string       fileName;
+    std::ofstream     stream;
+    int               precision;
+    std::vector<char> buffer;
+    size_t            used;
+
+    template < class T >
+    void Rows( const T *values, size_t n_rows, size_t n_columns,
+               ExecutionContext exec );
+    void Append( const char *text, size_t n );
+
+    CSVWriter( const CSVWriter & );
+    CSVWriter &operator=( const CSVWriter & );
+};
+
+//----------------------------------------------------------------
+// Binary DataFrame file
+//
+// Header, all fields in native byte order:
+//   char     magic[ 8 ]  "cppEDMDF"
+//   uint32_t version     BinaryVersion
+//   uint32_t byteOrder   0x01020304 as written
+//   uint32_t dtype       BinaryDType
+//   uint32_t layout      BinaryLayout
+//   uint64_t n_rows
+//   uint64_t n_columns
+//   uint64_t alignment   of the data block
+//   uint64_t dataOffset  of the data block
+//   n_columns x { uint32_t length, char name[ length ] }
+// zero padding to dataOffset, then the n_rows x n_columns values.
+//
+// The data block is aligned in the file, so a memory map of the
+// file holds the values at an aligned address.
+//----------------------------------------------------------------
+enum class BinaryDType  : uint32_t { Float64 = 1, Float32 = 2 };
+enum class BinaryLayout : uint32_t { RowMajor = 0, ColumnMajor = 1 };
+
+const uint32_t BinaryVersion   = 1;
+const uint64_t BinaryAlignment = 64;
+
+// dtype of DataFrame<T> values that can be mapped in place
+template < class T > struct BinaryTraits {
+    static const bool        native = false;
+    static const BinaryDType dtype  = BinaryDType::Float64;
+};
+template <> struct BinaryTraits< double > {
+    static const bool        native = true;
+    static const BinaryDType dtype  = BinaryDType::Float64;
+};
+template <> struct BinaryTraits< float > {
+    static const bool        native = true;
+    static const BinaryDType dtype  = BinaryDType::Float32;
+};
+
+struct BinaryData {
+    std::vector< std::string >    columnNames;
+    size_t                        n_rows;
+    size_t                        n_columns;
+    BinaryDType                   dtype;
+    BinaryLayout                  layout;
+    std::shared_ptr< MappedFile > file; // owns data
+    char                         *data; // values in file
+};
+
+// true if file starts with the binary DataFrame magic
+bool IsBinaryFile( const MappedFile &file );
+
+// Header of a mapped binary DataFrame file and a pointer to its values
+BinaryData ReadBinary( std::shared_ptr< MappedFile > file,
+                       std::string                   fileName );
+
+//----------------------------------------------------------------
+// BinaryWriter
+// Writes a binary DataFrame file a block of rows at a time. The
+// header row count is set by Close().
+//----------------------------------------------------------------
+class BinaryWriter {
+
+public:
+    BinaryWriter( std::string                       path,
+                  std::string                       fileName,
+                  const std::vector< std::string > &columnNames,
+                  BinaryDType                       dtype =
+                      BinaryDType::Float64 );
+
+    // n_rows row-major rows of values of the writer dtype
+    void WriteRows( const void *values, size_t n_rows );
+
+    size_t RowsWritten() const { return n_rows; }
+
+    // Set the header row count, close the file
+    void Close();
+
+private:
+    std::string   fileName;
+    std::ofstream stream;
+    size_t        n_columns;
+    BinaryDType   dtype;
+    size_t        n_rows;
+
+    BinaryWriter( const BinaryWriter & );
+    BinaryWriter &operator=( const BinaryWriter & );
+};
+
+// Write row-major values as a binary DataFrame file
+void WriteBinary( std::string                        path,
+                  std::string                        fileName,
+                  const std::vector< std::string > &columnNames,
+                  size_t                             n_rows,
+                  size_t                             n_columns,
+                  BinaryDType                        dtype,
+                  const void                        *data );
+
+//----------------------------------------------------------------
+// NumPy .npy and .npz files
+//
+// .npy : a float64 or float32 array in native byte order, 1-D (one
+//        column) or 2-D (rows x columns), C or Fortran ordered.
+//        Columns are named V0, V1, ...
+// .npz : an uncompressed zip archive of .npy arrays as written by
+//        numpy.savez(). Each array is a column of the DataFrame
+//        named by the array name: 1-D, or 2-D with one column, all
+//        of the same length.
+//
+// The values are not copied: data points into the mapped file.
+//----------------------------------------------------------------
+bool IsNpyFile( const MappedFile &file );
+bool IsNpzFile( const MappedFile &file );
+
+BinaryData ReadNpy( std::shared_ptr< MappedFile > file,
+                    std::string                   fileName );
+
+// Arrays of an .npz file in archive order, one column each
+std::vector< BinaryData > ReadNpz( std::shared_ptr< MappedFile > file,
+                                   std::string                   fileName );
+
+// Write row-major values as a 2-D C ordered .npy array
+void WriteNpy( std::string  path,
+               std::string  fileName,
+               size_t       n_rows,
+               size_t       n_columns,
+               BinaryDType  dtype,
+               const void  *data );
+
+// Write each column of row-major values as a 1-D .npy array of an
+// uncompressed .npz archive, named by the column name
+void WriteNpz( std::string                        path,
+               std::string                        fileName,
+               const std::vector< std::string > &columnNames,
+               size_t                             n_rows,
+               size_t                             n_columns,
+               BinaryDType                        dtype,
+               const void                        *data );
+#endif
@@ -3,6 +3,43 @@
 
 // NOTE: The returned data block does NOT have the time column
 
+namespace EDM_Embed {
+    //------------------------------------------------------------
+    // Embed(), MakeBlock() of DataFrame values of type T
+    //------------------------------------------------------------
+    template < class T >
+    DataFrame< T > Embed ( const DataFrameView< T > &dataFrame,
+                           int                       E,
+                           int                       tau,
+                           std::string               columns,
+                           bool                      verbose,
+                           ExecutionContext          exec );
+
+    template < class T >
+    EmbeddingView< T > EmbedView ( const DataFrameView< T > &dataFrame,
+                                   int                       E,
+                                   int                       tau,
+                                   std::string               columns,
+                                   bool                      verbose );
+
+    // View of the columns to embed, and their names for MakeBlock()
+    template < class T >
+    DataFrameView< T > EmbedColumns ( const DataFrameView< T > &dataFrame,
+                                      int                       E,
+                                      int                       tau,
+                                      std::string               columns,
+                                      bool                      verbose,
+                                      std::vector<std::string> &colNames );
+
+    template < class T >
+    DataFrame< T > MakeBlock ( const DataFrameView< T > &dataFrame,
+                               int                       E,
+                               int                       tau,
+                               std::vector<std::string>  columnNames,
+                               bool                      verbose,
+                               ExecutionContext          exec );
+}
+
 //----------------------------------------------------------------
 // API Overload 1: Explicit data file path/name
 //   Implemented as a wrapper to API Overload 2:
@@ -33,13 +70,133 @@ DataFrame< double > Embed ( std::string path,
 //----------------------------------------------------------------
 // API Overload 2: DataFrame provided
 //   Implemented as a wrapper for MakeBlock()
-// Note: dataFrame must have the columnNameToIndex map 
+// Note: dataFrame must have column names if columns are names
+//----------------------------------------------------------------
+DataFrame< double > Embed ( const DataFrameView< double > &dataFrameIn,
+                            int                            E,
+                            int                            tau,
+                            std::string                    columns,
+                            bool                           verbose,
+                            ExecutionContext               exec ) {
+    return EDM_Embed::Embed( dataFrameIn, E, tau, columns, verbose, exec );
+}
+
+DataFrame< float > Embed ( const DataFrameView< float > &dataFrameIn,
+                           int                           E,
+                           int                           tau,
+                           std::string                   columns,
+                           bool                          verbose,
+                           ExecutionContext              exec ) {
+    return EDM_Embed::Embed( dataFrameIn, E, tau, columns, verbose, exec );
+}
+
+//----------------------------------------------------------------
+// Embedding view of DataFrame columns: as Embed(), not copied
+//----------------------------------------------------------------
+EmbeddingView< double > EmbedView( const DataFrameView< double > &dataFrame,
+                                   int                            E,
+                                   int                            tau,
+                                   std::string                    columns,
+                                   bool                           verbose ) {
+    return EDM_Embed::EmbedView( dataFrame, E, tau, columns, verbose );
+}
+
+EmbeddingView< float > EmbedView( const DataFrameView< float > &dataFrame,
+                                  int                           E,
+                                  int                           tau,
+                                  std::string                   columns,
+                                  bool                          verbose ) {
+    return EDM_Embed::EmbedView( dataFrame, E, tau, columns, verbose );
+}
+
+//---------------------------------------------------------
+// MakeBlock from dataFrame
+//---------------------------------------------------------
+DataFrame< double > MakeBlock ( const DataFrameView< double > &dataFrame,
+                                int                            E,
+                                int                            tau,
+                                std::vector<std::string>       columnNames,
+                                bool                           verbose,
+                                ExecutionContext               exec ) {
+    return EDM_Embed::MakeBlock( dataFrame, E, tau, columnNames,
+                                 verbose, exec );
+}
+
+DataFrame< float > MakeBlock ( const DataFrameView< float > &dataFrame,
+                               int                           E,
+                               int                           tau,
+                               std::vector<std::string>      columnNames,
+                               bool                          verbose,
+                               ExecutionContext              exec ) {
+    return EDM_Embed::MakeBlock( dataFrame, E, tau, columnNames,
+                                 verbose, exec );
+}
+
+//---------------------------------------------------------
+// MakeBlock from an EmbeddingView
+//---------------------------------------------------------
+DataFrame< double > MakeBlock ( const EmbeddingView< double > &embedding,
+                                ExecutionContext               exec ) {
+    return EDM_Embed::MakeBlock( embedding.View(), embedding.Dimension(),
+                                 embedding.Tau(), embedding.Names(), false,
+                                 exec );
+}
+
+DataFrame< float > MakeBlock ( const EmbeddingView< float > &embedding,
+                               ExecutionContext              exec ) {
+    return EDM_Embed::MakeBlock( embedding.View(), embedding.Dimension(),
+                                 embedding.Tau(), embedding.Names(), false,
+                                 exec );
+}
+
+//----------------------------------------------------------------
+// Embed() of DataFrame values of type T
 //----------------------------------------------------------------
-DataFrame< double > Embed ( DataFrame< double > dataFrameIn,
-                            int                 E,
-                            int                 tau,
-                            std::string         columns,
-                            bool                verbose ) {
+template < class T >
+DataFrame< T > EDM_Embed::Embed( const DataFrameView< T > &dataFrameIn,
+                                 int                       E,
+                                 int                       tau,
+                                 std::string               columns,
+                                 bool                      verbose,
+                                 ExecutionContext          exec ) {
+
+    std::vector< std::string > colNames;
+    DataFrameView< T > dataFrame = EmbedColumns( dataFrameIn, E, tau,
+                                                 columns, verbose, colNames );
+
+    DataFrame< T > embedding = MakeBlock( dataFrame, E, tau,
+                                          colNames, verbose, exec );
+    return embedding;
+}
+
+//----------------------------------------------------------------
+// EmbedView() of DataFrame values of type T
+//----------------------------------------------------------------
+template < class T >
+EmbeddingView< T > EDM_Embed::EmbedView( const DataFrameView< T > &dataFrameIn,
+                                         int                       E,
+                                         int                       tau,
+                                         std::string               columns,
+                                         bool                      verbose ) {
+
+    std::vector< std::string > colNames;
+    DataFrameView< T > dataFrame = EmbedColumns( dataFrameIn, E, tau,
+                                                 columns, verbose, colNames );
+
+    return EmbeddingView< T >( dataFrame, E, tau, colNames );
+}
+
+//----------------------------------------------------------------
+// Columns of dataFrameIn to embed, and their names
+//----------------------------------------------------------------
+template < class T >
+DataFrameView< T > EDM_Embed::EmbedColumns(
+    const DataFrameView< T > &dataFrameIn,
+    int                       E,
+    int                       tau,
+    std::string               columns,
+    bool                      verbose,
+    std::vector<std::string> &colNames ) {
     
     // Parameter.Validate will convert columns into a vector of names
     // or a vector of column indices
@@ -48,12 +205,11 @@ DataFrame< double > Embed ( DataFrame< double > dataFrameIn,
                                    columns, "", false, verbose );
 
     if ( not param.columnIndex.size() and
-         dataFrameIn.ColumnNameToIndex().empty() ) {
+         dataFrameIn.ColumnNames().empty() ) {
         throw std::runtime_error("Embed(DataFrame): columnNameIndex empty.\n");
     }
 
     // Get column names for MakeBlock
-    std::vector< std::string > colNames;
     if ( param.columnNames.size() ) {
         // column names are strings use as-is
         colNames = param.columnNames;
@@ -71,35 +227,29 @@ DataFrame< double > Embed ( DataFrame< double > dataFrameIn,
                                   " columnIndex are empty.\n" );
     }
 
-    // Extract the specified columns (sub)DataFrame from dataFrameIn
-    DataFrame< double > dataFrame;
+    // View of the specified columns of dataFrameIn, not copied
+    DataFrameView< T > dataFrame;
     
     if ( param.columnNames.size() ) {
-        // Get a vector of column indices 
-        std::vector< size_t > col_i;
-        for ( auto colName : param.columnNames ) {
-            col_i.push_back( dataFrameIn.ColumnNameToIndex()[ colName ] );
-        }
-        dataFrame = dataFrameIn.DataFrameFromColumnIndex( col_i );
+        dataFrame = dataFrameIn.Columns( param.columnNames );
     }
     else if ( param.columnIndex.size() ) {
         // alread have column indices
-        dataFrame = dataFrameIn.DataFrameFromColumnIndex( param.columnIndex );
+        dataFrame = dataFrameIn.Columns( param.columnIndex );
     }
-
-    DataFrame< double > embedding = MakeBlock( dataFrame, E, tau,
-                                               colNames, verbose );
-    return embedding;
+    return dataFrame;
 }
 
 //---------------------------------------------------------
-// MakeBlock from dataFrame
+// MakeBlock() of DataFrame values of type T
 //---------------------------------------------------------
-DataFrame< double > MakeBlock ( DataFrame< double >      dataFrame,
-                                int                      E,
-                                int                      tau,
-                                std::vector<std::string> columnNames,
-                                bool                     verbose ) {
+template < class T >
+DataFrame< T > EDM_Embed::MakeBlock( const DataFrameView< T > &dataFrame,
+                                     int                       E,
+                                     int                       tau,
+                                     std::vector<std::string>  columnNames,
+                                     bool                      verbose,
+                                     ExecutionContext          exec ) {
 
     if ( columnNames.size() != dataFrame.NColumns() ) {
         std::stringstream errMsg;
@@ -113,9 +263,6 @@ DataFrame< double > MakeBlock ( DataFrame< double >      dataFrame,
     size_t NColOut  = dataFrame.NColumns() * E; // number of output columns
     size_t NPartial = tau * (E-1);              // rows to shift & delete
 
-    // temporary data frame to hold the embedded (shifted) data
-    DataFrame< double > shiftDataFrame( NRows, NColOut );
-
     // Create embedded data frame column names X(t-0) X(t-1)...
     std::vector< std::string > newColumnNames( NColOut );
     size_t newCol_i = 0;
@@ -128,40 +275,34 @@ DataFrame< double > MakeBlock ( DataFrame< double >      dataFrame,
         }
     }
 
-    // Ouput data frame with tau * E-1 fewer rows
-    DataFrame< double > embedding( NRows - NPartial, NColOut, newColumnNames );
+    // Rows with partial data (tau * E-1) are not embedded
+    EmbeddingView< T > view( dataFrame, E, tau, columnNames );
 
-    // slice indices for each column of original & shifted data
-    std::slice slice_i = std::slice (0, NRows, 1);
+    // Ouput data frame with tau * E-1 fewer rows: aligned, zero
+    // padded rows, searched in place by FindNeighbors()
+    DataFrame< T > embedding( NRows - NPartial, NColOut,
+                              DataFrameLayout::RowMajor, true );
+    embedding.ColumnNames() = newColumnNames;
+    embedding.BuildColumnNameIndex();
 
-    // to keep track of where to insert column in new data frame
-    size_t colCount = 0;
-
-    // shift column data and write to temporary data frame
-    for ( size_t col = 0; col < dataFrame.NColumns(); col++ ) {
-        // for each embedding dimension
-        for ( size_t e = 0; e < E; e++ ) {
+    //------------------------------------------------------------
+    // Each output value is written once, in row order, from the
+    // view columns. Blocks of rows are distributed over the thread
+    // pool: rows about 64k values, no cache line is written by two
+    // threads except at block edges.
+    //------------------------------------------------------------
+    T     *out    = embedding.Write( 0, 0 );
+    size_t stride = embedding.Stride();
+    size_t grain  = std::max( (size_t) 1, 65536 / NColOut );
 
-            std::valarray< double > column = dataFrame.Column( col );
-            
-            std::valarray< double > tmp = column.shift( -e * tau )[slice_i];
+    exec.Pool().ParallelForRange(
+        embedding.NRows(), grain,
+        [&]( size_t rowStart, size_t rowStop ) {
+            for ( size_t row = rowStart; row < rowStop; row++ ) {
+                view.Row( row, out + row * stride );
+            }
+        },
+        exec.nThreads );
 
-            // These will be deleted, but set to NAN for completeness
-            tmp[ std::slice( 0, e * tau, 1 ) ] = NAN;
-
-            shiftDataFrame.WriteColumn( colCount, tmp );
-            colCount++;
-        }
-    }
-
-    // Delete rows with partial data
-    slice_i = std::slice ( NPartial, NRows - NPartial, 1 );
-
-    // Write shifted columns to the output embedding DataFrame
-    for ( size_t i = 0; i < NColOut; i++ ) {
-        std::valarray< double > tmp = shiftDataFrame.Column( i )[ slice_i ];
-        embedding.WriteColumn( i, tmp );
-    }
-    
     return embedding;
 }
@@ -4,6 +4,92 @@
 #include "Common.h"
 #include "Parameter.h"
 
+//----------------------------------------------------------------
+// EmbeddingView class
+// Time delay embedding of the columns of a DataFrameView that is
+// not materialized: rows are read in place from the view columns.
+// Rows, columns and names are those of MakeBlock() of the view:
+// element (row, col * E + e) is view( row + tau * (E-1) - e * tau,
+// col ). The viewed DataFrame must outlive the EmbeddingView.
+//----------------------------------------------------------------
+template <class T>
+class EmbeddingView {
+
+    DataFrameView<T>           view;         // columns to embed
+    std::vector< std::string > columnNames;  // of the view columns
+    size_t                     E;
+    size_t                     tau;
+    size_t                     shift;        // tau * (E-1) partial rows
+    std::vector< const T * >   columnValues; // view columns
+    size_t                     rowStride;
+
+public:
+    EmbeddingView() : E( 0 ), tau( 0 ), shift( 0 ), rowStride( 0 ) {}
+
+    EmbeddingView( const DataFrameView<T>    &view,
+                   int                        E,
+                   int                        tau,
+                   std::vector< std::string > columnNames ) :
+        view( view ), columnNames( columnNames ), E( E ), tau( tau ),
+        shift( tau * ( E - 1 ) ), rowStride( view.RowStride() )
+    {
+        if ( columnNames.size() != view.NColumns() ) {
+            std::stringstream errMsg;
+            errMsg << "EmbeddingView: The number of columns in the view ("
+                   << view.NColumns() << ") is not equal to the number "
+                   << "of columns specified (" << columnNames.size()
+                   << ").\n";
+            throw std::runtime_error( errMsg.str() );
+        }
+        if ( E < 1 or tau < 0 or shift >= view.NRows() ) {
+            std::stringstream errMsg;
+            errMsg << "EmbeddingView: E (" << E << ") and tau (" << tau
+                   << ") do not embed the " << view.NRows()
+                   << " rows of the view.\n";
+            throw std::runtime_error( errMsg.str() );
+        }
+        for ( size_t col = 0; col < view.NColumns(); col++ ) {
+            columnValues.push_back( view.ColumnData( col ) );
+        }
+    }
+
+    size_t NRows()     const { return view.NRows() - shift; }
+    size_t NColumns()  const { return columnValues.size() * E; }
+    size_t Dimension() const { return E;   }
+    size_t Tau()       const { return tau; }
+
+    // Embedded columns, for MakeBlock()
+    const DataFrameView<T>           &View()  const { return view; }
+    const std::vector< std::string > &Names() const { return columnNames; }
+
+    // Values of view column col, rows RowStride() apart
+    const T *ColumnData( size_t col ) const { return columnValues[ col ]; }
+    size_t   RowStride()              const { return rowStride; }
+
+    //-----------------------------------------------------------------
+    // Element access E(row,col) as of the row-major MakeBlock()
+    // DataFrame: column NColumns() is column 0 of the next row
+    //-----------------------------------------------------------------
+    T operator()( size_t row, size_t column ) const {
+        row    += column / NColumns();
+        column  = column % NColumns();
+        return columnValues[ column / E ]
+            [ ( row + shift - ( column % E ) * tau ) * rowStride ];
+    }
+
+    //-----------------------------------------------------------------
+    // Values of row into out[ NColumns() ]
+    //-----------------------------------------------------------------
+    void Row( size_t row, T *out ) const {
+        for ( size_t col = 0; col < columnValues.size(); col++ ) {
+            const T *values = columnValues[ col ];
+            for ( size_t e = 0; e < E; e++ ) {
+                *out++ = values[ ( row + shift - e * tau ) * rowStride ];
+            }
+        }
+    }
+};
+
 //----------------------------------------------------------------
 // API Overload 1: Explicit data file path/name
 //   Implemented as a wrapper to API Overload 2:
@@ -20,17 +106,62 @@ DataFrame< double > Embed ( std::string path     = "",
 // API Overload 2: DataFrame provided
 //   Implemented as a wrapper for MakeBlock()
 //----------------------------------------------------------------
-DataFrame< double > Embed ( DataFrame< double > dataFrame,
-                            int                 E       = 0,
-                            int                 tau     = 0,
-                            std::string         columns = "",
-                            bool                verbose = false );
+DataFrame< double > Embed ( const DataFrameView< double > &dataFrame,
+                            int                            E       = 0,
+                            int                            tau     = 0,
+                            std::string                    columns = "",
+                            bool                           verbose = false,
+                            ExecutionContext exec = ExecutionContext() );
+
+// float32 values: the embedding is float32
+DataFrame< float > Embed ( const DataFrameView< float > &dataFrame,
+                           int                           E       = 0,
+                           int                           tau     = 0,
+                           std::string                   columns = "",
+                           bool                          verbose = false,
+                           ExecutionContext exec = ExecutionContext() );
 
 //----------------------------------------------------------------
+// Embedding of DataFrame columns as Embed() that is not copied:
+// the EmbeddingView reads the dataFrame values in place
+//----------------------------------------------------------------
+EmbeddingView< double > EmbedView(
+    const DataFrameView< double > &dataFrame,
+    int                            E       = 0,
+    int                            tau     = 0,
+    std::string                    columns = "",
+    bool                           verbose = false );
+
+EmbeddingView< float > EmbedView(
+    const DataFrameView< float > &dataFrame,
+    int                           E       = 0,
+    int                           tau     = 0,
+    std::string                   columns = "",
+    bool                          verbose = false );
+
 //----------------------------------------------------------------
-DataFrame< double > MakeBlock ( DataFrame< double >      dataFrame,
-                                int                      E,
-                                int                      tau,
-                                std::vector<std::string> columnNames,
-                                bool                     verbose );
+// Embedding block of the dataFrame columns: each value written
+// once, blocks of rows on the thread pool. Rows are aligned and
+// zero padded, see DataFrame::Stride().
+//----------------------------------------------------------------
+DataFrame< double > MakeBlock ( const DataFrameView< double > &dataFrame,
+                                int                            E,
+                                int                            tau,
+                                std::vector<std::string>       columnNames,
+                                bool                           verbose,
+                                ExecutionContext exec = ExecutionContext() );
+
+DataFrame< float > MakeBlock ( const DataFrameView< float > &dataFrame,
+                               int                           E,
+                               int                           tau,
+                               std::vector<std::string>      columnNames,
+                               bool                          verbose,
+                               ExecutionContext exec = ExecutionContext() );
+
+// Embedding of an EmbeddingView copied into a DataFrame
+DataFrame< double > MakeBlock ( const EmbeddingView< double > &embedding,
+                                ExecutionContext exec = ExecutionContext() );
+
+DataFrame< float > MakeBlock ( const EmbeddingView< float > &embedding,
+                               ExecutionContext exec = ExecutionContext() );
 #endif
@@ -0,0 +1,441 @@
+
+#include <algorithm>
+
+#include "Library.h"
+
+namespace EDM_Library {
+    // A subtree with a child of more than alpha of its nodes is
+    // rebuilt: depth is at most log N / log( 1 / alpha ) + 1
+    const double alpha = 0.7;
+}
+
+//----------------------------------------------------------------
+KDTree::KDTree( size_t dimension ) :
+    dimension( dimension ), root( None ), nDeleted( 0 ) {}
+
+//----------------------------------------------------------------
+// Nodes on the longest path from the root
+//----------------------------------------------------------------
+size_t KDTree::Depth() const {
+    size_t depth = 0;
+    std::vector< std::pair< size_t, size_t > > stack;
+    if ( root != None ) {
+        stack.push_back( std::make_pair( root, (size_t) 1 ) );
+    }
+    while ( stack.size() ) {
+        std::pair< size_t, size_t > top = stack.back();
+        stack.pop_back();
+        depth = std::max( depth, top.second );
+
+        const Node &node = nodes[ top.first ];
+        if ( node.left != None ) {
+            stack.push_back( std::make_pair( node.left, top.second + 1 ) );
+        }
+        if ( node.right != None ) {
+            stack.push_back( std::make_pair( node.right, top.second + 1 ) );
+        }
+    }
+    return depth;
+}
+
+//----------------------------------------------------------------
+// Insert() : Descend to a leaf, then rebuild the highest subtree
+// on the path left out of alpha weight balance
+//----------------------------------------------------------------
+void KDTree::Insert( size_t id, const double *point ) {
+    size_t newNode = nodes.size();
+    Node   node    = { id, None, None, 1, 0, false };
+    nodes.push_back( node );
+    points.insert( points.end(), point, point + dimension );
+
+    if ( root == None ) {
+        root = newNode;
+        return;
+    }
+
+    path.clear();
+    size_t n = root;
+    while ( true ) {
+        path.push_back( n );
+        Node &parent = nodes[ n ];
+        parent.size++;
+
+        size_t &child = point[ parent.split ] < Point( n )[ parent.split ] ?
+                        parent.left : parent.right;
+        if ( child == None ) {
+            child = newNode;
+            break;
+        }
+        n = child;
+    }
+
+    for ( size_t i = 0; i < path.size(); i++ ) {
+        const Node &top = nodes[ path[ i ] ];
+        size_t heavy = std::max( SubtreeSize( top.left ),
+                                 SubtreeSize( top.right ) );
+        if ( heavy > EDM_Library::alpha * top.size ) {
+            size_t subtree = Rebuild( path[ i ] );
+            if ( i == 0 ) {
+                root = subtree;
+            }
+            else if ( nodes[ path[ i - 1 ] ].left == path[ i ] ) {
+                nodes[ path[ i - 1 ] ].left = subtree;
+            }
+            else {
+                nodes[ path[ i - 1 ] ].right = subtree;
+            }
+            break;
+        }
+    }
+}
+
+//----------------------------------------------------------------
+// Rebuild the subtree of node balanced, return its new root
+//----------------------------------------------------------------
+size_t KDTree::Rebuild( size_t node ) {
+    subtree.clear();
+    subtree.push_back( node );
+
+    for ( size_t i = 0; i < subtree.size(); i++ ) {
+        const Node &n = nodes[ subtree[ i ] ];
+        if ( n.left  != None ) { subtree.push_back( n.left  ); }
+        if ( n.right != None ) { subtree.push_back( n.right ); }
+    }
+    return Build( subtree.data(), subtree.data() + subtree.size() );
+}
+
+//----------------------------------------------------------------
+// Remove() : Mark the node of id deleted. Compact the tree once
+// deleted nodes outnumber the points.
+//----------------------------------------------------------------
+bool KDTree::Remove( size_t id, const double *point ) {
+    size_t node = Find( root, id, point );
+    if ( node == None ) {
+        return false;
+    }
+
+    nodes[ node ].deleted = true;
+    nDeleted++;
+
+    if ( nDeleted > Size() ) {
+        Compact();
+    }
+    return true;
+}
+
+//----------------------------------------------------------------
+// Node of id with values point in the subtree of node, or None.
+// Values equal to a split may be on either side of it.
+//----------------------------------------------------------------
+size_t KDTree::Find( size_t        node,
+                     size_t        id,
+                     const double *point ) const {
+    if ( node == None ) {
+        return None;
+    }
+
+    const Node &n = nodes[ node ];
+    if ( n.id == id and not n.deleted ) {
+        return node;
+    }
+
+    double value = Point( node )[ n.split ];
+    if ( point[ n.split ] < value ) {
+        return Find( n.left, id, point );
+    }
+    if ( point[ n.split ] > value ) {
+        return Find( n.right, id, point );
+    }
+
+    size_t left = Find( n.left, id, point );
+    return left != None ? left : Find( n.right, id, point );
+}
+
+//----------------------------------------------------------------
+// Drop deleted nodes in place, rebuild the tree of the points
+//----------------------------------------------------------------
+void KDTree::Compact() {
+    size_t live = 0;
+    for ( size_t node = 0; node < nodes.size(); node++ ) {
+        if ( nodes[ node ].deleted ) {
+            continue;
+        }
+        if ( node != live ) {
+            nodes[ live ] = nodes[ node ];
+            std::copy( Point( node ), Point( node ) + dimension,
+                       points.begin() + live * dimension );
+        }
+        live++;
+    }
+    nodes.resize( live );
+    points.resize( live * dimension );
+    nDeleted = 0;
+
+    subtree.resize( live );
+    for ( size_t node = 0; node < live; node++ ) {
+        subtree[ node ] = node;
+    }
+    root = Build( subtree.data(), subtree.data() + live );
+}
+
+//----------------------------------------------------------------
+// Subtree of nodes [begin, end): split at the median of the
+// dimension of largest spread. Returns the subtree root.
+//----------------------------------------------------------------
+size_t KDTree::Build( size_t *begin, size_t *end ) {
+    if ( begin == end ) {
+        return None;
+    }
+
+    size_t split  = 0;
+    double spread = -1;
+    for ( size_t d = 0; d < dimension; d++ ) {
+        double low  = Point( *begin )[ d ];
+        double high = low;
+        for ( size_t *n = begin + 1; n < end; n++ ) {
+            low  = std::min( low,  Point( *n )[ d ] );
+            high = std::max( high, Point( *n )[ d ] );
+        }
+        if ( high - low > spread ) {
+            spread = high - low;
+            split  = d;
+        }
+    }
+
+    size_t *median = begin + ( end - begin ) / 2;
+    std::nth_element( begin, median, end, [&]( size_t a, size_t b ) {
+        return Point( a )[ split ] < Point( b )[ split ];
+    } );
+
+    Node &node = nodes[ *median ];
+    node.split = split;
+    node.size  = end - begin;
+    node.left  = Build( begin, median );
+    node.right = Build( median + 1, end );
+
+    return *median;
+}
+
+//----------------------------------------------------------------
+// Nearest() : Branch and bound search from the root. The subtree
+// across a split is searched only if the split is nearer than the
+// knn-th candidate.
+//----------------------------------------------------------------
+size_t KDTree::Nearest( const double *query,
+                        size_t        knn,
+                        size_t       *ids,
+                        double       *distances ) const {
+
+    thread_local std::vector< Candidate > heap;
+    heap.clear();
+    heap.reserve( knn );
+
+    if ( knn ) {
+        Search( root, query, knn, heap );
+    }
+
+    std::sort_heap( heap.begin(), heap.end() );
+
+    for ( size_t k = 0; k < heap.size(); k++ ) {
+        ids      [ k ] = heap[ k ].second;
+        distances[ k ] = sqrt( heap[ k ].first );
+    }
+    return heap.size();
+}
+
+//----------------------------------------------------------------
+void KDTree::Search( size_t                    node,
+                     const double             *query,
+                     size_t                    knn,
+                     std::vector< Candidate > &heap ) const {
+    if ( node == None ) {
+        return;
+    }
+
+    const Node   &n     = nodes[ node ];
+    const double *point = Point( node );
+
+    // Deleted nodes only split the space
+    if ( not n.deleted ) {
+        // Summed in dimension order, as Distance()
+        double sum = 0;
+        for ( size_t d = 0; d < dimension; d++ ) {
+            double delta = point[ d ] - query[ d ];
+            sum += delta * delta;
+        }
+
+        Candidate candidate( sum, n.id );
+        if ( heap.size() < knn ) {
+            heap.push_back( candidate );
+            std::push_heap( heap.begin(), heap.end() );
+        }
+        else if ( candidate < heap.front() ) {
+            std::pop_heap( heap.begin(), heap.end() );
+            heap.back() = candidate;
+            std::push_heap( heap.begin(), heap.end() );
+        }
+    }
+
+    double delta = query[ n.split ] - point[ n.split ];
+    size_t near  = delta < 0 ? n.left  : n.right;
+    size_t far   = delta < 0 ? n.right : n.left;
+
+    Search( near, query, knn, heap );
+
+    if ( heap.size() < knn or delta * delta <= heap.front().first ) {
+        Search( far, query, knn, heap );
+    }
+}
+
+//----------------------------------------------------------------
+// StreamLibrary
+//----------------------------------------------------------------
+StreamLibrary::StreamLibrary( int    E,
+                              int    Tp,
+                              int    tau,
+                              size_t nColumns,
+                              size_t window,
+                              size_t nTargets ) :
+    E( E ), Tp( Tp ), tau( tau ), nColumns( nColumns ),
+    nTargets( nTargets ), stride( nColumns + nTargets ), window( window ),
+    shift( E > 0 and tau > 0 ? ( E - 1 ) * tau : 0 ), first( 0 ),
+    state( E > 0 ? E * nColumns : 0 ), tree( E > 0 ? E * nColumns : 0 )
+{
+    if ( E < 1 or tau < 1 or Tp < 1 or nColumns < 1 ) {
+        std::stringstream errMsg;
+        errMsg << "StreamLibrary(): E (" << E << "), tau (" << tau
+               << "), Tp (" << Tp << ") and the number of columns ("
+               << nColumns << ") must be positive." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+    if ( window and window <= shift + Tp ) {
+        std::stringstream errMsg;
+        errMsg << "StreamLibrary(): The window (" << window << ") must "
+               << "exceed (E-1) tau + Tp (" << shift + Tp << ") to hold "
+               << "library rows." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+    if ( window ) {
+        values.reserve( 2 * window * stride );
+    }
+}
+
+//----------------------------------------------------------------
+void StreamLibrary::Append( double value ) {
+    if ( stride != 1 ) {
+        std::stringstream errMsg;
+        errMsg << "StreamLibrary::Append(): The observation has 1 value,"
+               << " the library " << stride << " columns." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+    Append( &value );
+}
+
+//----------------------------------------------------------------
+void StreamLibrary::Append( const std::vector< double > &observation ) {
+    if ( observation.size() != stride ) {
+        std::stringstream errMsg;
+        errMsg << "StreamLibrary::Append(): The observation has "
+               << observation.size() << " values, the library "
+               << stride << " columns." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+    Append( observation.data() );
+}
+
+//----------------------------------------------------------------
+// Append() : Add the observation row. Library row t - Tp has its
+// target, observation t: its state vector is inserted in the tree.
+// In a window, row t - window + (E-1) tau has its oldest lag leave
+// the window: it is removed. The window rows are kept once twice
+// the window is held, observations are not moved on each Append().
+//----------------------------------------------------------------
+void StreamLibrary::Append( const double *observation ) {
+    values.insert( values.end(), observation, observation + stride );
+
+    size_t t = NRows() - 1;
+    if ( t >= shift + Tp ) {
+        StateVector( t - Tp, state.data() );
+        tree.Insert( t - Tp, state.data() );
+    }
+
+    if ( window and t >= window ) {
+        StateVector( t - window + shift, state.data() );
+        tree.Remove( t - window + shift, state.data() );
+
+        if ( values.size() >= 2 * window * stride ) {
+            size_t drop = values.size() / stride - window;
+            values.erase( values.begin(), values.begin() + drop * stride );
+            first += drop;
+        }
+    }
+}
+
+//----------------------------------------------------------------
+void StreamLibrary::StateVector( size_t row, double *state ) const {
+    if ( not Embedded( row ) ) {
+        std::stringstream errMsg;
+        errMsg << "StreamLibrary::StateVector(): Row " << row
+               << " is not embedded: rows " << first + shift << " to "
+               << NRows() << " are." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    for ( size_t col = 0; col < nColumns; col++ ) {
+        for ( int e = 0; e < E; e++ ) {
+            state[ col * E + e ] = Observation( row - e * tau, col );
+        }
+    }
+}
+
+//----------------------------------------------------------------
+std::vector< double > StreamLibrary::State() const {
+    std::vector< double > state( Dimension() );
+    StateVector( NRows() ? NRows() - 1 : 0, state.data() );
+    return state;
+}
+
+//----------------------------------------------------------------
+Neighbors StreamLibrary::Nearest( size_t knn ) const {
+    return Nearest( State(), knn );
+}
+
+//----------------------------------------------------------------
+Neighbors StreamLibrary::Nearest( const std::vector< double > &state,
+                                  size_t                       knn ) const {
+    if ( state.size() != Dimension() ) {
+        std::stringstream errMsg;
+        errMsg << "StreamLibrary::Nearest(): The state vector has "
+               << state.size() << " values, the embedding "
+               << Dimension() << "." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    std::vector< size_t > ids( knn );
+    std::vector< double > distances( knn );
+    Nearest( state.data(), knn, ids.data(), distances.data() );
+
+    Neighbors neighbors;
+    neighbors.neighbors = DataFrame< size_t >( 1, knn );
+    neighbors.distances = DataFrame< double >( 1, knn );
+    for ( size_t k = 0; k < knn; k++ ) {
+        neighbors.neighbors( 0, k ) = ids[ k ];
+        neighbors.distances( 0, k ) = distances[ k ];
+    }
+    return neighbors;
+}
+
+//----------------------------------------------------------------
+void StreamLibrary::Nearest( const double *state,
+                             size_t        knn,
+                             size_t       *rows,
+                             double       *distances ) const {
+    if ( knn < 1 or tree.Size() < knn ) {
+        std::stringstream errMsg;
+        errMsg << "StreamLibrary::Nearest(): Library of " << tree.Size()
+               << " rows is too small to resolve " << knn
+               << " knn neighbors." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+    tree.Nearest( state, knn, rows, distances );
+}
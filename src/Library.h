@@ -0,0 +1,190 @@
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Common.h"
+#include "Neighbors.h"
+
+//----------------------------------------------------------------
+// KDTree
+// k-d tree of points of Dimension() values, for knn queries that
+// visit O(log N) nodes on low dimension data, not the N library
+// rows of FindNeighbors().
+//
+// Points are inserted one at a time. A subtree left out of weight
+// balance by an insertion is rebuilt on median splits (a scapegoat
+// tree): the depth stays O(log N), an insertion descends O(log N)
+// nodes and rebuilds cost O(log^2 N) amortized.
+//
+// Removed points are marked deleted in place, found by descending
+// the tree with their values in O(log N). Once deleted nodes
+// outnumber the points the tree is compacted and rebuilt, O(log N)
+// amortized per removal: nodes are at most twice the points.
+// Rebuilds reuse the node storage, so a tree of steady size does
+// not allocate.
+//----------------------------------------------------------------
+class KDTree {
+
+public:
+    KDTree( size_t dimension = 0 );
+
+    size_t Dimension() const { return dimension;    }
+    size_t Size()      const { return nodes.size() - nDeleted; }
+    size_t Depth()     const;
+
+    // Insert point id of Dimension() values
+    void Insert( size_t id, const double *point );
+
+    // Remove point id of the values inserted. false if not found.
+    bool Remove( size_t id, const double *point );
+
+    // knn points nearest to query, nearest first, ties by id:
+    // their ids and Euclidean distances. Returns the number found:
+    // knn, or Size() if less. The search heap is held per thread:
+    // queries of a steady knn do not allocate.
+    size_t Nearest( const double *query,
+                    size_t        knn,
+                    size_t       *ids,
+                    double       *distances ) const;
+
+private:
+    static const size_t None = SIZE_MAX;
+
+    struct Node {
+        size_t id;
+        size_t left;
+        size_t right;
+        size_t size;  // nodes in the subtree, deleted included
+        size_t split; // dimension of the split
+        bool   deleted;
+    };
+
+    size_t                dimension;
+    size_t                root;
+    size_t                nDeleted;
+    std::vector< Node >   nodes;
+    std::vector< double > points;  // node i values at i * dimension
+    std::vector< size_t > path;    // of Insert()
+    std::vector< size_t > subtree; // nodes of Rebuild()
+
+    const double *Point( size_t node ) const {
+        return &points[ node * dimension ];
+    }
+    size_t SubtreeSize( size_t node ) const {
+        return node == None ? 0 : nodes[ node ].size;
+    }
+
+    // Max-heap of ( squared distance, id ) of Nearest()
+    typedef std::pair< double, size_t > Candidate;
+
+    size_t Rebuild( size_t node );
+    size_t Build( size_t *begin, size_t *end );
+    size_t Find( size_t node, size_t id, const double *point ) const;
+    void   Compact();
+    void   Search( size_t node, const double *query, size_t knn,
+                   std::vector< Candidate > &heap ) const;
+};
+
+//----------------------------------------------------------------
+// StreamLibrary
+// Library of the delay embedding of observations that arrive one
+// at a time. Append() extends the embedding by the row of the new
+// observation, and inserts into a KDTree the library row whose
+// target, Tp rows ahead, is the new observation. Nearest() of the
+// newest state vector then costs O(log N), where FindNeighbors()
+// over the rebuilt embedding costs O(N E).
+//
+// Row t is the state vector of observation t: the values of each
+// column at t, t - tau, ... t - (E-1) tau, in Embed() column order.
+// The first (E-1) tau rows are partial, not embedded. Neighbors
+// are observation rows, as FindNeighbors() of the embedding with
+// all embedded rows in the library and the newest as prediction.
+//
+// window > 0 : the library is of the last window observations, as
+// the embedding of a DataFrame of those rows: each Append() also
+// removes the library row whose oldest lag leaves the window.
+// Memory and query time are bounded by the window, observations
+// before it are dropped.
+//
+// nTargets : columns held after the nColumns embedded columns, not
+// embedded, as forecast targets. Observations are of nColumns +
+// nTargets values.
+//----------------------------------------------------------------
+class StreamLibrary {
+
+public:
+    StreamLibrary( int    E,
+                   int    Tp       = 1,
+                   int    tau      = 1,
+                   size_t nColumns = 1,
+                   size_t window   = 0,
+                   size_t nTargets = 0 );
+
+    // Observation of one column
+    void Append( double value );
+
+    // Observation of nColumns + nTargets values
+    void Append( const std::vector< double > &observation );
+    void Append( const double                *observation );
+
+    int    Tau()                const { return tau;      }
+    int    PredictionInterval() const { return Tp;       }
+    size_t NColumns()           const { return nColumns; }
+    size_t NTargets()           const { return nTargets; }
+    size_t Window()             const { return window;   }
+    size_t LibrarySize()        const { return tree.Size(); }
+
+    // Observations appended, and the first still held
+    size_t NRows()    const { return first + values.size() / stride; }
+    size_t FirstRow() const { return first; }
+
+    // Values of a state vector: E x NColumns()
+    size_t Dimension() const { return tree.Dimension(); }
+
+    double Observation( size_t row, size_t column = 0 ) const {
+        return values[ ( row - first ) * stride + column ];
+    }
+
+    // true if row has a state vector: (E-1) tau prior observations
+    // held
+    bool Embedded( size_t row ) const {
+        return row >= first + shift and row < NRows();
+    }
+
+    // Dimension() values of the state vector of row
+    void StateVector( size_t row, double *state ) const;
+
+    // State vector of the newest observation
+    std::vector< double > State() const;
+
+    // knn library rows nearest to the newest state vector, or to
+    // state. 1 x knn neighbors and distances, nearest first.
+    Neighbors Nearest( size_t knn ) const;
+    Neighbors Nearest( const std::vector< double > &state,
+                       size_t                       knn ) const;
+
+    // As Nearest() of state, into knn rows and distances. Does not
+    // allocate: for queries in a serving loop.
+    void Nearest( const double *state,
+                  size_t        knn,
+                  size_t       *rows,
+                  double       *distances ) const;
+
+private:
+    int                   E;
+    int                   Tp;
+    int                   tau;
+    size_t                nColumns;
+    size_t                nTargets;
+    size_t                stride; // values per observation
+    size_t                window;
+    size_t                shift;  // (E-1) tau
+    size_t                first;  // observation row of values[ 0 ]
+    std::vector< double > values; // observations, row-major
+    std::vector< double > state;  // of Append()
+    KDTree                tree;
+
+};
+#endif
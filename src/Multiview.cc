@@ -1,17 +1,13 @@
 
-#include <thread>
-#include <atomic>
 #include <mutex>
 
 #include "Common.h"
 #include "AuxFunc.h"
 
 namespace EDM_Multiview {
-    // Thread Work Queue : Vector of combos indices
+    // Work Queue : Vector of combos indices, evaluated on the thread pool
     typedef std::vector< int > WorkQueue;
     
-    // atomic counter for all threads
-    std::atomic<std::size_t> eval_i(0); // initialize to 0
     std::mutex mtx;
 }
 
@@ -24,12 +20,13 @@ DataFrame<double> SimplexProjection( Parameters  param,
                                      DataEmbedNN embedNN,
                                      bool        checkDataRows = true );
 
-void EvalComboThread( Parameters                            param,
-                      EDM_Multiview::WorkQueue              workQ,
-                      std::vector< std::vector< size_t > >  combos,
-                      DataFrame< double >                  &data,
-                      DataFrame< double >                  &combos_rho,
-                      std::vector< DataFrame< double > >   &prediction );
+void EvalComboTask( size_t                                      eval_i,
+                    const Parameters                           &param,
+                    const EDM_Multiview::WorkQueue             &workQ,
+                    const std::vector< std::vector< size_t > > &combos,
+                    const DataFrameView< double >              &data,
+                    DataFrame< double >                        &combos_rho,
+                    std::vector< DataFrame< double > >         &prediction );
 
 //----------------------------------------------------------------
 // Multiview() : Evaluate Simplex rho vs. dimension E
@@ -50,9 +47,11 @@ MultiviewValues Multiview( std::string pathIn,
                            std::string target,
                            int         multiview,
                            bool        verbose,
-                           unsigned    nThreads ) {
+                           unsigned    nThreads,
+                           ExecutionContext exec ) {
 
     // Create DataFrame (constructor loads data)
+    // All columns: combos index the data columns by position
     DataFrame< double > dataFrameIn( pathIn, dataFile );
     
     MultiviewValues result = Multiview( dataFrameIn,
@@ -68,7 +67,8 @@ MultiviewValues Multiview( std::string pathIn,
                                         target,
                                         multiview,
                                         verbose,
-                                        nThreads );
+                                        nThreads,
+                                        exec );
     return result;
 }
 
@@ -76,20 +76,21 @@ MultiviewValues Multiview( std::string pathIn,
 // Multiview()
 // API Overload 2: DataFrame provided
 //----------------------------------------------------------------
-MultiviewValues  Multiview( DataFrame< double > data,
-                            std::string         pathOut,
-                            std::string         predictFile,
-                            std::string         lib,
-                            std::string         pred,
-                            int                 E,
-                            int                 Tp,
-                            int                 knn,
-                            int                 tau,
-                            std::string         columns,
-                            std::string         target,
-                            int                 multiview,
-                            bool                verbose,
-                            unsigned            nThreads ) {
+MultiviewValues  Multiview( const DataFrameView< double > &data,
+                            std::string                    pathOut,
+                            std::string                    predictFile,
+                            std::string                    lib,
+                            std::string                    pred,
+                            int                            E,
+                            int                            Tp,
+                            int                            knn,
+                            int                            tau,
+                            std::string                    columns,
+                            std::string                    target,
+                            int                            multiview,
+                            bool                           verbose,
+                            unsigned                       nThreads,
+                            ExecutionContext               exec ) {
 
     // Create local Parameters struct. Note embedded = true
     Parameters param = Parameters( Method::Simplex, "", "",
@@ -97,6 +98,9 @@ MultiviewValues  Multiview( DataFrame< double > data,
                                    lib, pred, E, Tp, knn, tau, 0,
                                    columns, target, true, verbose,
                                    "", "", "", 0, 0, 0, multiview );
+
+    // nThreads limits the concurrency of this call on the pool
+    param.exec = exec.Limit( nThreads );
     
     if ( not param.columnNames.size() ) {
         throw std::runtime_error( "Multiview() requires column names." );
@@ -178,25 +182,15 @@ MultiviewValues  Multiview( DataFrame< double > data,
         workQ[ i ] = i;
     }
 
-    unsigned maxThreads = std::thread::hardware_concurrency();
-    if ( maxThreads < nThreads ) { nThreads = maxThreads; }
-    
-    // thread container
-    std::vector< std::thread > threads;
-    for ( unsigned i = 0; i < nThreads; ++i ) {
-        threads.push_back( std::thread( EvalComboThread,
-                                        param,
-                                        workQ,
-                                        combos,
-                                        std::ref( data ),
-                                        std::ref( combos_rho ),
-                                        std::ref( combos_prediction ) ) );
-    }
-    
-    // join threads
-    for ( auto &thrd : threads ) {
-        thrd.join();
-    }
+    // Evaluate combos on the thread pool. FindNeighbors() inside each
+    // combo task distributes its rows over the same pool.
+    param.exec.Pool().ParallelFor(
+        workQ.size(),
+        [&]( size_t i ) {
+            EvalComboTask( i, param, workQ, combos, data,
+                           combos_rho, combos_prediction );
+        },
+        param.exec.nThreads );
 
     //-----------------------------------------------------------------
     // Rank in-sample (library) forecasts
@@ -276,22 +270,13 @@ MultiviewValues  Multiview( DataFrame< double > data,
         workQ_pred[ i ] = i;
     }
 
-    // thread container
-    std::vector< std::thread > threads_pred;
-    for ( unsigned i = 0; i < nThreads; ++i ) {
-        threads_pred.push_back( std::thread( EvalComboThread,
-                                             param,
-                                             workQ_pred,
-                                             combos_best,
-                                             std::ref( data ),
-                                             std::ref( combos_rho_pred ),
-                                             std::ref( combos_rho_prediction)));
-    }
-    
-    // join threads
-    for ( auto &thrd : threads_pred ) {
-        thrd.join();
-    }
+    param.exec.Pool().ParallelFor(
+        workQ_pred.size(),
+        [&]( size_t i ) {
+            EvalComboTask( i, param, workQ_pred, combos_best, data,
+                           combos_rho_pred, combos_rho_prediction );
+        },
+        param.exec.nThreads );
     
 #ifdef DEBUG_ALL
     for ( auto cpi =  combos_rho_prediction.begin();
@@ -357,90 +342,78 @@ MultiviewValues  Multiview( DataFrame< double > data,
 }
 
 //----------------------------------------------------------------
-// Worker thread
+// Worker task
 // Output: Write rho to combos_rho DataFrame,
 //         Simplex results to combos_prediction
 //----------------------------------------------------------------
-void EvalComboThread( Parameters                            param,
-                      EDM_Multiview::WorkQueue              workQ,
-                      std::vector< std::vector< size_t > >  combos,
-                      DataFrame< double >                  &data,
-                      DataFrame< double >                  &combos_rho,
-                      std::vector< DataFrame< double > >   &combos_prediction )
+void EvalComboTask( size_t                                      eval_i,
+                    const Parameters                           &param,
+                    const EDM_Multiview::WorkQueue             &workQ,
+                    const std::vector< std::vector< size_t > > &combos,
+                    const DataFrameView< double >              &data,
+                    DataFrame< double >                        &combos_rho,
+                    std::vector< DataFrame< double > >    &combos_prediction )
 {
-    // atomic_fetch_add(): Adds val to the contained value and returns
-    // the value it had immediately before the operation.
-    std::size_t eval_i =
-        std::atomic_fetch_add( &EDM_Multiview::eval_i, std::size_t(1) );
-
-    while( eval_i < workQ.size() ) {
-        
-        // WorkQueue stores combo index in combos
-        size_t combo_i = workQ[ eval_i ];
-      
-        // Get the combo for this thread
-        std::vector< size_t > combo = combos[ combo_i ];
+    // WorkQueue stores combo index in combos
+    size_t combo_i = workQ[ eval_i ];
+  
+    // Get the combo for this thread
+    std::vector< size_t > combo = combos[ combo_i ];
 
 #ifdef DEBUG_ALL
-        {
-            std::lock_guard<std::mutex> lck( EDM_Multiview::mtx );
-            std::cout << "EvalComboThread() Thread ["
-                      << std::this_thread::get_id() << "] ";
-            //std::cout << data;
-            std::cout << "combo: [";
-            for ( auto i = 0; i < combo.size(); i++ ) {
-                std::cout << combo[i] << ",";
-            } std::cout << "]  rho = ";
-        }
+    {
+        std::lock_guard<std::mutex> lck( EDM_Multiview::mtx );
+        std::cout << "EvalComboTask() Thread ["
+                  << std::this_thread::get_id() << "] ";
+        //std::cout << data;
+        std::cout << "combo: [";
+        for ( auto i = 0; i < combo.size(); i++ ) {
+            std::cout << combo[i] << ",";
+        } std::cout << "]  rho = ";
+    }
 #endif
 
-        // Select combo columns from the data
-        DataFrame<double> comboData = data.DataFrameFromColumnIndex( combo );
-    
-        // Compute neighbors on comboData
-        Neighbors neighbors = FindNeighbors( comboData, param );
-    
-        std::valarray<double> targetVec =
-            data.VectorColumnName( param.targetName );
+    // Select combo columns from the data
+    DataFrame<double> comboData( data.Columns( combo ) );
+
+    // Compute neighbors on comboData
+    Neighbors neighbors = FindNeighbors( comboData, param );
+
+    std::valarray<double> targetVec =
+        data.VectorColumnName( param.targetName );
+
+    // Pack embedding, target, neighbors for SimplexProjection
+    DataEmbedNN embedNN = DataEmbedNN( data, comboData,
+                                       targetVec, neighbors );
     
-        // Pack embedding, target, neighbors for SimplexProjection
-        DataEmbedNN embedNN = DataEmbedNN( data, comboData,
-                                           targetVec, neighbors );
-        
-        // combo prediction
-        DataFrame<double> S = SimplexProjection( param, embedNN );
+    // combo prediction
+    DataFrame<double> S = SimplexProjection( param, embedNN );
 
-        // Write combo prediction DataFrame
-        combos_prediction[ eval_i ] = S;
+    // Write combo prediction DataFrame
+    combos_prediction[ eval_i ] = S;
 
-        // Evaluate combo prediction
-        VectorError ve = ComputeError( S.VectorColumnName( "Observations" ),
-                                       S.VectorColumnName( "Predictions"  ) );
+    // Evaluate combo prediction
+    VectorError ve = ComputeError( S.VectorColumnName( "Observations" ),
+                                   S.VectorColumnName( "Predictions"  ) );
 
 #ifdef DEBUG_ALL
-        {
-            std::lock_guard<std::mutex> lck( EDM_Multiview::mtx );
-            std::cout << ve.rho << std::endl;
-        }
+    {
+        std::lock_guard<std::mutex> lck( EDM_Multiview::mtx );
+        std::cout << ve.rho << std::endl;
+    }
 #endif
 
-        // Write combo and rho to the Data Frame
-        // E columns (a combo), and rho
-        std::valarray< double > combo_row( combo.size() + 3 );
-        for ( auto i = 0; i < combo.size(); i++ ) {
-            combo_row[ i ] = combo[ i ];
-        }
-        combo_row[ combo.size()     ] = ve.rho;
-        combo_row[ combo.size() + 1 ] = ve.MAE;
-        combo_row[ combo.size() + 2 ] = ve.RMSE;
-        
-        combos_rho.WriteRow( eval_i, combo_row );
-        
-        eval_i = std::atomic_fetch_add(&EDM_Multiview::eval_i, std::size_t(1));
+    // Write combo and rho to the Data Frame
+    // E columns (a combo), and rho
+    std::valarray< double > combo_row( combo.size() + 3 );
+    for ( auto i = 0; i < combo.size(); i++ ) {
+        combo_row[ i ] = combo[ i ];
     }
+    combo_row[ combo.size()     ] = ve.rho;
+    combo_row[ combo.size() + 1 ] = ve.MAE;
+    combo_row[ combo.size() + 2 ] = ve.RMSE;
     
-    // Reset counter
-    std::atomic_store( &EDM_Multiview::eval_i, std::size_t(0) );
+    combos_rho.WriteRow( eval_i, combo_row );
 }
 
 //----------------------------------------------------------------
@@ -1,43 +1,315 @@
 
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <unistd.h>
+
 #include "Neighbors.h"
 
 //----------------------------------------------------------------
 Neighbors:: Neighbors() {}
 Neighbors::~Neighbors() {}
 
+namespace EDM_Neighbors {
+    //------------------------------------------------------------
+    // FindNeighbors(), FindNeighborRows() of DataFrame values of
+    // type T. Distances of float rows are summed in float.
+    //------------------------------------------------------------
+    template < class T >
+    Neighbors FindNeighbors( const DataFrame<T> &dataFrame,
+                             Parameters          parameters );
+
+    template < class T >
+    Neighbors FindNeighbors( const EmbeddingView<T> &embedding,
+                             Parameters              parameters );
+
+    template < class T >
+    void FindNeighborRows( const DataFrame<T> &dataFrame,
+                           const Parameters   &parameters,
+                           Neighbors          &neighbors,
+                           size_t              rowStart,
+                           size_t              rowStop,
+                           size_t              rowOffset );
+
+    template < class T >
+    double Distance( const T       *v1,
+                     const T       *v2,
+                     size_t         N,
+                     DistanceMetric metric );
+
+    //------------------------------------------------------------
+    // Neighbor search of Rows: of a DataFrame or an EmbeddingView.
+    // Rows provide the values of a prediction row, and Distance()
+    // of a library row to them.
+    //------------------------------------------------------------
+    template < class Rows >
+    Neighbors Search( const Rows &rows,
+                      size_t      N_columns,
+                      Parameters  parameters );
+
+    template < class Rows >
+    void SearchRows( const Rows       &rows,
+                     const Parameters &parameters,
+                     Neighbors        &neighbors,
+                     size_t            rowStart,
+                     size_t            rowStop,
+                     size_t            rowOffset );
+
+    //------------------------------------------------------------
+    // Neighbor index file
+    //------------------------------------------------------------
+    const char     indexMagic[ 8 ] = { 'c','p','p','E','D','M','N','N' };
+    const uint32_t indexByteOrder  = 0x01020304;
+    const uint64_t indexAlignment  = 64;
+
+    struct IndexHeader {
+        char     magic[ 8 ];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t n_rows;
+        uint64_t knn;
+        uint64_t keyLength;
+        uint64_t dataOffset;
+        uint64_t digest[ 2 ];
+    };
+
+    //------------------------------------------------------------
+    // ValuesHash of the library rows and distances of an index
+    // file, read as uint64_t words
+    //------------------------------------------------------------
+    ValuesHash IndexDigest( const char *rows,
+                            const char *distances,
+                            size_t      values ) {
+        ValuesHash hash;
+        for ( size_t i = 0; i < values; i++ ) {
+            uint64_t row;
+            uint64_t distance;
+            memcpy( &row,      rows      + i * sizeof( uint64_t ),
+                    sizeof( row ) );
+            memcpy( &distance, distances + i * sizeof( double ),
+                    sizeof( distance ) );
+            hash.Add( row );
+            hash.Add( distance );
+        }
+        return hash;
+    }
+
+    //------------------------------------------------------------
+    // Rows of a row-major DataFrame read in place: Stride() values,
+    // with the zero padding of aligned rows
+    //------------------------------------------------------------
+    template < class T >
+    class FrameRows {
+        const T *values;
+        size_t   stride;
+    public:
+        typedef T Value;
+
+        FrameRows( const DataFrame<T> &dataFrame ) :
+            values( dataFrame.Data() ), stride( dataFrame.Stride() ) {
+            if ( dataFrame.Layout() != DataFrameLayout::RowMajor ) {
+                std::string errMsg( "FindNeighborRows(): "
+                                    "dataFrame not row-major." );
+                throw std::runtime_error( errMsg );
+            }
+        }
+
+        size_t Width() const { return 0; } // rows are not copied
+
+        const T *Row( size_t row, T * ) const {
+            return values + row * stride;
+        }
+        double Distance( size_t row, const T *v ) const {
+            return EDM_Neighbors::Distance( values + row * stride, v,
+                                            stride,
+                                            DistanceMetric::Euclidean );
+        }
+    };
+
+    //------------------------------------------------------------
+    // Rows of an EmbeddingView: prediction rows are copied, library
+    // rows read from the embedded columns at each lag. Sums are in
+    // MakeBlock() row order: equal to Distance() of the rows.
+    //------------------------------------------------------------
+    template < class T >
+    class EmbeddingRows {
+        const EmbeddingView<T> &embedding;
+        size_t                  shift;  // tau * (E-1)
+        size_t                  lag;    // offset of a tau delay
+    public:
+        typedef T Value;
+
+        EmbeddingRows( const EmbeddingView<T> &embedding ) :
+            embedding( embedding ),
+            shift( embedding.Tau() * ( embedding.Dimension() - 1 ) ),
+            lag  ( embedding.Tau() * embedding.RowStride() ) {}
+
+        size_t Width() const { return embedding.NColumns(); }
+
+        const T *Row( size_t row, T *buffer ) const {
+            embedding.Row( row, buffer );
+            return buffer;
+        }
+        double Distance( size_t row, const T *v ) const {
+            size_t E      = embedding.Dimension();
+            size_t offset = ( row + shift ) * embedding.RowStride();
+            T      sum    = 0;
+            for ( size_t col = 0; col < Width() / E; col++ ) {
+                const T *x = embedding.ColumnData( col );
+                for ( size_t e = 0; e < E; e++ ) {
+                    T delta = *v++ - x[ offset - e * lag ];
+                    sum += delta * delta;
+                }
+            }
+            return sqrt( sum );
+        }
+    };
+}
+
 //----------------------------------------------------------------
 // It is assumed that the data frame has only columns of data for
 // which knn will be computed.  The (time) column is not present.
 //----------------------------------------------------------------
-Neighbors FindNeighbors(
-    DataFrame<double> dataFrame,
-    Parameters        parameters )
+Neighbors FindNeighbors( const DataFrame<double> &dataFrame,
+                         Parameters               parameters )
+{
+    return EDM_Neighbors::FindNeighbors( dataFrame, parameters );
+}
+
+Neighbors FindNeighbors( const DataFrame<float> &dataFrame,
+                         Parameters              parameters )
+{
+    return EDM_Neighbors::FindNeighbors( dataFrame, parameters );
+}
+
+//----------------------------------------------------------------
+// Neighbors of the rows of an EmbeddingView: as FindNeighbors()
+// of MakeBlock() of the view, without the copy
+//----------------------------------------------------------------
+Neighbors FindNeighbors( const EmbeddingView<double> &embedding,
+                         Parameters                   parameters )
+{
+    return EDM_Neighbors::FindNeighbors( embedding, parameters );
+}
+
+Neighbors FindNeighbors( const EmbeddingView<float> &embedding,
+                         Parameters                  parameters )
+{
+    return EDM_Neighbors::FindNeighbors( embedding, parameters );
+}
+
+//----------------------------------------------------------------
+// Worker for FindNeighbors(): neighbors of prediction rows
+// [rowStart, rowStop) written into rows [rowStart - rowOffset,
+// rowStop - rowOffset) of neighbors: sized by the caller.
+// dataFrame rows are read in place: row-major, any Stride().
+//----------------------------------------------------------------
+void FindNeighborRows( const DataFrame<double> &dataFrame,
+                       const Parameters        &parameters,
+                       Neighbors               &neighbors,
+                       size_t                   rowStart,
+                       size_t                   rowStop,
+                       size_t                   rowOffset )
+{
+    EDM_Neighbors::FindNeighborRows( dataFrame, parameters, neighbors,
+                                     rowStart, rowStop, rowOffset );
+}
+
+void FindNeighborRows( const DataFrame<float> &dataFrame,
+                       const Parameters       &parameters,
+                       Neighbors              &neighbors,
+                       size_t                  rowStart,
+                       size_t                  rowStop,
+                       size_t                  rowOffset )
+{
+    EDM_Neighbors::FindNeighborRows( dataFrame, parameters, neighbors,
+                                     rowStart, rowStop, rowOffset );
+}
+
+//----------------------------------------------------------------
+// FindNeighbors() of DataFrame values of type T
+//----------------------------------------------------------------
+template < class T >
+Neighbors EDM_Neighbors::FindNeighbors( const DataFrame<T> &dataFrame,
+                                        Parameters          parameters )
 {
 
 #ifdef DEBUG_ALL
-    PrintDataFrameIn( dataFrame, parameters );
+    PrintDataFrameIn( DataFrame<double>( dataFrame ), parameters );
 #endif
 
+    // Aligned, zero padded rows for the distance kernel: shared,
+    // not copied, of MakeBlock() and the EmbedNN() data block
+    DataFrame<T> dataBlock =
+        dataFrame.ToLayout( DataFrameLayout::RowMajor, true );
+
+    return Search( FrameRows<T>( dataBlock ), dataFrame.NColumns(),
+                   parameters );
+}
+
+//----------------------------------------------------------------
+// FindNeighbors() of EmbeddingView values of type T
+//----------------------------------------------------------------
+template < class T >
+Neighbors EDM_Neighbors::FindNeighbors( const EmbeddingView<T> &embedding,
+                                        Parameters              parameters )
+{
+
+#ifdef DEBUG_ALL
+    PrintDataFrameIn( DataFrame<double>( MakeBlock( embedding ) ),
+                      parameters );
+#endif
+
+    if ( embedding.RowStride() == 1 ) {
+        return Search( EmbeddingRows<T>( embedding ), embedding.NColumns(),
+                       parameters );
+    }
+
+    // Columns of a row-major DataFrame are strided: the embedded
+    // columns are copied to contiguous columns, N values each, not
+    // the N x E values of the embedding, for unit stride lags
+    const DataFrameView<T> &view = embedding.View();
+    DataFrame<T> columns( view.NRows(), view.NColumns(),
+                          DataFrameLayout::ColumnMajor );
+
+    for ( size_t col = 0; col < view.NColumns(); col++ ) {
+        const T *values = view.ColumnData( col );
+        T       *column = columns.Write( 0, col );
+        for ( size_t row = 0; row < view.NRows(); row++ ) {
+            column[ row ] = values[ row * view.RowStride() ];
+        }
+    }
+
+    EmbeddingView<T> contiguous( columns, embedding.Dimension(),
+                                 embedding.Tau(), embedding.Names() );
+
+    return Search( EmbeddingRows<T>( contiguous ), embedding.NColumns(),
+                   parameters );
+}
+
+//----------------------------------------------------------------
+// Neighbors of the prediction rows of rows: N_columns values
+//----------------------------------------------------------------
+template < class Rows >
+Neighbors EDM_Neighbors::Search( const Rows &rows,
+                                 size_t      N_columns,
+                                 Parameters  parameters )
+{
     if ( not parameters.validated ) {
         std::string errMsg("FindNeighbors(): Parameters not validated." );
         throw( std::runtime_error( errMsg ) );
     }
 
-    if ( parameters.embedded and parameters.E != dataFrame.NColumns() ) {
+    if ( parameters.embedded and parameters.E != N_columns ) {
         std::stringstream errMsg;
         errMsg << "FindNeighbors(): The number of dataFrame columns ("
-               << dataFrame.NColumns() << ") does not match the embedding "
+               << N_columns << ") does not match the embedding "
                << "dimension E (" << parameters.E << ")\n";
         throw std::runtime_error( errMsg.str() );
     }
 
     size_t N_library_rows    = parameters.library.size();
     size_t N_prediction_rows = parameters.prediction.size();
-    size_t N_columns         = dataFrame.NColumns();
-    
-    // Maximum column index.
-    // We assume that the dataFrame has been selected to the proper columns
-    size_t maxCol_i = N_columns - 1;
 
     if ( parameters.verbose ) {
         // Identify degenerate library : prediction points by
@@ -66,18 +338,74 @@ Neighbors FindNeighbors(
     neighbors.neighbors = DataFrame<size_t>(N_prediction_rows, parameters.knn);
     neighbors.distances = DataFrame<double>(N_prediction_rows, parameters.knn);
 
+    //-------------------------------------------------------------------
+    // Blocks of prediction rows are distributed over the thread pool
+    // Rows per block: about 64k distance evaluations
+    //-------------------------------------------------------------------
+    size_t grain = std::max( (size_t) 1, 65536 / ( N_library_rows + 1 ) );
+
+    parameters.exec.Pool().ParallelForRange(
+        N_prediction_rows, grain,
+        [&]( size_t rowStart, size_t rowStop ) {
+            SearchRows( rows, parameters, neighbors, rowStart, rowStop, 0 );
+        },
+        parameters.exec.nThreads );
+
+#ifdef DEBUG_ALL
+    const Neighbors &neigh = neighbors;
+    PrintNeighborsOut( neigh );
+#endif
+    
+    return neighbors;
+}
+
+//----------------------------------------------------------------
+// FindNeighborRows() of DataFrame values of type T
+//----------------------------------------------------------------
+template < class T >
+void EDM_Neighbors::FindNeighborRows( const DataFrame<T> &dataFrame,
+                                      const Parameters   &parameters,
+                                      Neighbors          &neighbors,
+                                      size_t              rowStart,
+                                      size_t              rowStop,
+                                      size_t              rowOffset )
+{
+    SearchRows( FrameRows<T>( dataFrame ), parameters, neighbors,
+                rowStart, rowStop, rowOffset );
+}
+
+//----------------------------------------------------------------
+// Neighbors of prediction rows [rowStart, rowStop) of rows, into
+// rows of neighbors from rowStart - rowOffset
+//----------------------------------------------------------------
+template < class Rows >
+void EDM_Neighbors::SearchRows( const Rows       &rows,
+                                const Parameters &parameters,
+                                Neighbors        &neighbors,
+                                size_t            rowStart,
+                                size_t            rowStop,
+                                size_t            rowOffset )
+{
+    typedef typename Rows::Value T;
+
+    size_t N_library_rows = parameters.library.size();
+
+    // Prediction row values, if rows are not read in place
+    std::vector<T> predValues( rows.Width() );
+
     // Vectors to hold indices and values from each comparison
     std::valarray<size_t> k_NN_neighbors( parameters.knn );
     std::valarray<double> k_NN_distances( parameters.knn );
+    std::vector< std::pair< double, size_t > > k_NN_nearest( parameters.knn );
 
     //-------------------------------------------------------------------
     // For each prediction vector (row in prediction DataFrame) find the
     // list of library indices that are within k_NN points
     //-------------------------------------------------------------------
-    for ( size_t row_i = 0; row_i < parameters.prediction.size(); row_i++ ) {
+    for ( size_t row_i = rowStart; row_i < rowStop; row_i++ ) {
         // Get the prediction vector for this pred_row index
         size_t pred_row = parameters.prediction[ row_i ];
-        std::valarray<double> pred_vec = dataFrame.Row( pred_row );
+        const T *pred_vec = rows.Row( pred_row, predValues.data() );
         
         // Reset the neighbor and distance vectors for this pred row
         for ( size_t i = 0; i < parameters.knn; i++ ) {
@@ -92,7 +420,6 @@ Neighbors FindNeighbors(
         for ( size_t row_j = 0; row_j < parameters.library.size(); row_j++ ) {
             // Get the library vector for this lib_row index
             size_t lib_row = parameters.library[ row_j ];
-            std::valarray<double> lib_vec = dataFrame.Row( lib_row );
             
             // If the library point is degenerate with the prediction,
             // ignore it.
@@ -119,8 +446,7 @@ Neighbors FindNeighbors(
             // Find distance between the prediction vector
             // and each of the library vectors
             // The 1st column (j=0) of Time has been excluded above
-            double d_i = Distance( lib_vec, pred_vec,
-                                   DistanceMetric::Euclidean );
+            double d_i = rows.Distance( lib_row, pred_vec );
 
             // If d_i is less than values in k_NN_distances, add to list
             auto max_it = std::max_element( begin( k_NN_distances ),
@@ -154,18 +480,23 @@ Neighbors FindNeighbors(
             std::cout << "WARNING: FindNeighbors(): Degenerate neighbors./n";
         }
 
+        // Nearest first, ties by library row: the order of the
+        // ParameterSweep() candidates, projections sum in this order
+        for ( size_t i = 0; i < parameters.knn; i++ ) {
+            k_NN_nearest[ i ] = std::make_pair( k_NN_distances[ i ],
+                                                k_NN_neighbors[ i ] );
+        }
+        std::sort( k_NN_nearest.begin(), k_NN_nearest.end() );
+        for ( size_t i = 0; i < parameters.knn; i++ ) {
+            k_NN_distances[ i ] = k_NN_nearest[ i ].first;
+            k_NN_neighbors[ i ] = k_NN_nearest[ i ].second;
+        }
+
         // Write the neighbor indices and distance values
-        neighbors.neighbors.WriteRow( row_i, k_NN_neighbors );
-        neighbors.distances.WriteRow( row_i, k_NN_distances );
+        neighbors.neighbors.WriteRow( row_i - rowOffset, k_NN_neighbors );
+        neighbors.distances.WriteRow( row_i - rowOffset, k_NN_distances );
         
-    } // for ( row_i = 0; row_i < predictionRows->size(); row_i++ )
-
-#ifdef DEBUG_ALL
-    const Neighbors &neigh = neighbors;
-    PrintNeighborsOut( neigh );
-#endif
-    
-    return neighbors;
+    } // for ( row_i = rowStart; row_i < rowStop; row_i++ )
 }
 
 //----------------------------------------------------------------
@@ -209,6 +540,213 @@ double Distance( const std::valarray<double> &v1,
     return distance;
 }
 
+//----------------------------------------------------------------
+// Distance of rows of N values, as Distance() of valarrays.
+// The zero padding of aligned DataFrame rows adds nothing: the
+// loop runs over full padded rows without a remainder.
+//----------------------------------------------------------------
+double Distance( const double  *v1,
+                 const double  *v2,
+                 size_t         N,
+                 DistanceMetric metric )
+{
+    return EDM_Neighbors::Distance( v1, v2, N, metric );
+}
+
+double Distance( const float   *v1,
+                 const float   *v2,
+                 size_t         N,
+                 DistanceMetric metric )
+{
+    return EDM_Neighbors::Distance( v1, v2, N, metric );
+}
+
+template < class T >
+double EDM_Neighbors::Distance( const T       *v1,
+                                const T       *v2,
+                                size_t         N,
+                                DistanceMetric metric )
+{
+    T sum = 0;
+
+    if ( metric == DistanceMetric::Euclidean ) {
+        for ( size_t i = 0; i < N; i++ ) {
+            T delta = v2[i] - v1[i];
+            sum += delta * delta;
+        }
+        return sqrt( sum );
+    }
+    else if ( metric == DistanceMetric::Manhattan ) {
+        for ( size_t i = 0; i < N; i++ ) {
+            sum += std::abs( v2[i] - v1[i] );
+        }
+        return sum;
+    }
+
+    std::stringstream errMsg;
+    errMsg << "Distance() Invalid DistanceMetric: "
+           << static_cast<size_t>( metric );
+    throw std::runtime_error( errMsg.str() );
+}
+
+//----------------------------------------------------------------
+// WriteNeighborIndex() : neighbors of key as a neighbor index file
+//----------------------------------------------------------------
+void WriteNeighborIndex( std::string        path,
+                         std::string        fileName,
+                         const std::string &key,
+                         const Neighbors   &neighbors ) {
+
+    // Unique temporary name of concurrent writers of the file
+    static std::atomic< size_t > writes( 0 );
+    std::stringstream tmpName;
+    tmpName << path << fileName << "." << getpid() << "." << writes++
+            << ".tmp";
+
+    size_t n_rows = neighbors.neighbors.NRows();
+    size_t knn    = neighbors.neighbors.NColumns();
+
+    EDM_Neighbors::IndexHeader header;
+    memcpy( header.magic, EDM_Neighbors::indexMagic, sizeof( header.magic ) );
+    header.version   = NeighborIndexVersion;
+    header.byteOrder = EDM_Neighbors::indexByteOrder;
+    header.n_rows    = n_rows;
+    header.knn       = knn;
+    header.keyLength = key.size();
+
+    std::string head( sizeof( header ), '\0' );
+    head.append( key );
+    head.resize( ( head.size() + EDM_Neighbors::indexAlignment - 1 ) /
+                 EDM_Neighbors::indexAlignment *
+                 EDM_Neighbors::indexAlignment, '\0' );
+
+    // Row-major uint64_t rows and float64 distances
+    std::vector< uint64_t > rows( n_rows * knn );
+    std::vector< double >   distances( n_rows * knn );
+    for ( size_t row = 0; row < n_rows; row++ ) {
+        for ( size_t k = 0; k < knn; k++ ) {
+            rows     [ row * knn + k ] = neighbors.neighbors( row, k );
+            distances[ row * knn + k ] = neighbors.distances( row, k );
+        }
+    }
+
+    ValuesHash digest = EDM_Neighbors::IndexDigest(
+        (const char *) rows.data(), (const char *) distances.data(),
+        rows.size() );
+
+    header.dataOffset  = head.size();
+    header.digest[ 0 ] = digest.fnv;
+    header.digest[ 1 ] = digest.splitmix;
+    memcpy( &head[ 0 ], &header, sizeof( header ) );
+
+    std::ofstream stream( tmpName.str(), std::ios::binary );
+    stream.write( head.data(), head.size() );
+    stream.write( (const char *) rows.data(), rows.size() * sizeof(uint64_t) );
+    stream.write( (const char *) distances.data(),
+                  distances.size() * sizeof( double ) );
+    stream.close();
+
+    if ( stream.fail() or
+         std::rename( tmpName.str().c_str(),
+                      ( path + fileName ).c_str() ) != 0 ) {
+        std::remove( tmpName.str().c_str() );
+        std::stringstream errMsg;
+        errMsg << "ERROR: WriteNeighborIndex() Failed to write file: "
+               << path << fileName << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+}
+
+//----------------------------------------------------------------
+// ReadNeighborIndex() : Map a neighbor index file of key. Neighbor
+// rows and distances are used in place, not copied, if size_t is
+// uint64_t. They are read once to check the digest.
+//----------------------------------------------------------------
+bool ReadNeighborIndex( std::string        path,
+                        std::string        fileName,
+                        const std::string &key,
+                        Neighbors         &neighbors ) {
+
+    if ( access( ( path + fileName ).c_str(), R_OK ) != 0 ) {
+        return false;
+    }
+
+    std::shared_ptr< MappedFile > file =
+        std::make_shared< MappedFile >( path + fileName );
+
+    EDM_Neighbors::IndexHeader header;
+
+    if ( file->Size() < sizeof( header ) or
+         memcmp( file->Data(), EDM_Neighbors::indexMagic,
+                 sizeof( EDM_Neighbors::indexMagic ) ) != 0 ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: ReadNeighborIndex() file " << path << fileName
+               << " is not a neighbor index file." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    memcpy( &header, file->Data(), sizeof( header ) );
+
+    if ( header.version   != NeighborIndexVersion           or
+         header.byteOrder != EDM_Neighbors::indexByteOrder or
+         header.keyLength != key.size()                      or
+         file->Size() < sizeof( header ) + key.size()        or
+         key.compare( 0, key.size(), file->Data() + sizeof( header ),
+                      key.size() ) != 0 ) {
+        return false;
+    }
+
+    // Values the file holds after dataOffset, compared with n_rows
+    // and knn by division: n_rows x knn may overflow
+    uint64_t fileValues = header.dataOffset <= file->Size() ?
+        ( file->Size() - header.dataOffset ) /
+        ( sizeof( uint64_t ) + sizeof( double ) ) : 0;
+
+    if ( header.dataOffset % sizeof( uint64_t )              or
+         header.dataOffset < sizeof( header ) + key.size() or
+         header.dataOffset > file->Size()                   or
+         ( header.knn and header.n_rows > fileValues / header.knn ) ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: ReadNeighborIndex() file " << path << fileName
+               << " is truncated." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    size_t n_rows = header.n_rows;
+    size_t knn    = header.knn;
+    size_t values = n_rows * knn;
+
+    char *rows      = file->Data() + header.dataOffset;
+    char *distances = rows + values * sizeof( uint64_t );
+
+    ValuesHash digest = EDM_Neighbors::IndexDigest( rows, distances, values );
+    if ( digest.fnv != header.digest[ 0 ] or
+         digest.splitmix != header.digest[ 1 ] ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: ReadNeighborIndex() file " << path << fileName
+               << " is corrupt: values differ from the digest."
+               << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    if ( sizeof( size_t ) == sizeof( uint64_t ) ) {
+        neighbors.neighbors = DataFrame<size_t>(
+            n_rows, knn, reinterpret_cast< size_t * >( rows ), file );
+    }
+    else {
+        neighbors.neighbors = DataFrame<size_t>( n_rows, knn );
+        for ( size_t i = 0; i < values; i++ ) {
+            uint64_t row;
+            memcpy( &row, rows + i * sizeof( uint64_t ), sizeof( row ) );
+            neighbors.neighbors( i / knn, i % knn ) = row;
+        }
+    }
+    neighbors.distances = DataFrame<double>(
+        n_rows, knn, reinterpret_cast< double * >( distances ), file );
+
+    return true;
+}
+
 #ifdef DEBUG_ALL
 //----------------------------------------------------------------
 // 
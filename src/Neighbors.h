@@ -6,6 +6,7 @@
 
 #include "Common.h"
 #include "Parameter.h"
+#include "Embed.h"
 
 // Return structure of FindNeighbors()
 struct Neighbors {
@@ -16,8 +17,72 @@ struct Neighbors {
 };
 
 // Prototypes
-Neighbors FindNeighbors( DataFrame<double> dataFrame,
-                         Parameters        parameters );
+Neighbors FindNeighbors( const DataFrame<double> &dataFrame,
+                         Parameters               parameters );
+
+// float32 rows: distances are computed in float32
+Neighbors FindNeighbors( const DataFrame<float> &dataFrame,
+                         Parameters              parameters );
+
+// Rows of an EmbeddingView are read in place, not materialized
+Neighbors FindNeighbors( const EmbeddingView<double> &embedding,
+                         Parameters                   parameters );
+
+Neighbors FindNeighbors( const EmbeddingView<float> &embedding,
+                         Parameters                  parameters );
+
+// Prediction rows [rowStart, rowStop), into the rows of neighbors
+// from rowStart - rowOffset
+void FindNeighborRows( const DataFrame<double> &dataFrame,
+                       const Parameters        &parameters,
+                       Neighbors               &neighbors,
+                       size_t                   rowStart,
+                       size_t                   rowStop,
+                       size_t                   rowOffset = 0 );
+
+void FindNeighborRows( const DataFrame<float> &dataFrame,
+                       const Parameters       &parameters,
+                       Neighbors              &neighbors,
+                       size_t                  rowStart,
+                       size_t                  rowStop,
+                       size_t                  rowOffset = 0 );
+
+//----------------------------------------------------------------
+// Neighbor index file
+// Neighbors of a library and prediction set, saved for reuse by
+// other processes. The key names the data and parameters the
+// neighbors are of, see NeighborIndexFileName().
+//
+// Header, all fields in native byte order:
+//   char     magic[ 8 ]  "cppEDMNN"
+//   uint32_t version     NeighborIndexVersion
+//   uint32_t byteOrder   0x01020304 as written
+//   uint64_t n_rows      prediction rows
+//   uint64_t knn
+//   uint64_t keyLength
+//   uint64_t dataOffset  of the neighbors block
+//   uint64_t digest[ 2 ] ValuesHash of the rows and distances
+//   char     key[ keyLength ]
+// zero padding to dataOffset, then n_rows x knn uint64_t library
+// rows and n_rows x knn float64 distances, row-major. Readers check
+// the size of the block and its digest before it is used.
+//----------------------------------------------------------------
+const uint32_t NeighborIndexVersion = 3;
+
+// Write neighbors of key. The file is written under a temporary
+// name then renamed: readers never see a partial file.
+void WriteNeighborIndex( std::string        path,
+                         std::string        fileName,
+                         const std::string &key,
+                         const Neighbors   &neighbors );
+
+// Neighbors of key mapped in place from the file. false if there
+// is no file, or it is of another version or key. Throws if it is
+// truncated or its values differ from the digest.
+bool ReadNeighborIndex( std::string        path,
+                        std::string        fileName,
+                        const std::string &key,
+                        Neighbors         &neighbors );
 
 void PrintDataFrameIn( const DataFrame<double> &dataFrame,
                        const Parameters        &parameters );
@@ -28,4 +93,14 @@ double Distance( const std::valarray<double> &v1,
                  const std::valarray<double> &v2,
                  DistanceMetric metric );
 
+double Distance( const double  *v1,
+                 const double  *v2,
+                 size_t         N,
+                 DistanceMetric metric );
+
+double Distance( const float   *v1,
+                 const float   *v2,
+                 size_t         N,
+                 DistanceMetric metric );
+
 #endif
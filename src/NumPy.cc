@@ -0,0 +1,513 @@
+#include <cstring>
+
+#include "Common.h"
+#include "DataIO.h"
+
+namespace EDM_NumPy {
+    const char npyMagic[ 6 ] = { '\x93', 'N', 'U', 'M', 'P', 'Y' };
+
+    // Zip record signatures
+    const uint32_t localHeader   = 0x04034b50;
+    const uint32_t centralHeader = 0x02014b50;
+    const uint32_t endRecord     = 0x06054b50;
+    const uint32_t end64Locator  = 0x07064b50;
+    const uint32_t end64Record   = 0x06064b50;
+
+    //------------------------------------------------------------
+    // Little endian integers of zip records
+    //------------------------------------------------------------
+    uint64_t Get( const char *p, size_t bytes ) {
+        uint64_t value = 0;
+        for ( size_t i = bytes; i-- > 0; ) {
+            value = ( value << 8 ) | (unsigned char) p[ i ];
+        }
+        return value;
+    }
+
+    void Put( std::string &out, uint64_t value, size_t bytes ) {
+        for ( size_t i = 0; i < bytes; i++ ) {
+            out.push_back( (char) ( ( value >> ( 8 * i ) ) & 0xFF ) );
+        }
+    }
+
+    bool LittleEndian() {
+        uint16_t one = 1;
+        char     first;
+        memcpy( &first, &one, 1 );
+        return first == 1;
+    }
+
+    size_t DTypeSize( BinaryDType dtype ) {
+        return dtype == BinaryDType::Float32 ? sizeof( float ) :
+                                               sizeof( double );
+    }
+
+    //------------------------------------------------------------
+    std::string Error( std::string caller, std::string fileName,
+                       std::string msg ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: " << caller << " file " << fileName << " "
+               << msg << std::endl;
+        return errMsg.str();
+    }
+
+    //------------------------------------------------------------
+    // Value of key in the .npy header dictionary, from the first
+    // char after the ':'
+    //------------------------------------------------------------
+    std::string DictValue( const std::string &header, std::string key ) {
+        size_t pos = header.find( "'" + key + "'" );
+        if ( pos == std::string::npos ) {
+            pos = header.find( "\"" + key + "\"" );
+        }
+        if ( pos == std::string::npos ) { return std::string(); }
+
+        pos = header.find( ':', pos );
+        if ( pos == std::string::npos ) { return std::string(); }
+
+        pos = header.find_first_not_of( " ", pos + 1 );
+        if ( pos == std::string::npos ) { return std::string(); }
+
+        return header.substr( pos );
+    }
+
+    //------------------------------------------------------------
+    // Array of the .npy bytes [begin, begin + size)
+    //------------------------------------------------------------
+    BinaryData ParseNpy( const char *begin, size_t size,
+                         std::string fileName ) {
+
+        if ( size < 10 or memcmp( begin, npyMagic, sizeof( npyMagic ) ) ) {
+            throw std::runtime_error(
+                Error( "ReadNpy()", fileName, "is not a .npy array." ) );
+        }
+
+        unsigned major = (unsigned char) begin[ 6 ];
+        size_t   headerStart, headerLength;
+
+        if ( major == 1 ) {
+            headerLength = Get( begin + 8, 2 );
+            headerStart  = 10;
+        }
+        else if ( ( major == 2 or major == 3 ) and size >= 12 ) {
+            headerLength = Get( begin + 8, 4 );
+            headerStart  = 12;
+        }
+        else {
+            throw std::runtime_error(
+                Error( "ReadNpy()", fileName,
+                       ".npy version " + std::to_string( major ) +
+                       " is not supported." ) );
+        }
+
+        if ( headerStart + headerLength > size ) {
+            throw std::runtime_error(
+                Error( "ReadNpy()", fileName, "is truncated." ) );
+        }
+
+        std::string header( begin + headerStart, headerLength );
+
+        // descr: byte order and type
+        std::string descr = DictValue( header, "descr" );
+        if ( descr.size() < 5 or ( descr[ 0 ] != '\'' and
+                                   descr[ 0 ] != '"' ) ) {
+            throw std::runtime_error(
+                Error( "ReadNpy()", fileName, "has no dtype." ) );
+        }
+        descr = descr.substr( 1, descr.find( descr[ 0 ], 1 ) - 1 );
+
+        char native = LittleEndian() ? '<' : '>';
+        bool nativeOrder = descr.size() == 3 and
+                           ( descr[ 0 ] == native or descr[ 0 ] == '=' );
+
+        BinaryData array;
+        if ( nativeOrder and descr.substr( 1 ) == "f8" ) {
+            array.dtype = BinaryDType::Float64;
+        }
+        else if ( nativeOrder and descr.substr( 1 ) == "f4" ) {
+            array.dtype = BinaryDType::Float32;
+        }
+        else {
+            throw std::runtime_error(
+                Error( "ReadNpy()", fileName,
+                       "dtype " + descr + " is not native float64 or"
+                       " float32." ) );
+        }
+
+        bool fortran = DictValue( header, "fortran_order" ).
+                       compare( 0, 4, "True" ) == 0;
+
+        // shape: ( rows, ) or ( rows, columns )
+        std::string shapeText = DictValue( header, "shape" );
+        std::vector< size_t > shape;
+        if ( shapeText.size() and shapeText[ 0 ] == '(' ) {
+            std::string dims = shapeText.substr( 1, shapeText.find( ')' ) - 1 );
+            std::vector< std::string > tokens = SplitString( dims, ", L" );
+            for ( size_t i = 0; i < tokens.size(); i++ ) {
+                if ( not OnlyDigits( tokens[ i ] ) ) { shape.clear(); break; }
+                shape.push_back( std::stoull( tokens[ i ] ) );
+            }
+        }
+        if ( shape.size() < 1 or shape.size() > 2 ) {
+            throw std::runtime_error(
+                Error( "ReadNpy()", fileName,
+                       "shape " + shapeText.substr( 0, shapeText.find( ')' ) +
+                       1 ) + " is not 1-D or 2-D." ) );
+        }
+
+        array.n_rows    = shape[ 0 ];
+        array.n_columns = shape.size() == 2 ? shape[ 1 ] : 1;
+        array.layout    = fortran and array.n_columns > 1 ?
+                          BinaryLayout::ColumnMajor : BinaryLayout::RowMajor;
+
+        // Values past the header: the shape is checked by division,
+        // the product of its dimensions can overflow
+        size_t dataStart  = headerStart + headerLength;
+        size_t fileValues = ( size - dataStart ) / DTypeSize( array.dtype );
+
+        if ( array.n_columns and
+             array.n_rows > fileValues / array.n_columns ) {
+            throw std::runtime_error(
+                Error( "ReadNpy()", fileName, "is truncated." ) );
+        }
+
+        for ( size_t col = 0; col < array.n_columns; col++ ) {
+            array.columnNames.push_back( "V" + std::to_string( col ) );
+        }
+        array.data = const_cast< char * >( begin + dataStart );
+
+        return array;
+    }
+
+    //------------------------------------------------------------
+    // .npy header of a C ordered array, padded so the values start
+    // at a multiple of 64 bytes
+    //------------------------------------------------------------
+    std::string NpyHeader( BinaryDType dtype, std::string shape ) {
+        std::string dict = std::string( "{'descr': '" ) +
+            ( LittleEndian() ? "<" : ">" ) +
+            ( dtype == BinaryDType::Float32 ? "f4" : "f8" ) +
+            "', 'fortran_order': False, 'shape': " + shape + ", }";
+
+        size_t total = ( 10 + dict.size() + 1 + 63 ) / 64 * 64;
+        dict.resize( total - 10 - 1, ' ' );
+        dict.push_back( '\n' );
+
+        std::string header( npyMagic, sizeof( npyMagic ) );
+        header.push_back( 1 ); // version 1.0
+        header.push_back( 0 );
+        Put( header, dict.size(), 2 );
+        return header + dict;
+    }
+
+    //------------------------------------------------------------
+    // CRC-32 of zip entries
+    //------------------------------------------------------------
+    std::vector< uint32_t > CRC32Table() {
+        std::vector< uint32_t > table( 256 );
+        for ( uint32_t i = 0; i < 256; i++ ) {
+            uint32_t c = i;
+            for ( int k = 0; k < 8; k++ ) {
+                c = c & 1 ? 0xEDB88320 ^ ( c >> 1 ) : c >> 1;
+            }
+            table[ i ] = c;
+        }
+        return table;
+    }
+
+    uint32_t CRC32( const std::string &bytes ) {
+        static const std::vector< uint32_t > table = CRC32Table();
+
+        uint32_t crc = 0xFFFFFFFF;
+        for ( size_t i = 0; i < bytes.size(); i++ ) {
+            crc = table[ ( crc ^ (unsigned char) bytes[ i ] ) & 0xFF ] ^
+                  ( crc >> 8 );
+        }
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    //------------------------------------------------------------
+    void WriteFile( std::string fileName, const std::string &bytes,
+                    std::string caller ) {
+        std::ofstream outputFile( fileName, std::ios::binary );
+        if ( not outputFile.is_open() ) {
+            throw std::runtime_error(
+                Error( caller, fileName, "failed to open." ) );
+        }
+        outputFile.write( bytes.data(), bytes.size() );
+        if ( not outputFile.good() ) {
+            throw std::runtime_error(
+                Error( caller, fileName, "failed to write." ) );
+        }
+    }
+}
+
+//----------------------------------------------------------------
+bool IsNpyFile( const MappedFile &file ) {
+    return file.Size() >= sizeof( EDM_NumPy::npyMagic ) and
+           memcmp( file.Data(), EDM_NumPy::npyMagic,
+                   sizeof( EDM_NumPy::npyMagic ) ) == 0;
+}
+
+bool IsNpzFile( const MappedFile &file ) {
+    return file.Size() >= 4 and
+           EDM_NumPy::Get( file.Data(), 4 ) == EDM_NumPy::localHeader;
+}
+
+//----------------------------------------------------------------
+// ReadNpy() : Header of a mapped .npy file and its values in place
+//----------------------------------------------------------------
+BinaryData ReadNpy( std::shared_ptr< MappedFile > file,
+                    std::string                   fileName ) {
+    BinaryData array = EDM_NumPy::ParseNpy( file->Data(), file->Size(),
+                                            fileName );
+    array.file = file;
+    return array;
+}
+
+//----------------------------------------------------------------
+// ReadNpz() : Arrays of a mapped .npz file, found through the zip
+// central directory (numpy.savez() writes the sizes after the
+// entry data, not in the local headers). Zip64 records are read.
+//----------------------------------------------------------------
+std::vector< BinaryData > ReadNpz( std::shared_ptr< MappedFile > file,
+                                   std::string                   fileName ) {
+    using namespace EDM_NumPy;
+
+    const char *begin = file->Data();
+    size_t      size  = file->Size();
+
+    // End of central directory record: last 22 bytes + comment
+    size_t end = std::string::npos;
+    if ( size >= 22 ) {
+        size_t first = size > 22 + 65535 ? size - 22 - 65535 : 0;
+        for ( size_t pos = size - 22 + 1; pos-- > first; ) {
+            if ( Get( begin + pos, 4 ) == endRecord ) { end = pos; break; }
+        }
+    }
+    if ( end == std::string::npos ) {
+        throw std::runtime_error(
+            Error( "ReadNpz()", fileName, "is not a zip archive." ) );
+    }
+
+    uint64_t N_entries = Get( begin + end + 10, 2 );
+    uint64_t cdOffset  = Get( begin + end + 16, 4 );
+
+    if ( ( N_entries == 0xFFFF or cdOffset == 0xFFFFFFFF ) and
+         end >= 20 and Get( begin + end - 20, 4 ) == end64Locator ) {
+        uint64_t record = Get( begin + end - 20 + 8, 8 );
+        if ( record + 56 > size or Get( begin + record, 4 ) != end64Record ) {
+            throw std::runtime_error(
+                Error( "ReadNpz()", fileName, "zip64 record is invalid." ) );
+        }
+        N_entries = Get( begin + record + 32, 8 );
+        cdOffset  = Get( begin + record + 48, 8 );
+    }
+
+    std::vector< BinaryData > arrays;
+    size_t pos = cdOffset;
+
+    for ( uint64_t entry = 0; entry < N_entries; entry++ ) {
+        if ( pos + 46 > size or Get( begin + pos, 4 ) != centralHeader ) {
+            throw std::runtime_error(
+                Error( "ReadNpz()", fileName,
+                       "central directory is invalid." ) );
+        }
+        unsigned method     = Get( begin + pos + 10, 2 );
+        uint64_t dataSize   = Get( begin + pos + 24, 4 );
+        size_t   nameLength = Get( begin + pos + 28, 2 );
+        size_t   extraSize  = Get( begin + pos + 30, 2 );
+        size_t   comment    = Get( begin + pos + 32, 2 );
+        uint64_t local      = Get( begin + pos + 42, 4 );
+
+        if ( pos + 46 + nameLength + extraSize + comment > size ) {
+            throw std::runtime_error(
+                Error( "ReadNpz()", fileName, "is truncated." ) );
+        }
+        std::string name( begin + pos + 46, nameLength );
+
+        // Zip64 extra field: 64 bit values of the saturated fields
+        const char *extra    = begin + pos + 46 + nameLength;
+        const char *extraEnd = extra + extraSize;
+        while ( extra + 4 <= extraEnd ) {
+            unsigned    id     = Get( extra,     2 );
+            size_t      length = Get( extra + 2, 2 );
+            const char *field  = extra + 4;
+            if ( id == 0x0001 ) {
+                if ( dataSize == 0xFFFFFFFF and field + 8 <= extraEnd ) {
+                    dataSize = Get( field, 8 );
+                    field += 8;
+                }
+                // compressed size
+                if ( Get( begin + pos + 20, 4 ) == 0xFFFFFFFF ) {
+                    field += 8;
+                }
+                if ( local == 0xFFFFFFFF and field + 8 <= extraEnd ) {
+                    local = Get( field, 8 );
+                }
+            }
+            extra += 4 + length;
+        }
+        pos += 46 + nameLength + extraSize + comment;
+
+        if ( method != 0 ) {
+            throw std::runtime_error(
+                Error( "ReadNpz()", fileName,
+                       "array " + name + " is compressed: only"
+                       " numpy.savez() archives are supported." ) );
+        }
+        if ( local + 30 > size or Get( begin + local, 4 ) != localHeader ) {
+            throw std::runtime_error(
+                Error( "ReadNpz()", fileName,
+                       "local header of " + name + " is invalid." ) );
+        }
+
+        size_t dataStart = local + 30 + Get( begin + local + 26, 2 ) +
+                                        Get( begin + local + 28, 2 );
+        if ( dataStart > size or size - dataStart < dataSize ) {
+            throw std::runtime_error(
+                Error( "ReadNpz()", fileName, "is truncated." ) );
+        }
+
+        if ( name.size() > 4 and name.substr( name.size() - 4 ) == ".npy" ) {
+            name.resize( name.size() - 4 );
+        }
+
+        BinaryData array = ParseNpy( begin + dataStart, dataSize,
+                                     fileName + ":" + name );
+        if ( array.n_columns != 1 ) {
+            throw std::runtime_error(
+                Error( "ReadNpz()", fileName,
+                       "array " + name + " is not 1-D or a single"
+                       " column." ) );
+        }
+        array.columnNames = { name };
+        array.file        = file;
+        arrays.push_back( array );
+    }
+
+    return arrays;
+}
+
+//----------------------------------------------------------------
+// WriteNpy() : Row-major values as a 2-D C ordered .npy array
+//----------------------------------------------------------------
+void WriteNpy( std::string  path,
+               std::string  fileName,
+               size_t       n_rows,
+               size_t       n_columns,
+               BinaryDType  dtype,
+               const void  *data ) {
+
+    std::string shape = "(" + std::to_string( n_rows ) + ", " +
+                        std::to_string( n_columns ) + ")";
+
+    std::string bytes = EDM_NumPy::NpyHeader( dtype, shape );
+    bytes.append( (const char *) data,
+                  n_rows * n_columns * EDM_NumPy::DTypeSize( dtype ) );
+
+    EDM_NumPy::WriteFile( path + fileName, bytes, "WriteNpy()" );
+}
+
+//----------------------------------------------------------------
+// WriteNpz() : Each column of row-major values as a stored (not
+// compressed) 1-D array of a zip archive, as numpy.savez()
+//----------------------------------------------------------------
+void WriteNpz( std::string                        path,
+               std::string                        fileName,
+               const std::vector< std::string > &columnNames,
+               size_t                             n_rows,
+               size_t                             n_columns,
+               BinaryDType                        dtype,
+               const void                        *data ) {
+    using namespace EDM_NumPy;
+
+    if ( columnNames.size() != n_columns ) {
+        std::stringstream errMsg;
+        errMsg << "ERROR: WriteNpz() The number of column names ("
+               << columnNames.size() << ") does not match the number"
+               << " of columns (" << n_columns << ")." << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    size_t valueSize = DTypeSize( dtype );
+    std::string header = NpyHeader( dtype,
+                                    "(" + std::to_string( n_rows ) + ",)" );
+
+    std::string archive, directory;
+
+    for ( size_t col = 0; col < n_columns; col++ ) {
+        std::string name = columnNames[ col ] + ".npy";
+
+        std::string array( header );
+        array.resize( header.size() + n_rows * valueSize );
+        for ( size_t row = 0; row < n_rows; row++ ) {
+            memcpy( &array[ header.size() + row * valueSize ],
+                    (const char *) data +
+                    ( row * n_columns + col ) * valueSize, valueSize );
+        }
+
+        if ( archive.size() + array.size() > 0xFFFFFFFFULL - 1024 ) {
+            throw std::runtime_error(
+                Error( "WriteNpz()", path + fileName,
+                       "exceeds 4 GB, use WriteNpy()." ) );
+        }
+
+        uint32_t crc    = CRC32( array );
+        size_t   offset = archive.size();
+
+        // Local header: stored, 1980-01-01 00:00
+        Put( archive, localHeader, 4 );
+        Put( archive, 20, 2 );          // version needed
+        Put( archive, 0, 2 );           // flags
+        Put( archive, 0, 2 );           // method: stored
+        Put( archive, 0, 2 );           // time
+        Put( archive, 0x21, 2 );        // date
+        Put( archive, crc, 4 );
+        Put( archive, array.size(), 4 );
+        Put( archive, array.size(), 4 );
+        Put( archive, name.size(), 2 );
+        Put( archive, 0, 2 );           // extra field
+        archive += name;
+        archive += array;
+
+        Put( directory, centralHeader, 4 );
+        Put( directory, 20, 2 );        // version made by
+        Put( directory, 20, 2 );        // version needed
+        Put( directory, 0, 2 );
+        Put( directory, 0, 2 );
+        Put( directory, 0, 2 );
+        Put( directory, 0x21, 2 );
+        Put( directory, crc, 4 );
+        Put( directory, array.size(), 4 );
+        Put( directory, array.size(), 4 );
+        Put( directory, name.size(), 2 );
+        Put( directory, 0, 2 );         // extra field
+        Put( directory, 0, 2 );         // comment
+        Put( directory, 0, 2 );         // disk
+        Put( directory, 0, 2 );         // internal attributes
+        Put( directory, 0, 4 );         // external attributes
+        Put( directory, offset, 4 );
+        directory += name;
+    }
+
+    if ( n_columns > 0xFFFF ) {
+        throw std::runtime_error(
+            Error( "WriteNpz()", path + fileName,
+                   "has more than 65535 columns." ) );
+    }
+
+    size_t cdOffset = archive.size();
+    archive += directory;
+
+    Put( archive, endRecord, 4 );
+    Put( archive, 0, 2 );
+    Put( archive, 0, 2 );
+    Put( archive, n_columns, 2 );
+    Put( archive, n_columns, 2 );
+    Put( archive, directory.size(), 4 );
+    Put( archive, cdOffset, 4 );
+    Put( archive, 0, 2 );
+
+    WriteFile( path + fileName, archive, "WriteNpz()" );
+}
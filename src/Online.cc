@@ -0,0 +1,241 @@
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+
+#include "Online.h"
+
+namespace EDM_Online {
+    //------------------------------------------------------------
+    // Names of the embedded columns
+    //------------------------------------------------------------
+    std::vector< std::string > Columns( std::string columns ) {
+        std::vector< std::string > names = SplitString( columns, " \t,\n" );
+        if ( names.empty() ) {
+            std::stringstream errMsg;
+            errMsg << "OnlineEngine(): columns must be specified."
+                   << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+        return names;
+    }
+
+    //------------------------------------------------------------
+    // Index of target in the observations: of the column, or after
+    // the columns if not one of them. target "" is the first column.
+    //------------------------------------------------------------
+    size_t TargetColumn( std::string columns, std::string target ) {
+        std::vector< std::string > names = Columns( columns );
+        if ( target.empty() ) {
+            return 0;
+        }
+        return std::find( names.begin(), names.end(), target ) -
+               names.begin();
+    }
+}
+
+//----------------------------------------------------------------
+// SMap scratch: the weighted linear system A C = B of the knn
+// neighbors and its SVD, sized once for knn and the state vector
+//----------------------------------------------------------------
+struct OnlineEngine::SMapSolver {
+    Eigen::MatrixXd                     A;
+    Eigen::VectorXd                     B;
+    Eigen::VectorXd                     C;
+    Eigen::VectorXd                     tmp;
+    Eigen::JacobiSVD< Eigen::MatrixXd > svd;
+
+    void Resize( Eigen::Index knn, Eigen::Index columns ) {
+        if ( A.rows() == knn and A.cols() == columns ) {
+            return;
+        }
+        A.resize( knn, columns );
+        B.resize( knn );
+        C.resize( columns );
+        tmp.resize( columns );
+        svd = Eigen::JacobiSVD< Eigen::MatrixXd >
+            ( knn, columns, Eigen::ComputeThinU | Eigen::ComputeThinV );
+    }
+
+    // C of least squares A C = B: JacobiSVD::solve() in place
+    void Solve() {
+        svd.compute( A );
+
+        Eigen::Index rank = svd.rank();
+        tmp.head( rank ).noalias() =
+            svd.matrixU().leftCols( rank ).adjoint() * B;
+        tmp.head( rank ).array() /=
+            svd.singularValues().head( rank ).array();
+        C.noalias() = svd.matrixV().leftCols( rank ) * tmp.head( rank );
+    }
+};
+
+//----------------------------------------------------------------
+// Embed and index the library of the data rows
+//----------------------------------------------------------------
+OnlineEngine::OnlineEngine( const DataFrameView< double > &data,
+                            std::string columns,
+                            std::string target,
+                            Method      method,
+                            int         E,
+                            int         Tp,
+                            int         knn,
+                            int         tau,
+                            double      theta,
+                            size_t      window ) :
+    method( method ), knn( knn ), theta( theta ),
+    targetColumn( EDM_Online::TargetColumn( columns, target ) ),
+    library( E, Tp, tau, EDM_Online::Columns( columns ).size(), window,
+             targetColumn < EDM_Online::Columns( columns ).size() ? 0 : 1 )
+{
+    if ( method != Method::Simplex and method != Method::SMap ) {
+        std::stringstream errMsg;
+        errMsg << "OnlineEngine(): method must be Simplex or SMap."
+               << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    // If Simplex and knn not specified, knn set to E+1
+    // If S-Map require knn > E + 1, default is all neighbors.
+    if ( method == Method::Simplex and knn < 1 ) {
+        this->knn = E + 1;
+    }
+    if ( this->knn < 0 or ( this->knn > 0 and this->knn < E + 1 ) ) {
+        std::stringstream errMsg;
+        errMsg << "OnlineEngine(): knn of " << this->knn
+               << " is less than E+1 = " << E + 1 << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    // Data columns of the observations
+    std::vector< size_t > dataColumns;
+    std::vector< std::string > names = EDM_Online::Columns( columns );
+    for ( auto ni = names.begin(); ni != names.end(); ++ni ) {
+        dataColumns.push_back( data.ColumnIndex( *ni ) );
+    }
+    if ( library.NTargets() ) {
+        dataColumns.push_back( data.ColumnIndex( target ) );
+    }
+
+    std::vector< double > observation( dataColumns.size() );
+    for ( size_t row = 0; row < data.NRows(); row++ ) {
+        for ( size_t col = 0; col < dataColumns.size(); col++ ) {
+            observation[ col ] = data( row, dataColumns[ col ] );
+        }
+        library.Append( observation.data() );
+    }
+
+    state.resize( library.Dimension() );
+    rows.resize( this->knn );
+    distances.resize( this->knn );
+    weights.resize( this->knn );
+
+    if ( method == Method::SMap ) {
+        smap.reset( new SMapSolver() );
+    }
+}
+
+//----------------------------------------------------------------
+OnlineEngine::~OnlineEngine() {}
+
+//----------------------------------------------------------------
+void OnlineEngine::Update( double value ) {
+    library.Append( value );
+}
+
+//----------------------------------------------------------------
+void OnlineEngine::Update( const std::vector< double > &observation ) {
+    library.Append( observation );
+}
+
+//----------------------------------------------------------------
+void OnlineEngine::Update( const double *observation ) {
+    library.Append( observation );
+}
+
+//----------------------------------------------------------------
+size_t OnlineEngine::Knn() const {
+    return knn > 0 ? knn : library.LibrarySize();
+}
+
+//----------------------------------------------------------------
+// Forecast() : knn neighbors of the newest state vector, projected
+//----------------------------------------------------------------
+double OnlineEngine::Forecast() {
+    size_t N = library.NRows();
+    library.StateVector( N ? N - 1 : 0, state.data() );
+
+    size_t k = Knn();
+    if ( rows.size() < k ) {
+        // SMap of all library rows
+        rows.resize( k );
+        distances.resize( k );
+        weights.resize( k );
+    }
+    library.Nearest( state.data(), k, rows.data(), distances.data() );
+
+    return method == Method::SMap ? SMapForecast( k ) : SimplexForecast( k );
+}
+
+//----------------------------------------------------------------
+// Simplex projection: weights of SimplexProjection()
+//----------------------------------------------------------------
+double OnlineEngine::SimplexForecast( size_t knn ) {
+    double minWeight   = 1.E-6;
+    double minDistance = distances[ 0 ]; // nearest first
+    int    Tp          = library.PredictionInterval();
+
+    double weightSum = 0;
+    double targetSum = 0;
+    for ( size_t k = 0; k < knn; k++ ) {
+        // distance 0 : the library state is the observation, weight 1
+        double weight = distances[ k ] > 0 ?
+                        std::exp( -distances[ k ] / minDistance ) : 1;
+        weights[ k ] = std::max( weight, minWeight );
+
+        weightSum += weights[ k ];
+        targetSum += weights[ k ] *
+                     library.Observation( rows[ k ] + Tp, targetColumn );
+    }
+    return targetSum / weightSum;
+}
+
+//----------------------------------------------------------------
+// SMap projection: the weighted linear map of SMapProjection()
+//----------------------------------------------------------------
+double OnlineEngine::SMapForecast( size_t knn ) {
+    size_t D  = library.Dimension();
+    int    Tp = library.PredictionInterval();
+
+    smap->Resize( knn, D + 1 );
+
+    double D_avg = 0;
+    for ( size_t k = 0; k < knn; k++ ) {
+        D_avg += distances[ k ];
+    }
+    D_avg = D_avg / knn;
+
+    // Populate matrix A (exp weighted future prediction), and
+    // vector B (weighted targets)
+    for ( size_t k = 0; k < knn; k++ ) {
+        weights[ k ] = theta > 0 ?
+                       std::exp( ( -theta / D_avg ) * distances[ k ] ) : 1;
+
+        smap->A( k, 0 ) = weights[ k ];
+        for ( size_t j = 1; j < D + 1; j++ ) {
+            smap->A( k, j ) = weights[ k ] * state[ j - 1 ];
+        }
+        smap->B( k ) = weights[ k ] *
+                       library.Observation( rows[ k ] + Tp, targetColumn );
+    }
+
+    smap->Solve();
+
+    // Prediction is local linear projection, C[ 0 ] the bias term
+    double prediction = smap->C( 0 );
+    for ( size_t j = 1; j < D + 1; j++ ) {
+        prediction = prediction + smap->C( j ) * state[ j - 1 ];
+    }
+    return prediction;
+}
@@ -0,0 +1,76 @@
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include <memory>
+
+#include "Common.h"
+#include "Library.h"
+
+//----------------------------------------------------------------
+// OnlineEngine
+// Simplex or SMap forecasts of observations that arrive one at a
+// time. The library of the data rows is embedded and indexed once
+// at construction, in a StreamLibrary. Update() appends each new
+// observation to the library and its KDTree, Forecast() projects
+// the newest state vector Tp ahead from its knn library neighbors:
+// the prediction Simplex() or SMap() make of the newest row with
+// all prior embedded rows as library.
+//
+// Observations are the values of columns, then of target if it is
+// not one of the columns. target "" is the first column.
+//
+// knn = 0 : E + 1 for Simplex, all library rows for SMap.
+// window > 0 : the library is of the last window observations.
+//
+// Scratch of the neighbors, weights and SVD is held by the engine:
+// Update() and Forecast() do not allocate once the library holds a
+// window of rows (without a window, the observations and tree grow
+// amortized). SMap of knn = 0 resizes its scratch with the library.
+//----------------------------------------------------------------
+class OnlineEngine {
+
+public:
+    OnlineEngine( const DataFrameView< double > &data,
+                  std::string columns = "",
+                  std::string target  = "",
+                  Method      method  = Method::Simplex,
+                  int         E       = 0,
+                  int         Tp      = 1,
+                  int         knn     = 0,
+                  int         tau     = 1,
+                  double      theta   = 0,
+                  size_t      window  = 0 );
+    ~OnlineEngine();
+
+    // New observation: columns, then target if not a column
+    void Update( double value );
+    void Update( const std::vector< double > &observation );
+    void Update( const double                *observation );
+
+    // Prediction Tp ahead of the newest observation
+    double Forecast();
+
+    const StreamLibrary &Library() const { return library; }
+
+    // Neighbors of the next Forecast()
+    size_t Knn() const;
+
+private:
+    Method                method;
+    int                   knn;
+    double                theta;
+    size_t                targetColumn; // in library observations
+    StreamLibrary         library;
+    std::vector< double > state;
+    std::vector< size_t > rows;
+    std::vector< double > distances;
+    std::vector< double > weights;
+
+    // Eigen matrices and SVD of SMap, in Online.cc
+    struct SMapSolver;
+    std::unique_ptr< SMapSolver > smap;
+
+    double SimplexForecast( size_t knn );
+    double SMapForecast   ( size_t knn );
+};
+#endif
@@ -80,7 +80,9 @@ Parameters::Parameters(
 
     // Set validated flag and instantiate Version
     validated        ( false ),
-    version          ( 0, 1, 2, "2019-05-05" )
+    version          ( 0, 1, 2, "2019-05-05" ),
+    predictionSink   ( nullptr ),
+    coefficientSink  ( nullptr )
 {
     // Constructor code
     if ( method != Method::None ) {
@@ -64,6 +64,11 @@ public:  // Not protected with accessors.
 
     Version version;  // Version object, instantiated in constructor
 
+    ExecutionContext exec; // Thread pool and concurrency of the call
+
+    ResultSink *predictionSink;  // Prediction rows, nullptr : DataFrame
+    ResultSink *coefficientSink; // SMap coefficient rows, or nullptr
+
     friend std::ostream& operator<<(std::ostream &os, Parameters &params);
 
     // Constructor declaration and default arguments
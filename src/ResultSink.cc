@@ -0,0 +1,80 @@
+
+#include "Common.h"
+#include "ResultSink.h"
+
+//----------------------------------------------------------------
+// CSVSink : the file is created by Begin()
+//----------------------------------------------------------------
+CSVSink::CSVSink( std::string path, std::string fileName, int precision ) :
+    path( path ), fileName( fileName ), precision( precision ),
+    n_columns( 0 ) {}
+
+void CSVSink::Begin( const std::vector< std::string > &columnNames ) {
+    n_columns = columnNames.size();
+    writer.reset( new CSVWriter( path, fileName, precision ) );
+    writer->WriteHeader( columnNames );
+}
+
+void CSVSink::Rows( const double *values, size_t n_rows ) {
+    if ( not writer ) {
+        throw std::runtime_error( "CSVSink::Rows() called before Begin()." );
+    }
+    writer->WriteRows( values, n_rows, n_columns );
+}
+
+void CSVSink::End() {
+    if ( writer ) {
+        writer->Close();
+        writer.reset();
+    }
+}
+
+//----------------------------------------------------------------
+// BinarySink : the file is created by Begin()
+//----------------------------------------------------------------
+BinarySink::BinarySink( std::string path, std::string fileName ) :
+    path( path ), fileName( fileName ) {}
+
+void BinarySink::Begin( const std::vector< std::string > &columnNames ) {
+    writer.reset( new BinaryWriter( path, fileName, columnNames ) );
+}
+
+void BinarySink::Rows( const double *values, size_t n_rows ) {
+    if ( not writer ) {
+        throw std::runtime_error( "BinarySink::Rows() called before Begin()." );
+    }
+    writer->WriteRows( values, n_rows );
+}
+
+void BinarySink::End() {
+    if ( writer ) {
+        writer->Close();
+        writer.reset();
+    }
+}
+
+//----------------------------------------------------------------
+// MemorySink
+//----------------------------------------------------------------
+void MemorySink::Begin( const std::vector< std::string > &columnNames ) {
+    this->columnNames = columnNames;
+    n_columns         = columnNames.size();
+    values.clear();
+}
+
+void MemorySink::Rows( const double *values, size_t n_rows ) {
+    this->values.insert( this->values.end(),
+                         values, values + n_rows * n_columns );
+}
+
+DataFrame< double > MemorySink::Data() const {
+    DataFrame< double > data( NRows(), n_columns );
+    data.ColumnNames() = columnNames;
+
+    for ( size_t row = 0; row < data.NRows(); row++ ) {
+        for ( size_t col = 0; col < n_columns; col++ ) {
+            data( row, col ) = values[ row * n_columns + col ];
+        }
+    }
+    return data;
+}
@@ -0,0 +1,93 @@
+#ifndef RESULTSINK_H
+#define RESULTSINK_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "DataFrame.h"
+#include "DataIO.h"
+
+//----------------------------------------------------------------
+// ResultSink
+// Receives the rows of an output table as they are produced:
+// Begin() with the column names, Rows() for each block of rows
+// in output order, then End(). Engines given a sink do not build
+// the output DataFrame.
+//----------------------------------------------------------------
+class ResultSink {
+
+public:
+    virtual ~ResultSink() {}
+
+    virtual void Begin( const std::vector< std::string > &columnNames ) = 0;
+
+    // n_rows rows of columnNames.size() values, row-major
+    virtual void Rows( const double *values, size_t n_rows ) = 0;
+
+    virtual void End() = 0;
+};
+
+//----------------------------------------------------------------
+// CSVSink : rows to a CSV file through a CSVWriter
+//----------------------------------------------------------------
+class CSVSink : public ResultSink {
+
+public:
+    CSVSink( std::string path, std::string fileName, int precision = 4 );
+
+    void Begin( const std::vector< std::string > &columnNames );
+    void Rows ( const double *values, size_t n_rows );
+    void End  ();
+
+private:
+    std::string                  path;
+    std::string                  fileName;
+    int                          precision;
+    size_t                       n_columns;
+    std::unique_ptr< CSVWriter > writer;
+};
+
+//----------------------------------------------------------------
+// BinarySink : rows to a binary DataFrame file, see DataIO.h
+//----------------------------------------------------------------
+class BinarySink : public ResultSink {
+
+public:
+    BinarySink( std::string path, std::string fileName );
+
+    void Begin( const std::vector< std::string > &columnNames );
+    void Rows ( const double *values, size_t n_rows );
+    void End  ();
+
+private:
+    std::string                     path;
+    std::string                     fileName;
+    std::unique_ptr< BinaryWriter > writer;
+};
+
+//----------------------------------------------------------------
+// MemorySink : rows collected into a DataFrame
+//----------------------------------------------------------------
+class MemorySink : public ResultSink {
+
+public:
+    MemorySink() : n_columns( 0 ) {}
+
+    void Begin( const std::vector< std::string > &columnNames );
+    void Rows ( const double *values, size_t n_rows );
+    void End  () {}
+
+    size_t NRows() const {
+        return n_columns ? values.size() / n_columns : 0;
+    }
+
+    // Rows received since Begin()
+    DataFrame< double > Data() const;
+
+private:
+    std::vector< std::string > columnNames;
+    size_t                     n_columns;
+    std::vector< double >      values;
+};
+#endif
@@ -0,0 +1,369 @@
+
+#include <mutex>
+
+#include "Common.h"
+#include "Parameter.h"
+#include "Neighbors.h"
+#include "AuxFunc.h"
+
+// forward declarations
+DataFrame<double> SimplexProjection( Parameters  param,
+                                     DataEmbedNN embedNN,
+                                     bool        checkDataRows = true );
+
+SMapValues SMapProjection( Parameters param, DataEmbedNN dataEmbedNN );
+
+namespace EDM_Rolling {
+    std::mutex mtx;
+
+    // One fold of RollingOrigin()
+    struct Fold {
+        Parameters          param;
+        std::vector<size_t> libRows;   // library rows valid as neighbors
+        Neighbors           neighbors;
+        DataFrame<double>   output;    // Time Observations Predictions
+    };
+}
+
+//----------------------------------------------------------------
+// RollingOrigin() : Rolling origin cross-validation of Simplex
+// or SMap.
+// API Overload 1: Explicit data file path/name
+//     Implemented as a wrapper to API Overload 2:
+//----------------------------------------------------------------
+RollingValues RollingOrigin( std::string pathIn,
+                             std::string dataFile,
+                             std::string pathOut,
+                             std::string predictFile,
+                             std::string lib,
+                             int         predRows,
+                             int         step,
+                             int         folds,
+                             Method      method,
+                             int         E,
+                             int         Tp,
+                             int         knn,
+                             int         tau,
+                             double      theta,
+                             std::string colNames,
+                             std::string targetName,
+                             bool        embedded,
+                             bool        verbose,
+                             ExecutionContext exec ) {
+
+    // Create DataFrame (constructor loads data)
+    DataFrame< double > dataFrameIn( pathIn, dataFile,
+                                     DataColumns( colNames, targetName ) );
+
+    RollingValues rolling = RollingOrigin( dataFrameIn, pathOut,
+                                           predictFile, lib, predRows,
+                                           step, folds, method,
+                                           E, Tp, knn, tau, theta,
+                                           colNames, targetName,
+                                           embedded, verbose, exec );
+    return rolling;
+}
+
+//----------------------------------------------------------------
+// RollingOrigin()
+// API Overload 2: DataFrame provided
+//
+// Fold f has library [libStart, libEnd + f * step] and predicts the
+// next predRows rows.  step = 0 : step = predRows, folds = 0 : all
+// the folds that fit in the data.
+//
+// The data are embedded once.  The library of a fold contains the
+// library of the previous fold, so the neighbors of a prediction row
+// shared by consecutive folds (step < predRows) are updated with the
+// added library rows only.  Prediction rows are distributed over the
+// thread pool, then the projections of the folds.
+//----------------------------------------------------------------
+RollingValues RollingOrigin( const DataFrameView< double > &data,
+                             std::string                    pathOut,
+                             std::string                    predictFile,
+                             std::string                    lib,
+                             int                            predRows,
+                             int                            step,
+                             int                            folds,
+                             Method                         method,
+                             int                            E,
+                             int                            Tp,
+                             int                            knn,
+                             int                            tau,
+                             double                         theta,
+                             std::string                    colNames,
+                             std::string                    targetName,
+                             bool                           embedded,
+                             bool                           verbose,
+                             ExecutionContext               exec ) {
+
+    if ( method != Method::Simplex and method != Method::SMap ) {
+        throw std::runtime_error( "RollingOrigin(): method must be "
+                                  "Simplex or SMap.\n" );
+    }
+    if ( predRows < 1 ) {
+        throw std::runtime_error( "RollingOrigin(): predRows must be "
+                                  "positive.\n" );
+    }
+    if ( step < 1 ) {
+        step = predRows;
+    }
+
+    std::vector<std::string> lib_vec = SplitString( lib, " \t," );
+    if ( lib_vec.size() != 2 ) {
+        throw std::runtime_error( "RollingOrigin(): "
+                                  "library must be two integers.\n" );
+    }
+    int libStart = std::stoi( lib_vec[0] );
+    int libEnd   = std::stoi( lib_vec[1] );
+
+    //------------------------------------------------------------
+    // Embed once, with the parameters of the first fold
+    //------------------------------------------------------------
+    std::stringstream pred0;
+    pred0 << libEnd + 1 << " " << libEnd + predRows;
+
+    Parameters param = Parameters( method, "", "", "", "",
+                                   lib, pred0.str(), E, Tp, knn, tau, theta,
+                                   colNames, targetName, embedded, verbose );
+    param.exec = exec;
+
+    DataEmbedNN embedNN = EmbedData( data, param );
+
+    // Aligned, zero padded rows for the distance kernel: those of
+    // EmbeddingBlock(), shared by ToLayout()
+    DataFrame<double> dataBlock =
+        EmbeddingBlock( embedNN ).ToLayout( DataFrameLayout::RowMajor, true );
+    const double *blockValues = dataBlock.Data();
+    size_t        blockStride = dataBlock.Stride();
+
+    //------------------------------------------------------------
+    // Folds
+    //------------------------------------------------------------
+    int N_data   = embedNN.dataIn.NRows();
+    int maxFolds = ( N_data - libEnd - predRows ) / step + 1;
+
+    if ( folds < 1 ) {
+        folds = maxFolds;
+    }
+    else if ( folds > maxFolds ) {
+        std::stringstream errMsg;
+        errMsg << "RollingOrigin(): " << folds << " folds requested, "
+               << "the data rows " << N_data << " fit " << maxFolds
+               << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    std::vector< EDM_Rolling::Fold > foldList( folds );
+
+    for ( int f = 0; f < folds; f++ ) {
+        EDM_Rolling::Fold &fold = foldList[ f ];
+
+        std::stringstream lib_f, pred_f;
+        lib_f  << libStart << " " << libEnd + f * step;
+        pred_f << libEnd + f * step + 1 << " " << libEnd + f * step + predRows;
+
+        fold.param = Parameters( method, "", "", "", "",
+                                 lib_f.str(), pred_f.str(),
+                                 E, Tp, knn, tau, theta,
+                                 colNames, targetName, embedded, false );
+        fold.param.exec = exec;
+
+        // Same test as FindNeighbors(): the valid library rows are a
+        // prefix of the library, and a prefix of the next fold's rows
+        size_t N_lib = fold.param.library.size();
+        for ( auto li  = fold.param.library.begin();
+                   li != fold.param.library.end(); ++li ) {
+            if ( *li + fold.param.Tp >= N_lib and
+                 not fold.param.noNeighborLimit ) {
+                continue;
+            }
+            fold.libRows.push_back( *li );
+        }
+
+        fold.neighbors = Neighbors();
+        fold.neighbors.neighbors = DataFrame<size_t>( predRows,
+                                                      fold.param.knn );
+        fold.neighbors.distances = DataFrame<double>( predRows,
+                                                      fold.param.knn );
+    }
+
+    //------------------------------------------------------------
+    // Neighbors: each prediction row walks the folds it belongs to,
+    // adding the library rows new to each fold
+    //------------------------------------------------------------
+    size_t predFirst = foldList.front().param.prediction.front();
+    size_t predLast  = foldList.back().param.prediction.back();
+
+    auto NeighborRows = [&]( size_t rowStart, size_t rowStop ) {
+        // ( distance, lib_row ) nearest first
+        std::vector< std::pair< double, size_t > > nearest;
+
+        for ( size_t pred_row = predFirst + rowStart;
+                     pred_row < predFirst + rowStop; pred_row++ ) {
+
+            const double *pred_vec = blockValues + pred_row * blockStride;
+
+            // Folds predicting this row, and their largest knn
+            std::vector< size_t > predFolds;
+            size_t knnMax = 0;
+            for ( size_t f = 0; f < foldList.size(); f++ ) {
+                const Parameters &fp = foldList[ f ].param;
+                if ( pred_row >= fp.prediction.front() and
+                     pred_row <= fp.prediction.back() ) {
+                    predFolds.push_back( f );
+                    knnMax = std::max( knnMax, (size_t) fp.knn );
+                }
+            }
+
+            nearest.clear();
+            size_t N_added = 0;
+
+            for ( auto fi = predFolds.begin(); fi != predFolds.end(); ++fi ) {
+                EDM_Rolling::Fold &fold = foldList[ *fi ];
+
+                // Library rows new to this fold
+                for ( size_t j = N_added; j < fold.libRows.size(); j++ ) {
+                    size_t lib_row = fold.libRows[ j ];
+                    if ( lib_row == pred_row ) {
+                        continue; // degenerate with the prediction
+                    }
+                    const double *lib_vec =
+                        blockValues + lib_row * blockStride;
+
+                    double d_i = Distance( lib_vec, pred_vec, blockStride,
+                                           DistanceMetric::Euclidean );
+                    if ( d_i < DISTANCE_MAX ) {
+                        nearest.push_back( std::make_pair( d_i, lib_row ) );
+                    }
+                }
+                N_added = fold.libRows.size();
+
+                size_t N_keep = std::min( knnMax, nearest.size() );
+                std::partial_sort( nearest.begin(), nearest.begin() + N_keep,
+                                   nearest.end() );
+                nearest.resize( N_keep );
+
+                size_t fold_knn = fold.param.knn;
+                if ( nearest.size() < fold_knn ) {
+                    std::stringstream errMsg;
+                    errMsg << "RollingOrigin(): Library is too small to "
+                           << "resolve " << fold_knn << " knn neighbors."
+                           << std::endl;
+                    throw std::runtime_error( errMsg.str() );
+                }
+
+                size_t row = pred_row - fold.param.prediction.front();
+                for ( size_t k = 0; k < fold_knn; k++ ) {
+                    fold.neighbors.neighbors( row, k ) = nearest[ k ].second;
+                    fold.neighbors.distances( row, k ) = nearest[ k ].first;
+                }
+            }
+        }
+    };
+
+    size_t grain = std::max( (size_t) 1,
+                             65536 / ( foldList.back().libRows.size() + 1 ) );
+
+    exec.Pool().ParallelForRange( predLast - predFirst + 1, grain,
+                                  NeighborRows, exec.nThreads );
+
+    //------------------------------------------------------------
+    // Projection of each fold
+    //------------------------------------------------------------
+    DataFrame< double > foldSkill( folds, 8, "Fold libStart libEnd "
+                                   "predStart predEnd rho RMSE MAE" );
+
+    exec.Pool().ParallelFor(
+        foldList.size(),
+        [&]( size_t f ) {
+            EDM_Rolling::Fold &fold = foldList[ f ];
+
+            DataEmbedNN foldEmbedNN = embedNN;
+            foldEmbedNN.neighbors   = fold.neighbors;
+
+            if ( method == Method::SMap ) {
+                fold.output = SMapProjection( fold.param,
+                                              foldEmbedNN ).predictions;
+            }
+            else {
+                fold.output = SimplexProjection( fold.param, foldEmbedNN );
+            }
+
+            VectorError ve = ComputeError(
+                fold.output.VectorColumnName( "Observations" ),
+                fold.output.VectorColumnName( "Predictions"  ) );
+
+            // 1-offset rows as in lib and pred
+            foldSkill.WriteRow( f, std::valarray<double>(
+                { (double) f, (double) libStart,
+                  (double) fold.param.library.back() + 1,
+                  (double) fold.param.prediction.front() + 1,
+                  (double) fold.param.prediction.back() + 1,
+                  ve.rho, ve.RMSE, ve.MAE } ) );
+
+            if ( verbose ) {
+                std::lock_guard<std::mutex> lck( EDM_Rolling::mtx );
+                std::cout << "RollingOrigin() fold " << f
+                          << "  lib " << libStart << " "
+                          << fold.param.library.back() + 1
+                          << "  rho " << ve.rho << "  RMSE " << ve.RMSE
+                          << "  MAE " << ve.MAE << std::endl;
+            }
+        },
+        exec.nThreads );
+
+    //------------------------------------------------------------
+    // Predictions of all folds, and skill of the pooled predictions
+    //------------------------------------------------------------
+    size_t N_out = 0;
+    for ( auto fi = foldList.begin(); fi != foldList.end(); ++fi ) {
+        N_out += fi->output.NRows();
+    }
+
+    DataFrame< double > predictions( N_out, 4,
+                                     "Fold Time Observations Predictions" );
+    std::vector< double > obsPooled;
+    std::vector< double > predPooled;
+
+    size_t outRow = 0;
+    for ( size_t f = 0; f < foldList.size(); f++ ) {
+        const DataFrame< double > &output = foldList[ f ].output;
+
+        for ( size_t row = 0; row < output.NRows(); row++ ) {
+            double obs  = output( row, 1 );
+            double pred = output( row, 2 );
+
+            predictions.WriteRow( outRow++, std::valarray<double>(
+                { (double) f, output( row, 0 ), obs, pred } ) );
+
+            if ( not std::isnan( obs ) and not std::isnan( pred ) ) {
+                obsPooled .push_back( obs  );
+                predPooled.push_back( pred );
+            }
+        }
+    }
+
+    VectorError pooled = ComputeError(
+        std::valarray< double >( obsPooled.data(),  obsPooled.size()  ),
+        std::valarray< double >( predPooled.data(), predPooled.size() ) );
+
+    DataFrame< double > skill( 1, 6, "rho RMSE MAE meanRho "
+                                     "meanRMSE meanMAE" );
+    skill.WriteRow( 0, std::valarray<double>(
+        { pooled.rho, pooled.RMSE, pooled.MAE,
+          foldSkill.VectorColumnName( "rho"  ).sum() / folds,
+          foldSkill.VectorColumnName( "RMSE" ).sum() / folds,
+          foldSkill.VectorColumnName( "MAE"  ).sum() / folds } ) );
+
+    if ( predictFile.size() ) {
+        foldSkill.WriteData( pathOut, predictFile );
+    }
+
+    RollingValues rolling = RollingValues();
+    rolling.Folds       = foldSkill;
+    rolling.Skill       = skill;
+    rolling.Predictions = predictions;
+
+    return rolling;
+}
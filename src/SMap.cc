@@ -24,6 +24,8 @@
 std::valarray< double > SVD( DataFrame    < double > A,
                              std::valarray< double > B );
 
+SMapValues SMapProjection( Parameters param, DataEmbedNN dataEmbedNN );
+
 //----------------------------------------------------------------
 // Overload 1: Explicit data file path/name
 //   Implemented as a wrapper to API Overload 2:
@@ -44,22 +46,24 @@ SMapValues SMap( std::string pathIn,
                  std::string smapFile,
                  std::string jacobians,
                  bool        embedded,
-                 bool        verbose )
+                 bool        verbose,
+                 ExecutionContext exec )
 {
-    // DataFrame constructor loads data
-    DataFrame< double > dataFrameIn( pathIn, dataFile );
+    // DataFrame constructor loads time, columns and target
+    DataFrame< double > dataFrameIn( pathIn, dataFile,
+                                     DataColumns( columns, target ) );
     
     SMapValues SMapOutput = SMap( dataFrameIn, pathOut, predictFile,
                                   lib, pred, E, Tp, knn, tau, theta, 
                                   columns, target, smapFile, jacobians, 
-                                  embedded, verbose );
+                                  embedded, verbose, exec );
     return SMapOutput;
 }
 
 //----------------------------------------------------------------
 // Overload 2: DataFrame provided
 //----------------------------------------------------------------
-SMapValues SMap( DataFrame< double > data,
+SMapValues SMap( const DataFrameView< double > &data,
                  std::string pathOut,
                  std::string predictFile,
                  std::string lib,
@@ -74,7 +78,8 @@ SMapValues SMap( DataFrame< double > data,
                  std::string smapFile,
                  std::string jacobians,
                  bool        embedded,
-                 bool        verbose )
+                 bool        verbose,
+                 ExecutionContext exec )
 {
 
     Parameters param = Parameters( Method::SMap, "", "",
@@ -82,17 +87,118 @@ SMapValues SMap( DataFrame< double > data,
                                    lib, pred, E, Tp, knn, tau, theta,
                                    columns, target, embedded, verbose,
                                    smapFile, "", jacobians );
+    param.exec = exec;
 
     //----------------------------------------------------------
     // Load data, Embed, compute Neighbors
     //----------------------------------------------------------
     DataEmbedNN dataEmbedNN = EmbedNN( data, param );
 
+    SMapValues values = SMapProjection( param, dataEmbedNN );
+
+    return values;
+}
+
+//----------------------------------------------------------------
+// Overload 2: float32 DataFrame provided
+//   Embedding and neighbors are float32, the SVD solve double
+//----------------------------------------------------------------
+SMapValues SMap( const DataFrameView< float > &data,
+                 std::string pathOut,
+                 std::string predictFile,
+                 std::string lib,
+                 std::string pred,
+                 int         E,
+                 int         Tp,
+                 int         knn,
+                 int         tau,
+                 double      theta,
+                 std::string columns,
+                 std::string target,
+                 std::string smapFile,
+                 std::string jacobians,
+                 bool        embedded,
+                 bool        verbose,
+                 ExecutionContext exec )
+{
+    Parameters param = Parameters( Method::SMap, "", "",
+                                   pathOut, predictFile,
+                                   lib, pred, E, Tp, knn, tau, theta,
+                                   columns, target, embedded, verbose,
+                                   smapFile, "", jacobians );
+    param.exec = exec;
+
+    DataEmbedNN dataEmbedNN = EmbedNN( data, param );
+
+    SMapValues values = SMapProjection( param, dataEmbedNN );
+
+    return values;
+}
+
+//----------------------------------------------------------------
+// Overload 3: DataFrame provided, output rows pushed to the sinks
+//----------------------------------------------------------------
+void SMap( const DataFrameView< double > &data,
+           ResultSink                    &predictionSink,
+           ResultSink                    *coefficientSink,
+           std::string                    lib,
+           std::string                    pred,
+           int                            E,
+           int                            Tp,
+           int                            knn,
+           int                            tau,
+           double                         theta,
+           std::string                    columns,
+           std::string                    target,
+           bool                           embedded,
+           bool                           verbose,
+           ExecutionContext               exec )
+{
+    Parameters param = Parameters( Method::SMap, "", "",
+                                   "./", "",
+                                   lib, pred, E, Tp, knn, tau, theta,
+                                   columns, target, embedded, verbose );
+    param.exec            = exec;
+    param.predictionSink  = &predictionSink;
+    param.coefficientSink = coefficientSink;
+
+    // Neighbors are searched a block of rows at a time by
+    // SMapProjection(), not for all prediction rows here
+    DataEmbedNN dataEmbedNN = EmbedSink( data, param );
+
+    SMapProjection( param, dataEmbedNN );
+}
+
+//----------------------------------------------------------------
+// SMap Projection
+//----------------------------------------------------------------
+SMapValues SMapProjection( Parameters param, DataEmbedNN dataEmbedNN ) {
+
     // Unpack the dataEmbedNN for convenience
-    DataFrame<double>     dataIn     = dataEmbedNN.dataIn;
-    DataFrame<double>     dataBlock  = dataEmbedNN.dataFrame;
-    std::valarray<double> target_vec = dataEmbedNN.targetVec;
-    Neighbors             neighbors  = dataEmbedNN.neighbors;
+    DataFrameView<double>   dataIn     = dataEmbedNN.dataIn;
+    std::valarray<double>   target_vec = dataEmbedNN.targetVec;
+
+    // With a sink, neighbors hold one block of rows of SinkNeighbors()
+    Neighbors               sinkNeighbors;
+    const Neighbors        &neighbors  = param.predictionSink ?
+                                         sinkNeighbors :
+                                         dataEmbedNN.neighbors;
+
+    // Embedding values: read in place from the embedding view, or
+    // from the data block (as double of float32 data)
+    const EmbeddingView<double> &embedding = dataEmbedNN.embedding;
+    const DataFrame<double>      dataBlock = embedding.NColumns() ?
+        DataFrame<double>() : EmbeddingBlock( dataEmbedNN );
+
+    // As of the unpadded row-major block: column NColumns() is
+    // column 0 of the next row, not the padding of aligned rows
+    auto Embedding = [&]( size_t row, size_t col ) {
+        if ( embedding.NColumns() ) {
+            return embedding( row, col );
+        }
+        return dataBlock( row + col / dataBlock.NColumns(),
+                          col % dataBlock.NColumns() );
+    };
     
     // target_vec spans the entire dataBlock, subset targetLibVector
     // to library for row indexing used below:
@@ -104,7 +210,8 @@ SMapValues SMap( DataFrame< double > data,
     //----------------------------------------------------------
     size_t library_N_row = param.library.size();
     size_t predict_N_row = param.prediction.size();
-    size_t N_row         = neighbors.neighbors.NRows();
+    size_t N_row         = param.predictionSink ? predict_N_row :
+                                                  neighbors.neighbors.NRows();
 
     if ( predict_N_row != N_row ) {
         std::stringstream errMsg;
@@ -113,7 +220,8 @@ SMapValues SMap( DataFrame< double > data,
                << N_row << ").\n";
         throw std::runtime_error( errMsg.str() );
     }
-    if ( neighbors.distances.NColumns() != param.knn ) {
+    if ( not param.predictionSink and
+         neighbors.distances.NColumns() != param.knn ) {
         std::stringstream errMsg;
         errMsg << "SMap(): Number of neighbor columns ("
                << neighbors.distances.NColumns()
@@ -121,80 +229,94 @@ SMapValues SMap( DataFrame< double > data,
         throw std::runtime_error( errMsg.str() );        
     }
     
-    std::valarray< double > predictions = std::valarray< double >( N_row );
+    // With a sink, neighbors, predictions and coefficients hold one
+    // block of rows from predStart
+    size_t predStart = 0;
+    size_t N_out     = param.predictionSink ?
+                       std::min( N_row, sinkBlockRows ) : N_row;
+
+    std::valarray< double > predictions = std::valarray< double >( N_out );
 
     // Init coefficients to NAN ?
-    DataFrame< double > coefficients = DataFrame< double >( N_row,
+    DataFrame< double > coefficients = DataFrame< double >( N_out,
                                                             param.E + 1 );
     DataFrame< double > jacobian;
     DataFrame< double > tangents;
 
     //------------------------------------------------------------
-    // Process each prediction row
+    // Process each prediction row: blocks of rows are distributed
+    // over the thread pool
     //------------------------------------------------------------
-    for ( size_t row = 0; row < N_row; row++ ) {
+    auto SMapRows = [&]( size_t rowStart, size_t rowStop ) {
+        for ( size_t row = rowStart; row < rowStop; row++ ) {
         
-        double D_avg = neighbors.distances.Row( row ).sum() / param.knn;
+            std::valarray< double > distanceRow =
+                neighbors.distances.Row( row - predStart );
 
-        // Compute weight vector 
-        std::valarray< double > w = std::valarray< double >( param.knn );
-        if ( param.theta > 0 ) {
-            w = std::exp( (-param.theta/D_avg) * neighbors.distances.Row(row) );
-        }
-        else {
-            w = std::valarray< double >( 1, param.knn );
-        }
+            double D_avg = distanceRow.sum() / param.knn;
 
-        DataFrame< double >     A = DataFrame< double >(param.knn, param.E + 1);
-        std::valarray< double > B = std::valarray< double >( param.knn );
+            // Compute weight vector 
+            std::valarray< double > w = std::valarray< double >( param.knn );
+            if ( param.theta > 0 ) {
+                w = std::exp( (-param.theta/D_avg) * distanceRow );
+            }
+            else {
+                w = std::valarray< double >( 1, param.knn );
+            }
+
+            DataFrame< double >     A = DataFrame< double >( param.knn,
+                                                             param.E + 1 );
+            std::valarray< double > B = std::valarray< double >( param.knn );
 
-        // Populate matrix A (exp weighted future prediction), and
-        // vector B (target BC's) for this row (observation).
-        size_t lib_row;
+            // Populate matrix A (exp weighted future prediction), and
+            // vector B (target BC's) for this row (observation).
+            size_t lib_row;
         
-        for ( size_t k = 0; k < param.knn; k++ ) {
-            lib_row = neighbors.neighbors( row, k ) + param.Tp;
+            for ( size_t k = 0; k < param.knn; k++ ) {
+                lib_row = neighbors.neighbors( row - predStart, k ) +
+                          param.Tp;
             
-            if ( lib_row > library_N_row ) {
-                // The knn index + Tp is outside the library domain
-                // Can only happen if noNeighborLimit = true is used.
-                if ( param.verbose ) {
-                    std::stringstream msg;
-                    msg << "SMap() in row " << row << " libRow " << lib_row
-                        << " exceeds library domain.\n";
-                    std::cout << msg.str();
-                }
+                if ( lib_row > library_N_row ) {
+                    // The knn index + Tp is outside the library domain
+                    // Can only happen if noNeighborLimit = true is used.
+                    if ( param.verbose ) {
+                        std::stringstream msg;
+                        msg << "SMap() in row " << row << " libRow " << lib_row
+                            << " exceeds library domain.\n";
+                        std::cout << msg.str();
+                    }
                 
-                // Use the neighbor at the 'base' of the trajectory
-                B[ k ] = targetLibVector[ lib_row - param.Tp ];
-            }
-            else {
-                B[ k ] = targetLibVector[ lib_row ];
-            }
+                    // Use the neighbor at the 'base' of the trajectory
+                    B[ k ] = targetLibVector[ lib_row - param.Tp ];
+                }
+                else {
+                    B[ k ] = targetLibVector[ lib_row ];
+                }
 
-            A( k, 0 ) = w[ k ];
-            for ( size_t j = 1; j < param.E + 1; j++ ) {
-                A( k, j ) = w[k] * dataBlock( param.prediction[ row ], j );
+                A( k, 0 ) = w[ k ];
+                for ( size_t j = 1; j < param.E + 1; j++ ) {
+                    A( k, j ) = w[k] * Embedding( param.prediction[ row ], j );
+                }
             }
-        }
 
-        B = w * B; // Weighted target vector
+            B = w * B; // Weighted target vector
 
-        // Estimate linear mapping of predictions A onto target B
-        std::valarray < double > C = SVD( A, B );
+            // Estimate linear mapping of predictions A onto target B
+            std::valarray < double > C = SVD( A, B );
 
-        // Prediction is local linear projection
-        double prediction = C[ 0 ]; // Note that C[ 0 ] is the bias term
+            // Prediction is local linear projection
+            double prediction = C[ 0 ]; // Note that C[ 0 ] is the bias term
 
-        for ( size_t e = 1; e < param.E + 1; e++ ) {
-            prediction = prediction + C[ e ] *
-                dataBlock( param.prediction[ row ], e );
-        }
+            for ( size_t e = 1; e < param.E + 1; e++ ) {
+                prediction = prediction + C[ e ] *
+                    Embedding( param.prediction[ row ], e );
+            }
 
-        predictions[ row ] = prediction;
-        coefficients.WriteRow( row, C );
+            predictions[ row - predStart ] = prediction;
+            coefficients.WriteRow( row - predStart, C );
 
-    } // for ( row = 0; row < predict_N_row; row++ )
+        } // for ( row = rowStart; row < rowStop; row++ )
+    };
 
     for ( size_t col = 0; col < coefficients.NColumns(); col++ ) {
         std::stringstream coefName;
@@ -202,6 +324,75 @@ SMapValues SMap( DataFrame< double > data,
         coefficients.ColumnNames().push_back( coefName.str() );
     }
 
+    if ( param.predictionSink ) {
+        //------------------------------------------------
+        // Project a block of rows at a time, push the output
+        // rows whose predictions are done to the sinks
+        //------------------------------------------------
+        CheckDataRows( param, dataIn, "SMap" );
+
+        ResultSink &sink     = *param.predictionSink;
+        ResultSink *coefSink = param.coefficientSink;
+        size_t      Tp       = param.Tp;
+
+        sink.Begin( { "Time", "Observations", "Predictions" } );
+        if ( coefSink ) {
+            std::vector< std::string > coefNames( 1, "Time" );
+            coefNames.insert( coefNames.end(),
+                              coefficients.ColumnNames().begin(),
+                              coefficients.ColumnNames().end() );
+            coefSink->Begin( coefNames );
+        }
+
+        // Rows before the first prediction
+        SinkOutput( param, N_row, 0, Tp, predictions, 0,
+                    dataIn, target_vec, sink );
+
+        std::vector< double > coefRows;
+
+        for ( predStart = 0; predStart < N_row;
+              predStart += sinkBlockRows ) {
+            size_t predStop = std::min( predStart + sinkBlockRows, N_row );
+
+            SinkNeighbors( dataEmbedNN, param, predStart, predStop,
+                           sinkNeighbors );
+
+            param.exec.Pool().ParallelForRange(
+                predStop - predStart, 8,
+                [&]( size_t start, size_t stop ) {
+                    SMapRows( predStart + start, predStart + stop );
+                },
+                param.exec.nThreads );
+
+            // Last block: and the Tp rows past the data
+            SinkOutput( param, N_row, predStart + Tp, predStop + Tp,
+                        predictions, predStart, dataIn, target_vec, sink );
+
+            if ( coefSink ) {
+                // Time and coefficients of the prediction rows
+                size_t N_columns = param.E + 2;
+                coefRows.resize( ( predStop - predStart ) * N_columns );
+
+                for ( size_t row = predStart; row < predStop; row++ ) {
+                    double *out = &coefRows[ ( row - predStart ) * N_columns ];
+                    out[ 0 ] = dataIn( param.prediction[ 0 ] + row, 0 );
+                    for ( size_t col = 1; col < N_columns; col++ ) {
+                        out[ col ] = coefficients( row - predStart, col - 1 );
+                    }
+                }
+                coefSink->Rows( coefRows.data(), predStop - predStart );
+            }
+        }
+
+        sink.End();
+        if ( coefSink ) { coefSink->End(); }
+
+        return SMapValues();
+    }
+
+    param.exec.Pool().ParallelForRange( N_row, 8, SMapRows,
+                                        param.exec.nThreads );
+
     //-----------------------------------------------------
     // Jacobians
     //-----------------------------------------------------
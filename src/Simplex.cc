@@ -27,24 +27,26 @@ DataFrame<double> Simplex( std::string pathIn,
                            std::string columns,
                            std::string target,
                            bool        embedded,
-                           bool        verbose ) {
+                           bool        verbose,
+                           ExecutionContext exec ) {
     
-    // DataFrame constructor loads data
-    DataFrame< double > dataFrameIn( pathIn, dataFile );
+    // DataFrame constructor loads time, columns and target
+    DataFrame< double > dataFrameIn( pathIn, dataFile,
+                                     DataColumns( columns, target ) );
 
     // Pass data frame to Simplex 
     DataFrame< double > S = Simplex( dataFrameIn, pathOut,
                                      predictFile, lib, pred,
                                      E, Tp, knn, tau,
                                      columns, target,
-                                     embedded, verbose);
+                                     embedded, verbose, exec );
     return S;
 }
 
 //----------------------------------------------------------------
 // API Overload 2: DataFrame provided
 //----------------------------------------------------------------
-DataFrame<double> Simplex( DataFrame< double > data,
+DataFrame<double> Simplex( const DataFrameView< double > &data,
                            std::string pathOut,
                            std::string predictFile,
                            std::string lib,
@@ -56,12 +58,14 @@ DataFrame<double> Simplex( DataFrame< double > data,
                            std::string columns,
                            std::string target,
                            bool        embedded,
-                           bool        verbose ) {
+                           bool        verbose,
+                           ExecutionContext exec ) {
 
     Parameters param = Parameters( Method::Simplex, "", "",
                                    pathOut, predictFile,
                                    lib, pred, E, Tp, knn, tau, 0,
                                    columns, target, embedded, verbose );
+    param.exec = exec;
 
     //----------------------------------------------------------
     // Embed, compute Neighbors
@@ -73,6 +77,69 @@ DataFrame<double> Simplex( DataFrame< double > data,
     return S;
 }
 
+//----------------------------------------------------------------
+// API Overload 2: float32 DataFrame provided
+//   Embedding and neighbors are float32, projections double
+//----------------------------------------------------------------
+DataFrame<double> Simplex( const DataFrameView< float > &data,
+                           std::string pathOut,
+                           std::string predictFile,
+                           std::string lib,
+                           std::string pred,
+                           int         E,
+                           int         Tp,
+                           int         knn,
+                           int         tau,
+                           std::string columns,
+                           std::string target,
+                           bool        embedded,
+                           bool        verbose,
+                           ExecutionContext exec ) {
+
+    Parameters param = Parameters( Method::Simplex, "", "",
+                                   pathOut, predictFile,
+                                   lib, pred, E, Tp, knn, tau, 0,
+                                   columns, target, embedded, verbose );
+    param.exec = exec;
+
+    DataEmbedNN embedNN = EmbedNN( data, param );
+
+    DataFrame<double> S = SimplexProjection( param, embedNN );
+
+    return S;
+}
+
+//----------------------------------------------------------------
+// API Overload 3: DataFrame provided, output rows pushed to sink
+//----------------------------------------------------------------
+void Simplex( const DataFrameView< double > &data,
+              ResultSink                    &sink,
+              std::string                    lib,
+              std::string                    pred,
+              int                            E,
+              int                            Tp,
+              int                            knn,
+              int                            tau,
+              std::string                    columns,
+              std::string                    target,
+              bool                           embedded,
+              bool                           verbose,
+              ExecutionContext               exec ) {
+
+    Parameters param = Parameters( Method::Simplex, "", "",
+                                   "./", "",
+                                   lib, pred, E, Tp, knn, tau, 0,
+                                   columns, target, embedded, verbose );
+    param.exec           = exec;
+    param.predictionSink = &sink;
+
+    // Neighbors are searched a block of rows at a time by
+    // SimplexProjection(), not for all prediction rows here
+    DataEmbedNN embedNN = EmbedSink( data, param );
+
+    SimplexProjection( param, embedNN );
+}
+
 //----------------------------------------------------------------
 // Simplex Projection
 //----------------------------------------------------------------
@@ -80,12 +147,16 @@ DataFrame<double> SimplexProjection( Parameters param, DataEmbedNN embedNN,
                                      bool checkDataRows ) {
 
     // Unpack the data, (embedding dataBlock not used), target & neighbors
-    DataFrame<double>     dataIn     = embedNN.dataIn;  // used for output
+    // With a sink, neighbors hold one block of rows of SinkNeighbors()
+    DataFrameView<double> dataIn     = embedNN.dataIn;  // used for output
     std::valarray<double> target_vec = embedNN.targetVec;
-    Neighbors             neighbors  = embedNN.neighbors;
+    Neighbors             sinkNeighbors;
+    const Neighbors      &neighbors  = param.predictionSink ?
+                                       sinkNeighbors : embedNN.neighbors;
 
     size_t library_N_row = param.library.size();
-    size_t N_row         = neighbors.neighbors.NRows();
+    size_t N_row         = param.predictionSink ? param.prediction.size() :
+                                                  neighbors.neighbors.NRows();
 
 #ifdef DEBUG_ALL
     std::cout << "Simplex -----------------------------------\n";
@@ -98,7 +169,8 @@ DataFrame<double> SimplexProjection( Parameters param, DataEmbedNN embedNN,
     std::cout << "-------------------------------------------\n\n";
 #endif
     
-    if ( N_row != neighbors.distances.NRows() ) {
+    if ( not param.predictionSink and
+         N_row != neighbors.distances.NRows() ) {
         std::stringstream errMsg;
         errMsg << "Simplex(): Number of neighbor rows " << N_row
                << " doesn't match the number of distances rows "
@@ -107,72 +179,129 @@ DataFrame<double> SimplexProjection( Parameters param, DataEmbedNN embedNN,
     }
 
     double minWeight = 1.E-6;
-    std::valarray<double> predictions( 0., N_row );
 
-    // Process each prediction row in neighbors
-    for ( size_t row = 0; row < N_row; row++ ) {
+    // With a sink, neighbors and predictions hold one block of rows
+    // from predStart
+    size_t predStart = 0;
+    std::valarray<double> predictions( 0., param.predictionSink ?
+                                       std::min( N_row, sinkBlockRows ) :
+                                       N_row );
 
-        std::valarray<double> distanceRow = neighbors.distances.Row( row );
+    // Process each prediction row in neighbors: blocks of rows
+    // are distributed over the thread pool
+    auto ProjectRows = [&]( size_t rowStart, size_t rowStop ) {
+        for ( size_t row = rowStart; row < rowStop; row++ ) {
+
+            std::valarray<double> distanceRow =
+                neighbors.distances.Row( row - predStart );
         
-        // Establish exponential weight reference, the 'distance scale'
-        double minDistance = distanceRow.min();
+            // Establish exponential weight reference, the 'distance scale'
+            double minDistance = distanceRow.min();
 
-        // Compute weight (vector) for each k_NN
-        std::valarray<double> weightedDistances( minWeight, param.knn );
+            // Compute weight (vector) for each k_NN
+            std::valarray<double> weightedDistances( minWeight, param.knn );
         
-        if ( minDistance == 0 ) {
-            // Handle cases of distanceRow = 0 : can't divide by minDistance
-            for ( size_t i = 0; i < param.knn; i++ ) {
-                if ( distanceRow[i] > 0 ) {
-                    weightedDistances[i] = exp( -distanceRow[i] / minDistance );
+            if ( minDistance == 0 ) {
+                // Handle cases of distanceRow = 0 : can't divide by minDistance
+                for ( size_t i = 0; i < param.knn; i++ ) {
+                    if ( distanceRow[i] > 0 ) {
+                        weightedDistances[i] =
+                            exp( -distanceRow[i] / minDistance );
+                    }
+                    else {
+                        // Setting weight = 1 implies that the corresponding
+                        // library target vector is the same as the observation
+                        // so it will be given full-weight in the prediction.
+                        weightedDistances[i] = 1;
+                    }
+                }
+            }
+            else {
+                // exp() is a valarray<> overload (vectorized?)
+                weightedDistances = exp( -distanceRow / minDistance );
+            }
+
+            // weight vector
+            std::valarray<double> weights( param.knn );
+            for  ( size_t i = 0; i < param.knn; i++ ) {
+                weights[i] = std::max( weightedDistances[i], minWeight );
+            }
+
+            // target library vector, one element for each knn
+            std::valarray<double> libTarget( param.knn );
+
+            for ( size_t k = 0; k < param.knn; k++ ) {
+                double libRow = neighbors.neighbors( row - predStart, k ) +
+                                param.Tp;
+
+                if ( libRow > library_N_row ) {
+                    // The k_NN index + Tp is outside the library domain
+                    // Can only happen if noNeighborLimit = true is used.
+                    if ( param.verbose ) {
+                        std::stringstream msg;
+                        msg << "Simplex() in row " << row << " libRow "
+                            << libRow << " exceeds library domain.\n";
+                        std::cout << msg.str();
+                    }
+                
+                    // Use the neighbor at the 'base' of the trajectory
+                    libTarget[ k ] = target_vec[ libRow - param.Tp ];
                 }
                 else {
-                    // Setting weight = 1 implies that the corresponding
-                    // library target vector is the same as the observation
-                    // so it will be given full-weight in the prediction.
-                    weightedDistances[i] = 1;
+                    libTarget[ k ] = target_vec[ libRow ];
                 }
             }
-        }
-        else {
-            // exp() is a valarray<> overload (vectorized?)
-            weightedDistances = exp( -distanceRow / minDistance );
-        }
 
-        // weight vector
-        std::valarray<double> weights( param.knn );
-        for  ( size_t i = 0; i < param.knn; i++ ) {
-            weights[i] = std::max( weightedDistances[i], minWeight );
+            // Prediction is average of weighted library projections
+            predictions[ row - predStart ] =
+                ( weights * libTarget ).sum() / weights.sum();
+        
+        } // for ( row = rowStart; row < rowStop; row++ )
+    };
+
+    if ( param.predictionSink ) {
+        //------------------------------------------------
+        // Project a block of rows at a time, push the output
+        // rows whose predictions are done to the sink
+        //------------------------------------------------
+        if ( checkDataRows ) {
+            CheckDataRows( param, dataIn, "Simplex" );
         }
+        ResultSink &sink = *param.predictionSink;
+        size_t      Tp   = param.Tp;
 
-        // target library vector, one element for each knn
-        std::valarray<double> libTarget( param.knn );
+        sink.Begin( { "Time", "Observations", "Predictions" } );
 
-        for ( size_t k = 0; k < param.knn; k++ ) {
-            double libRow = neighbors.neighbors( row, k ) + param.Tp;
+        // Rows before the first prediction
+        SinkOutput( param, N_row, 0, Tp, predictions, 0,
+                    dataIn, target_vec, sink );
 
-            if ( libRow > library_N_row ) {
-                // The k_NN index + Tp is outside the library domain
-                // Can only happen if noNeighborLimit = true is used.
-                if ( param.verbose ) {
-                    std::stringstream msg;
-                    msg << "Simplex() in row " << row << " libRow " << libRow
-                        << " exceeds library domain.\n";
-                    std::cout << msg.str();
-                }
-                
-                // Use the neighbor at the 'base' of the trajectory
-                libTarget[ k ] = target_vec[ libRow - param.Tp ];
-            }
-            else {
-                libTarget[ k ] = target_vec[ libRow ];
-            }
+        for ( predStart = 0; predStart < N_row;
+              predStart += sinkBlockRows ) {
+            size_t predStop = std::min( predStart + sinkBlockRows, N_row );
+
+            SinkNeighbors( embedNN, param, predStart, predStop,
+                           sinkNeighbors );
+
+            param.exec.Pool().ParallelForRange(
+                predStop - predStart, 64,
+                [&]( size_t start, size_t stop ) {
+                    ProjectRows( predStart + start, predStart + stop );
+                },
+                param.exec.nThreads );
+
+            // Last block: and the Tp rows past the data
+            SinkOutput( param, N_row, predStart + Tp, predStop + Tp,
+                        predictions, predStart, dataIn, target_vec, sink );
         }
 
-        // Prediction is average of weighted library projections
-        predictions[ row ] = ( weights * libTarget ).sum() / weights.sum();
-        
-    } // for ( row = 0; row < N_row; row++ )
+        sink.End();
+
+        return DataFrame<double>();
+    }
+
+    param.exec.Pool().ParallelForRange( N_row, 64, ProjectRows,
+                                        param.exec.nThreads );
 
     //----------------------------------------------------
     // Ouput
@@ -0,0 +1,412 @@
+
+#include <tuple>
+
+#include "Common.h"
+#include "Parameter.h"
+
+namespace EDM_Stream {
+    //------------------------------------------------------------
+    // Consecutive file rows of the selected columns, carried from
+    // one chunk to the next
+    //------------------------------------------------------------
+    struct Window {
+        size_t                first;     // file row of values[ 0 ]
+        size_t                N_columns;
+        std::vector< double > values;
+
+        Window( size_t N_columns ) : first( 0 ), N_columns( N_columns ) {}
+
+        // One past the last file row
+        size_t End() const { return first + values.size() / N_columns; }
+
+        double operator()( size_t row, size_t col ) const {
+            return values[ ( row - first ) * N_columns + col ];
+        }
+
+        void Append( const CSVData &chunk ) {
+            values.insert( values.end(), std::begin( chunk.elements ),
+                           std::end( chunk.elements ) );
+        }
+
+        // Drop the rows before file row
+        void Trim( size_t row ) {
+            size_t N_drop = std::min( row, End() ) - first;
+            values.erase( values.begin(),
+                          values.begin() + N_drop * N_columns );
+            first += N_drop;
+        }
+    };
+
+    //------------------------------------------------------------
+    // Embedding dimension: window column and lag of the delay
+    //------------------------------------------------------------
+    struct Dimension {
+        size_t column;
+        size_t lag;
+    };
+
+    //------------------------------------------------------------
+    // Index of file column name, or error
+    //------------------------------------------------------------
+    size_t FileColumn( const CSVChunkReader &reader, std::string name ) {
+        const std::vector< std::string > &names = reader.FileColumnNames();
+
+        auto ci = std::find( names.begin(), names.end(), name );
+        if ( ci == names.end() ) {
+            std::stringstream errMsg;
+            errMsg << "SimplexStream(): Failed to find column " << name
+                   << " in the data file." << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+        return std::distance( names.begin(), ci );
+    }
+}
+
+//----------------------------------------------------------------
+// SimplexStream() : Simplex() of a data file read in chunks of
+// chunkRows rows, for data that need not fit in memory.
+//
+// Only the time, columns and target columns are parsed. A first
+// pass over the file keeps the prediction delay vectors, a second
+// pass streams the library through the knn search of every
+// prediction row. Library row r is searched once the row holding
+// its target, r + Tp, has been read, so neighbor targets need no
+// further pass. Memory is bounded by the chunk, the prediction
+// rows and the tau * (E-1) + Tp rows carried between chunks.
+//
+// Neighbors, weights and output are those of Simplex(). Library
+// rows are visited in file order.
+//----------------------------------------------------------------
+DataFrame<double> SimplexStream( std::string pathIn,
+                                 std::string dataFile,
+                                 std::string pathOut,
+                                 std::string predictFile,
+                                 std::string lib,
+                                 std::string pred,
+                                 int         E,
+                                 int         Tp,
+                                 int         knn,
+                                 int         tau,
+                                 std::string columns,
+                                 std::string target,
+                                 bool        embedded,
+                                 bool        verbose,
+                                 size_t      chunkRows,
+                                 ExecutionContext exec ) {
+
+    Parameters param = Parameters( Method::Simplex, pathIn, dataFile,
+                                   pathOut, predictFile,
+                                   lib, pred, E, Tp, knn, tau, 0,
+                                   columns, target, embedded, verbose );
+
+    if ( param.Tp < 0 ) {
+        throw std::runtime_error( "SimplexStream(): Tp must be "
+                                  "non-negative.\n" );
+    }
+
+    CSVChunkReader reader( pathIn, dataFile, chunkRows );
+
+    //------------------------------------------------------------
+    // File columns: time, embedding columns, target
+    //------------------------------------------------------------
+    std::vector< size_t > embedColumns;
+    if ( param.columnNames.size() ) {
+        for ( auto ci  = param.columnNames.begin();
+                   ci != param.columnNames.end(); ++ci ) {
+            embedColumns.push_back( EDM_Stream::FileColumn( reader, *ci ) );
+        }
+    }
+    else {
+        embedColumns = param.columnIndex;
+    }
+    if ( embedColumns.empty() ) {
+        throw std::runtime_error( "SimplexStream(): colNames and "
+                                  " colIndex are empty.\n" );
+    }
+
+    size_t targetColumn = 1;
+    if ( param.targetIndex ) {
+        targetColumn = param.targetIndex;
+    }
+    else if ( param.targetName.size() ) {
+        targetColumn = EDM_Stream::FileColumn( reader, param.targetName );
+    }
+
+    std::vector< size_t > select( 1, 0 );
+    auto Select = [&]( size_t fileColumn ) {
+        auto si = std::find( select.begin(), select.end(), fileColumn );
+        if ( si == select.end() ) {
+            select.push_back( fileColumn );
+            return select.size() - 1;
+        }
+        return (size_t) std::distance( select.begin(), si );
+    };
+
+    std::vector< EDM_Stream::Dimension > dims;
+    for ( size_t i = 0; i < embedColumns.size(); i++ ) {
+        size_t column = Select( embedColumns[ i ] );
+        if ( param.embedded ) {
+            dims.push_back( { column, 0 } );
+        }
+        else {
+            for ( int e = 0; e < param.E; e++ ) {
+                dims.push_back( { column, (size_t) ( e * param.tau ) } );
+            }
+        }
+    }
+    size_t target_i = Select( targetColumn );
+
+    if ( param.embedded and (size_t) param.E != dims.size() ) {
+        std::stringstream errMsg;
+        errMsg << "SimplexStream(): The number of columns ("
+               << dims.size() << ") does not match the embedding "
+               << "dimension E (" << param.E << ")\n";
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    size_t shift     = param.embedded ? 0 : param.tau * ( param.E - 1 );
+    size_t N_dim     = dims.size();
+    size_t N_pred    = param.prediction.size();
+    size_t N_lib     = param.library.size();
+    size_t pred0     = param.prediction[ 0 ];
+    size_t knn_      = param.knn;
+
+    // Embedded row r is file row r + shift
+    auto Vector = [&]( const EDM_Stream::Window &window, size_t r,
+                       double *vec ) {
+        for ( size_t d = 0; d < N_dim; d++ ) {
+            vec[ d ] = window( r + shift - dims[ d ].lag, dims[ d ].column );
+        }
+    };
+
+    // Prediction rows in file order
+    std::vector< std::pair< size_t, size_t > > predOrder( N_pred );
+    for ( size_t i = 0; i < N_pred; i++ ) {
+        predOrder[ i ] = std::make_pair( param.prediction[ i ], i );
+    }
+    std::sort( predOrder.begin(), predOrder.end() );
+
+    //------------------------------------------------------------
+    // Pass 1: prediction vectors, output time and observations
+    //------------------------------------------------------------
+    reader.SelectColumns( select );
+
+    std::vector< double > predVectors( N_pred * N_dim );
+    std::valarray< double > time        ( N_pred + param.Tp );
+    std::valarray< double > observations( N_pred + param.Tp );
+
+    CSVData            chunk;
+    EDM_Stream::Window window( select.size() );
+    size_t             N_embed = 0; // next embedded row
+    size_t             pi      = 0;
+
+    while ( reader.NextChunk( chunk ) ) {
+        window.Append( chunk );
+
+        for ( ; N_embed + shift < window.End(); N_embed++ ) {
+            for ( ; pi < N_pred and predOrder[ pi ].first == N_embed; pi++ ) {
+                Vector( window, N_embed,
+                        &predVectors[ predOrder[ pi ].second * N_dim ] );
+            }
+            // As FormatOutput(): rows following the first prediction row
+            if ( N_embed >= pred0 and N_embed < pred0 + N_pred ) {
+                time        [ N_embed - pred0 ] = window( N_embed + shift, 0 );
+                observations[ N_embed - pred0 ] =
+                    window( N_embed + shift, target_i );
+            }
+        }
+        window.Trim( N_embed );
+    }
+
+    // As CheckDataRows()
+    size_t prediction_max_i = param.prediction[ N_pred - 1 ] + 1;
+    size_t library_max_i    = param.library   [ N_lib  - 1 ] + 1;
+
+    prediction_max_i = std::max( prediction_max_i, pred0 + N_pred );
+
+    if ( N_embed < prediction_max_i ) {
+        std::stringstream errMsg;
+        errMsg << "SimplexStream(): The prediction index "
+               << prediction_max_i
+               << " exceeds the number of data rows " << N_embed;
+        throw std::runtime_error( errMsg.str() );
+    }
+    if ( N_embed < library_max_i ) {
+        std::stringstream errMsg;
+        errMsg << "SimplexStream(): The library index " << library_max_i
+               << " exceeds the number of data rows " << N_embed;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    //------------------------------------------------------------
+    // Pass 2: stream the library through the knn search
+    //------------------------------------------------------------
+    std::vector< size_t > libRows( param.library );
+    std::sort( libRows.begin(), libRows.end() );
+
+    std::vector< size_t > k_NN_neighbors( N_pred * knn_, 0 );
+    std::vector< double > k_NN_distances( N_pred * knn_, DISTANCE_MAX );
+    std::vector< double > k_NN_targets  ( N_pred * knn_, 0 );
+
+    std::vector< size_t > batchRows;    // library rows of this chunk
+    std::vector< double > batchVectors;
+    std::vector< double > batchTargets;
+
+    CSVChunkReader libReader( pathIn, dataFile, chunkRows );
+    libReader.SelectColumns( select );
+
+    window = EDM_Stream::Window( select.size() );
+    size_t li = 0;
+
+    while ( li < libRows.size() and libReader.NextChunk( chunk ) ) {
+        window.Append( chunk );
+
+        batchRows.clear();
+        batchVectors.clear();
+        batchTargets.clear();
+
+        // Library rows with their target row read
+        for ( ; li < libRows.size() and
+                libRows[ li ] + param.Tp + shift < window.End(); li++ ) {
+            size_t lib_row = libRows[ li ];
+
+            // As FindNeighbors(): the neighbor would be outside the library
+            if ( lib_row + param.Tp >= N_lib ) {
+                continue;
+            }
+            batchRows.push_back( lib_row );
+            batchVectors.resize( batchRows.size() * N_dim );
+            Vector( window, lib_row, &batchVectors[ batchVectors.size() -
+                                                    N_dim ] );
+            batchTargets.push_back( window( lib_row + param.Tp + shift,
+                                            target_i ) );
+        }
+
+        // Blocks of prediction rows over the thread pool
+        size_t grain = std::max( (size_t) 1,
+                                 65536 / ( batchRows.size() + 1 ) );
+
+        exec.Pool().ParallelForRange(
+            N_pred, grain,
+            [&]( size_t rowStart, size_t rowStop ) {
+                for ( size_t i = rowStart; i < rowStop; i++ ) {
+                    size_t  pred_row  = param.prediction[ i ];
+                    double *pred_vec  = &predVectors[ i * N_dim ];
+                    size_t *neighbors = &k_NN_neighbors[ i * knn_ ];
+                    double *distances = &k_NN_distances[ i * knn_ ];
+                    double *targets   = &k_NN_targets  [ i * knn_ ];
+
+                    for ( size_t b = 0; b < batchRows.size(); b++ ) {
+                        if ( batchRows[ b ] == pred_row ) {
+                            continue;
+                        }
+
+                        const double *lib_vec = &batchVectors[ b * N_dim ];
+                        double sum = 0;
+                        for ( size_t d = 0; d < N_dim; d++ ) {
+                            double delta = pred_vec[ d ] - lib_vec[ d ];
+                            sum += delta * delta;
+                        }
+                        double d_i = sqrt( sum );
+
+                        double *max_it = std::max_element( distances,
+                                                           distances + knn_ );
+                        if ( d_i < *max_it ) {
+                            size_t max_i = max_it - distances;
+                            neighbors[ max_i ] = batchRows[ b ];
+                            distances[ max_i ] = d_i;
+                            targets  [ max_i ] = batchTargets[ b ];
+                        }
+                    }
+                }
+            },
+            exec.nThreads );
+
+        // Keep the rows of the next library row
+        window.Trim( li < libRows.size() ? libRows[ li ] : window.End() );
+    }
+
+    //------------------------------------------------------------
+    // Projection: as SimplexProjection()
+    //------------------------------------------------------------
+    double minWeight = 1.E-6;
+    std::valarray< double > predictionsOut( N_pred + param.Tp );
+    std::vector< double >   weights( knn_ );
+
+    // ( distance, lib_row, target ) of the knn of a row
+    std::vector< std::tuple< double, size_t, double > > nearest( knn_ );
+
+    for ( size_t i = 0; i < N_pred; i++ ) {
+        double *distances = &k_NN_distances[ i * knn_ ];
+        double *targets   = &k_NN_targets  [ i * knn_ ];
+
+        if ( *std::max_element( distances, distances + knn_ ) >
+             DISTANCE_LIMIT ) {
+            std::stringstream errMsg;
+            errMsg << "SimplexStream(): Library is too small to resolve "
+                   << knn_ << " knn neighbors." << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+
+        // Nearest first, ties by library row: as FindNeighbors()
+        size_t *neighbors = &k_NN_neighbors[ i * knn_ ];
+        for ( size_t k = 0; k < knn_; k++ ) {
+            nearest[ k ] = std::make_tuple( distances[ k ], neighbors[ k ],
+                                            targets[ k ] );
+        }
+        std::sort( nearest.begin(), nearest.end() );
+        for ( size_t k = 0; k < knn_; k++ ) {
+            distances[ k ] = std::get< 0 >( nearest[ k ] );
+            neighbors[ k ] = std::get< 1 >( nearest[ k ] );
+            targets  [ k ] = std::get< 2 >( nearest[ k ] );
+        }
+
+        double minDistance = *std::min_element( distances,
+                                                distances + knn_ );
+        for ( size_t k = 0; k < knn_; k++ ) {
+            double w;
+            if ( minDistance == 0 ) {
+                w = distances[ k ] > 0 ? exp( -distances[ k ] / minDistance )
+                                       : 1;
+            }
+            else {
+                w = exp( -distances[ k ] / minDistance );
+            }
+            weights[ k ] = std::max( w, minWeight );
+        }
+
+        // Summation order of the valarray sum() in SimplexProjection()
+        double weightSum = weights[ 0 ];
+        for ( size_t k = 1; k < knn_; k++ ) {
+            weightSum += weights[ k ];
+        }
+        double predSum = weights[ knn_ - 1 ] * targets[ knn_ - 1 ];
+        for ( size_t k = knn_ - 1; k-- > 0; ) {
+            predSum += weights[ k ] * targets[ k ];
+        }
+        predictionsOut[ i + param.Tp ] = predSum / weightSum;
+    }
+
+    //------------------------------------------------------------
+    // Output: as FormatOutput()
+    //------------------------------------------------------------
+    for ( size_t i = N_pred; i < N_pred + param.Tp; i++ ) {
+        time        [ i ] = time[ i - 1 ] + param.Tp;
+        observations[ i ] = NAN;
+    }
+    for ( int i = 0; i < param.Tp; i++ ) {
+        predictionsOut[ i ] = NAN;
+    }
+
+    DataFrame< double > S( N_pred + param.Tp, 3,
+                           "Time Observations Predictions" );
+    S.WriteColumn( 0, time );
+    S.WriteColumn( 1, observations );
+    S.WriteColumn( 2, predictionsOut );
+
+    if ( param.predictOutputFile.size() ) {
+        S.WriteData( param.pathOut, param.predictOutputFile );
+    }
+
+    return S;
+}
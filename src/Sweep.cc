@@ -0,0 +1,720 @@
+
+#include <mutex>
+
+#include "Sweep.h"
+
+// forward declarations
+DataFrame<double> SimplexProjection( Parameters  param,
+                                     DataEmbedNN embedNN,
+                                     bool        checkDataRows = true );
+
+SMapValues SMapProjection( Parameters param, DataEmbedNN dataEmbedNN );
+
+namespace EDM_Sweep {
+    std::mutex mtx;
+
+    //------------------------------------------------------------
+    // Parse a list of numbers from a string
+    //------------------------------------------------------------
+    template< typename T >
+    std::vector< T > ParseList( std::string values, std::string name ) {
+        std::vector< std::string > tokens = SplitString( values, " \t," );
+        std::vector< T > list;
+        for ( auto ti = tokens.begin(); ti != tokens.end(); ++ti ) {
+            list.push_back( (T) std::stod( *ti ) );
+        }
+        if ( name.size() and not list.size() ) {
+            std::stringstream errMsg;
+            errMsg << "ParameterSweep(): " << name << " list is empty.\n";
+            throw std::runtime_error( errMsg.str() );
+        }
+        return list;
+    }
+
+    //------------------------------------------------------------
+    // lib_row is a valid neighbor at Tp: same test as FindNeighbors()
+    //------------------------------------------------------------
+    bool ValidNeighbor( const Parameters &param, size_t lib_row, int Tp ) {
+        if ( lib_row + Tp >= param.library.size() ) {
+            return param.noNeighborLimit;
+        }
+        return true;
+    }
+}
+
+//----------------------------------------------------------------
+// SweepGrid constructor: parse the lists of the grid
+//----------------------------------------------------------------
+SweepGrid::SweepGrid( std::string E_str,   std::string Tp_str,
+                      std::string tau_str, std::string knn_str,
+                      std::string theta_str ) :
+    E    ( EDM_Sweep::ParseList< int    >( E_str,     "E"   ) ),
+    Tp   ( EDM_Sweep::ParseList< int    >( Tp_str,    "Tp"  ) ),
+    tau  ( EDM_Sweep::ParseList< int    >( tau_str,   "tau" ) ),
+    knn  ( EDM_Sweep::ParseList< int    >( knn_str,   "knn" ) ),
+    theta( EDM_Sweep::ParseList< double >( theta_str, ""    ) ) {}
+
+//----------------------------------------------------------------
+// knn of a grid point: knn = 0 is resolved as in Parameters
+//----------------------------------------------------------------
+int SweepKnn( const SweepGrid &grid, int knn, int E, int Tp, size_t N_lib ) {
+    if ( knn > 0 ) {
+        return knn;
+    }
+    return grid.SMap() ? (int) N_lib - Tp : E + 1;
+}
+
+//----------------------------------------------------------------
+// Embedding of one (E, tau) stage. Candidates are not computed.
+//----------------------------------------------------------------
+SweepStage MakeSweepStage( const DataFrameView< double > &data,
+                           const SweepGrid               &grid,
+                           int                            E,
+                           int                            tau,
+                           std::string                    lib,
+                           std::string                    pred,
+                           std::string                    columns,
+                           std::string                    target,
+                           bool                           embedded,
+                           ExecutionContext               exec )
+{
+    SweepStage stage;
+    stage.E   = E;
+    stage.tau = tau;
+    stage.Tp  = grid.Tp;
+
+    int TpMin = *std::min_element( grid.Tp.begin(), grid.Tp.end() );
+
+    stage.param = Parameters( Method::Simplex, "", "", "", "",
+                              lib, pred, E, TpMin, 0, tau, 0,
+                              columns, target, embedded, false );
+    stage.param.exec = exec;
+
+    stage.embedNN = EmbedData( data, stage.param );
+
+    if ( embedded and
+         stage.embedNN.dataFrame.NColumns() != (size_t) E ) {
+        std::stringstream errMsg;
+        errMsg << "ParameterSweep(): E = " << E
+               << " does not match the number of embedded columns "
+               << stage.embedNN.dataFrame.NColumns() << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    //------------------------------------------------------------
+    // Number of candidates: the largest knn of the grid, plus the
+    // largest number of library rows that are valid neighbors at
+    // some Tp of the grid but not at a particular Tp.
+    //------------------------------------------------------------
+    const Parameters &param = stage.param;
+    size_t N_lib = param.library.size();
+
+    int knnMax = 0;
+    for ( auto ki = grid.knn.begin(); ki != grid.knn.end(); ++ki ) {
+        for ( auto Tpi = grid.Tp.begin(); Tpi != grid.Tp.end(); ++Tpi ) {
+            knnMax = std::max( knnMax, SweepKnn( grid, *ki, E, *Tpi, N_lib ));
+        }
+    }
+
+    size_t N_eligible = 0;
+    std::vector< size_t > N_excluded( grid.Tp.size(), 0 );
+
+    for ( size_t row_j = 0; row_j < N_lib; row_j++ ) {
+        size_t lib_row = param.library[ row_j ];
+        bool   valid   = false;
+        for ( auto Tpi = grid.Tp.begin(); Tpi != grid.Tp.end(); ++Tpi ) {
+            valid = valid or EDM_Sweep::ValidNeighbor( param, lib_row, *Tpi );
+        }
+        if ( not valid ) { continue; }
+
+        N_eligible++;
+        for ( size_t i = 0; i < grid.Tp.size(); i++ ) {
+            if ( not EDM_Sweep::ValidNeighbor( param, lib_row, grid.Tp[i] )) {
+                N_excluded[ i ]++;
+            }
+        }
+    }
+
+    size_t N_excludedMax = *std::max_element( N_excluded.begin(),
+                                              N_excluded.end() );
+
+    stage.N_candidates = std::min( N_eligible, (size_t) std::max( knnMax, 0 ) +
+                                               N_excludedMax );
+
+    size_t N_pred = param.prediction.size();
+    stage.candidates = DataFrame< size_t >( N_pred, stage.N_candidates );
+    stage.distances  = DataFrame< double >( N_pred, stage.N_candidates );
+    stage.N_valid    = std::vector< size_t >( N_pred, 0 );
+    stage.N_rows     = 0;
+
+    return stage;
+}
+
+//----------------------------------------------------------------
+// Embeddings of each (E, tau) of the grid, without candidates
+//----------------------------------------------------------------
+std::vector< SweepStage > SweepStages( const DataFrameView< double > &data,
+                                       const SweepGrid               &grid,
+                                       std::string                    lib,
+                                       std::string                    pred,
+                                       std::string                    columns,
+                                       std::string                    target,
+                                       bool                           embedded,
+                                       ExecutionContext               exec )
+{
+    std::vector< std::pair< int, int > > E_tau;
+    for ( auto Ei = grid.E.begin(); Ei != grid.E.end(); ++Ei ) {
+        for ( auto ti = grid.tau.begin(); ti != grid.tau.end(); ++ti ) {
+            E_tau.push_back( std::make_pair( *Ei, *ti ) );
+        }
+    }
+
+    std::vector< SweepStage > stages( E_tau.size() );
+
+    exec.Pool().ParallelFor( stages.size(),
+                             [&]( size_t i ) {
+                                 stages[ i ] = MakeSweepStage(
+                                     data, grid,
+                                     E_tau[ i ].first, E_tau[ i ].second,
+                                     lib, pred, columns, target,
+                                     embedded, exec );
+                             },
+                             exec.nThreads );
+    return stages;
+}
+
+//----------------------------------------------------------------
+// Grid points of the stages: ordered by (E, tau), knn, Tp, theta
+//----------------------------------------------------------------
+std::vector< SweepPoint > SweepPoints( const SweepGrid &grid,
+                                       const std::vector<SweepStage> &stages )
+{
+    std::vector< double > thetas( grid.theta );
+    if ( not grid.SMap() ) {
+        thetas.push_back( 0 );
+    }
+
+    std::vector< SweepPoint > points;
+    for ( size_t s = 0; s < stages.size(); s++ ) {
+        size_t N_lib = stages[ s ].param.library.size();
+        for ( auto ki = grid.knn.begin(); ki != grid.knn.end(); ++ki ) {
+            for ( auto Tpi = grid.Tp.begin(); Tpi != grid.Tp.end(); ++Tpi ) {
+                for ( auto thi = thetas.begin(); thi != thetas.end(); ++thi ) {
+                    SweepPoint point;
+                    point.stage = s;
+                    point.Tp    = *Tpi;
+                    point.knn   = SweepKnn( grid, *ki, stages[ s ].E,
+                                            *Tpi, N_lib );
+                    point.theta = *thi;
+                    points.push_back( point );
+                }
+            }
+        }
+    }
+    return points;
+}
+
+//----------------------------------------------------------------
+// Find candidates of prediction rows [stage.N_rows, N_rows)
+//----------------------------------------------------------------
+void SweepCandidates( SweepStage &stage, size_t N_rows,
+                      ExecutionContext exec )
+{
+    const Parameters &param = stage.param;
+
+    N_rows = std::min( N_rows, param.prediction.size() );
+    if ( N_rows <= stage.N_rows ) {
+        return;
+    }
+
+    // Aligned, zero padded rows for the distance kernel, made once
+    // and kept for the later calls of the stage
+    if ( stage.block.NRows() == 0 ) {
+        stage.block = EmbeddingBlock( stage.embedNN ).
+            ToLayout( DataFrameLayout::RowMajor, true );
+    }
+    const double *blockValues = stage.block.Data();
+    size_t        blockStride = stage.block.Stride();
+
+    size_t N_lib = param.library.size();
+
+    // Library rows that are a valid neighbor at one or more Tp
+    std::vector< size_t > libRows;
+    for ( size_t row_j = 0; row_j < N_lib; row_j++ ) {
+        size_t lib_row = param.library[ row_j ];
+        for ( auto Tpi = stage.Tp.begin(); Tpi != stage.Tp.end(); ++Tpi ) {
+            if ( EDM_Sweep::ValidNeighbor( param, lib_row, *Tpi ) ) {
+                libRows.push_back( lib_row );
+                break;
+            }
+        }
+    }
+
+    auto CandidateRows = [&]( size_t rowStart, size_t rowStop ) {
+        // ( distance, lib_row ) : ties are ordered by library row
+        std::vector< std::pair< double, size_t > > libDistances;
+        libDistances.reserve( libRows.size() );
+
+        for ( size_t row_i = rowStart; row_i < rowStop; row_i++ ) {
+            size_t pred_row = param.prediction[ row_i ];
+            const double *pred_vec = blockValues + pred_row * blockStride;
+
+            libDistances.clear();
+            for ( auto li = libRows.begin(); li != libRows.end(); ++li ) {
+                if ( *li == pred_row ) {
+                    continue; // degenerate with the prediction
+                }
+                const double *lib_vec = blockValues + *li * blockStride;
+
+                double d_i = Distance( lib_vec, pred_vec, blockStride,
+                                       DistanceMetric::Euclidean );
+                if ( d_i < DISTANCE_MAX ) {
+                    libDistances.push_back( std::make_pair( d_i, *li ) );
+                }
+            }
+
+            size_t N_valid = std::min( stage.N_candidates,
+                                       libDistances.size() );
+            std::partial_sort( libDistances.begin(),
+                               libDistances.begin() + N_valid,
+                               libDistances.end() );
+
+            for ( size_t k = 0; k < N_valid; k++ ) {
+                stage.distances ( row_i, k ) = libDistances[ k ].first;
+                stage.candidates( row_i, k ) = libDistances[ k ].second;
+            }
+            stage.N_valid[ row_i ] = N_valid;
+        }
+    };
+
+    size_t grain = std::max( (size_t) 1, 65536 / ( libRows.size() + 1 ) );
+
+    exec.Pool().ParallelForRange( N_rows - stage.N_rows, grain,
+                                  [&]( size_t start, size_t stop ) {
+                                      CandidateRows( stage.N_rows + start,
+                                                     stage.N_rows + stop );
+                                  },
+                                  exec.nThreads );
+
+    stage.N_rows = N_rows;
+}
+
+//----------------------------------------------------------------
+// Neighbors of the first N_rows prediction rows at (Tp, knn):
+// the first knn candidates that are valid at Tp
+//----------------------------------------------------------------
+Neighbors SweepNeighbors( const SweepStage &stage, int Tp, int knn,
+                          size_t N_rows )
+{
+    if ( N_rows > stage.N_rows ) {
+        std::stringstream errMsg;
+        errMsg << "SweepNeighbors(): " << N_rows << " rows requested, "
+               << "candidates found for " << stage.N_rows << std::endl;
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    Neighbors neighbors = Neighbors();
+    neighbors.neighbors = DataFrame< size_t >( N_rows, knn );
+    neighbors.distances = DataFrame< double >( N_rows, knn );
+
+    for ( size_t row = 0; row < N_rows; row++ ) {
+        int k = 0;
+        for ( size_t c = 0; c < stage.N_valid[ row ] and k < knn; c++ ) {
+            size_t lib_row = stage.candidates( row, c );
+            if ( not EDM_Sweep::ValidNeighbor( stage.param, lib_row, Tp ) ) {
+                continue;
+            }
+            neighbors.neighbors( row, k ) = lib_row;
+            neighbors.distances( row, k ) = stage.distances( row, c );
+            k++;
+        }
+
+        if ( k < knn ) {
+            std::stringstream errMsg;
+            errMsg << "ParameterSweep(): Library is too small to resolve "
+                   << knn << " knn neighbors." << std::endl;
+            throw std::runtime_error( errMsg.str() );
+        }
+    }
+
+    return neighbors;
+}
+
+//----------------------------------------------------------------
+// Projection of one grid point over the first N_rows prediction rows
+//----------------------------------------------------------------
+VectorError SweepEvaluate( const SweepStage &stage,
+                           const SweepGrid  &grid,
+                           const SweepPoint &point,
+                           size_t            N_rows,
+                           ExecutionContext  exec )
+{
+    const Parameters &stageParam = stage.param;
+
+    Parameters param = Parameters( grid.SMap() ? Method::SMap :
+                                                 Method::Simplex,
+                                   "", "", "", "",
+                                   stageParam.lib_str, stageParam.pred_str,
+                                   stage.E, point.Tp, point.knn, stage.tau,
+                                   point.theta,
+                                   stageParam.columns_str,
+                                   stageParam.target_str,
+                                   stageParam.embedded, false );
+    param.exec = exec;
+    param.prediction.resize( N_rows );
+
+    DataEmbedNN embedNN = stage.embedNN;
+    embedNN.neighbors   = SweepNeighbors( stage, point.Tp, point.knn, N_rows );
+
+    DataFrame< double > S;
+    if ( grid.SMap() ) {
+        S = SMapProjection( param, embedNN ).predictions;
+    }
+    else {
+        S = SimplexProjection( param, embedNN );
+    }
+
+    VectorError ve = ComputeError( S.VectorColumnName( "Observations" ),
+                                   S.VectorColumnName( "Predictions"  ) );
+    return ve;
+}
+
+//----------------------------------------------------------------
+// ParameterSweep() : Evaluate rho, RMSE, MAE over a grid of
+// E, Tp, tau, knn and theta.
+// API Overload 1: Explicit data file path/name
+//     Implemented as a wrapper to API Overload 2:
+//----------------------------------------------------------------
+DataFrame<double> ParameterSweep( std::string pathIn,
+                                  std::string dataFile,
+                                  std::string pathOut,
+                                  std::string predictFile,
+                                  std::string lib,
+                                  std::string pred,
+                                  std::string E,
+                                  std::string Tp,
+                                  std::string tau,
+                                  std::string knn,
+                                  std::string theta,
+                                  std::string colNames,
+                                  std::string targetName,
+                                  bool        embedded,
+                                  bool        verbose,
+                                  ExecutionContext exec ) {
+
+    // Create DataFrame (constructor loads data)
+    DataFrame< double > dataFrameIn( pathIn, dataFile,
+                                     DataColumns( colNames, targetName ) );
+
+    DataFrame<double> sweep = ParameterSweep( dataFrameIn, pathOut,
+                                              predictFile, lib, pred,
+                                              E, Tp, tau, knn, theta,
+                                              colNames, targetName,
+                                              embedded, verbose, exec );
+    return sweep;
+}
+
+//----------------------------------------------------------------
+// ParameterSweep()
+// API Overload 2: DataFrame provided
+//
+// An embedding is built once for each (E, tau), and the neighbor
+// candidates of each prediction row are found once for that
+// embedding.  The neighbors of each (Tp, knn) are selected from
+// the candidates, and the projections of each (Tp, knn, theta)
+// are distributed over the thread pool.
+//
+// Neighbors are ordered nearest first, ties by library row, as
+// those of FindNeighbors(): results equal Simplex() and SMap().
+//----------------------------------------------------------------
+DataFrame<double> ParameterSweep( const DataFrameView< double > &data,
+                                  std::string                    pathOut,
+                                  std::string                    predictFile,
+                                  std::string                    lib,
+                                  std::string                    pred,
+                                  std::string                    E,
+                                  std::string                    Tp,
+                                  std::string                    tau,
+                                  std::string                    knn,
+                                  std::string                    theta,
+                                  std::string                    colNames,
+                                  std::string                    targetName,
+                                  bool                           embedded,
+                                  bool                           verbose,
+                                  ExecutionContext               exec ) {
+
+    SweepGrid grid = SweepGrid( E, Tp, tau, knn, theta );
+
+    // Embedding of each (E, tau), candidates of all prediction rows
+    std::vector< SweepStage > stages =
+        SweepStages( data, grid, lib, pred, colNames, targetName,
+                     embedded, exec );
+
+    exec.Pool().ParallelFor( stages.size(),
+                             [&]( size_t i ) {
+                                 SweepCandidates( stages[ i ],
+                                     stages[ i ].param.prediction.size(),
+                                     exec );
+                             },
+                             exec.nThreads );
+
+    std::vector< SweepPoint > points = SweepPoints( grid, stages );
+
+    DataFrame<double> sweep( points.size(), 8,
+                             "E Tp tau knn theta rho RMSE MAE" );
+
+    exec.Pool().ParallelFor(
+        points.size(),
+        [&]( size_t i ) {
+            const SweepPoint &point = points[ i ];
+            const SweepStage &stage = stages[ point.stage ];
+
+            VectorError ve = SweepEvaluate( stage, grid, point,
+                                            stage.param.prediction.size(),
+                                            exec );
+
+            sweep.WriteRow( i, std::valarray<double>(
+                { (double) stage.E, (double) point.Tp, (double) stage.tau,
+                  (double) point.knn, point.theta,
+                  ve.rho, ve.RMSE, ve.MAE } ) );
+
+            if ( verbose ) {
+                std::lock_guard<std::mutex> lck( EDM_Sweep::mtx );
+                std::cout << "ParameterSweep() E " << stage.E
+                          << "  Tp " << point.Tp << "  tau " << stage.tau
+                          << "  knn " << point.knn
+                          << "  theta " << point.theta
+                          << "  rho " << ve.rho << "  RMSE " << ve.RMSE
+                          << "  MAE " << ve.MAE << std::endl;
+            }
+        },
+        exec.nThreads );
+
+    if ( predictFile.size() ) {
+        sweep.WriteData( pathOut, predictFile );
+    }
+
+    return sweep;
+}
+
+//----------------------------------------------------------------
+// ParameterSearch() : Successive halving over the grid of
+// ParameterSweep().
+// API Overload 1: Explicit data file path/name
+//     Implemented as a wrapper to API Overload 2:
+//----------------------------------------------------------------
+SearchValues ParameterSearch( std::string pathIn,
+                              std::string dataFile,
+                              std::string pathOut,
+                              std::string predictFile,
+                              std::string lib,
+                              std::string pred,
+                              std::string E,
+                              std::string Tp,
+                              std::string tau,
+                              std::string knn,
+                              std::string theta,
+                              std::string colNames,
+                              std::string targetName,
+                              bool        embedded,
+                              bool        verbose,
+                              size_t      minRows,
+                              double      eta,
+                              ExecutionContext exec ) {
+
+    // Create DataFrame (constructor loads data)
+    DataFrame< double > dataFrameIn( pathIn, dataFile,
+                                     DataColumns( colNames, targetName ) );
+
+    SearchValues search = ParameterSearch( dataFrameIn, pathOut,
+                                           predictFile, lib, pred,
+                                           E, Tp, tau, knn, theta,
+                                           colNames, targetName,
+                                           embedded, verbose,
+                                           minRows, eta, exec );
+    return search;
+}
+
+//----------------------------------------------------------------
+// ParameterSearch()
+// API Overload 2: DataFrame provided
+//
+// All configurations are evaluated on the first minRows prediction
+// rows. The best 1/eta of them by rho are kept and evaluated on eta
+// times more rows, until one configuration is evaluated on all the
+// prediction rows, or all rows are used.  minRows = 0 sizes the first
+// round so that the last round uses all rows.
+//
+// Embeddings and neighbor candidates are shared with ParameterSweep():
+// each round extends the candidates of the surviving (E, tau) stages
+// to the new rows.  The cost is reported as prediction rows projected
+// (evaluations) against those of an exhaustive ParameterSweep().
+//----------------------------------------------------------------
+SearchValues ParameterSearch( const DataFrameView< double > &data,
+                              std::string                    pathOut,
+                              std::string                    predictFile,
+                              std::string                    lib,
+                              std::string                    pred,
+                              std::string                    E,
+                              std::string                    Tp,
+                              std::string                    tau,
+                              std::string                    knn,
+                              std::string                    theta,
+                              std::string                    colNames,
+                              std::string                    targetName,
+                              bool                           embedded,
+                              bool                           verbose,
+                              size_t                         minRows,
+                              double                         eta,
+                              ExecutionContext               exec ) {
+
+    if ( eta <= 1 ) {
+        std::stringstream errMsg;
+        errMsg << "ParameterSearch(): eta must be greater than 1.\n";
+        throw std::runtime_error( errMsg.str() );
+    }
+
+    SweepGrid grid = SweepGrid( E, Tp, tau, knn, theta );
+
+    std::vector< SweepStage > stages =
+        SweepStages( data, grid, lib, pred, colNames, targetName,
+                     embedded, exec );
+
+    std::vector< SweepPoint > points = SweepPoints( grid, stages );
+
+    size_t N_points = points.size();
+    size_t N_pred   = stages.front().param.prediction.size();
+
+    //------------------------------------------------------------
+    // Prediction rows of the first round
+    //------------------------------------------------------------
+    int TpMax = 0;
+    for ( auto Tpi = grid.Tp.begin(); Tpi != grid.Tp.end(); ++Tpi ) {
+        TpMax = std::max( TpMax, std::abs( *Tpi ) );
+    }
+    // Fewest rows for a meaningful ComputeError()
+    size_t rowsFloor = std::min( N_pred, (size_t) ( 3 * TpMax + 10 ) );
+
+    size_t N_rows = minRows;
+    if ( N_rows == 0 ) {
+        double N_rounds = std::ceil( std::log( (double) N_points ) /
+                                     std::log( eta ) );
+        N_rows = (size_t) ( N_pred / std::pow( eta, N_rounds ) );
+    }
+    N_rows = std::min( N_pred, std::max( N_rows, rowsFloor ) );
+
+    //------------------------------------------------------------
+    // Rounds
+    //------------------------------------------------------------
+    // E Tp tau knn theta round rows rho RMSE MAE
+    DataFrame< double > configs( N_points, 10,
+                                 "E Tp tau knn theta round rows rho RMSE MAE" );
+    std::vector< std::valarray< double > > rounds;
+
+    std::vector< size_t > survivors( N_points );
+    std::iota( survivors.begin(), survivors.end(), 0 );
+
+    std::vector< double > rho( N_points, 0 );
+
+    SearchValues search = SearchValues();
+    search.evaluations  = 0;
+    search.exhaustive   = N_points * N_pred;
+
+    for ( size_t round = 0; ; round++ ) {
+        if ( survivors.size() == 1 ) {
+            N_rows = N_pred;
+        }
+
+        // Extend the candidates of the stages in use to N_rows
+        std::vector< size_t > stagesInUse;
+        for ( auto si = survivors.begin(); si != survivors.end(); ++si ) {
+            stagesInUse.push_back( points[ *si ].stage );
+        }
+        std::sort( stagesInUse.begin(), stagesInUse.end() );
+        stagesInUse.erase( std::unique( stagesInUse.begin(),
+                                        stagesInUse.end() ),
+                           stagesInUse.end() );
+
+        exec.Pool().ParallelFor( stagesInUse.size(),
+                                 [&]( size_t i ) {
+                                     SweepCandidates( stages[stagesInUse[i]],
+                                                      N_rows, exec );
+                                 },
+                                 exec.nThreads );
+
+        // Evaluate the survivors on the first N_rows prediction rows
+        exec.Pool().ParallelFor(
+            survivors.size(),
+            [&]( size_t i ) {
+                size_t            point_i = survivors[ i ];
+                const SweepPoint &point   = points[ point_i ];
+                const SweepStage &stage   = stages[ point.stage ];
+
+                VectorError ve = SweepEvaluate( stage, grid, point,
+                                                N_rows, exec );
+
+                // rho is NAN for constant predictions: rank last
+                rho[ point_i ] = std::isnan( ve.rho ) ? -2 : ve.rho;
+
+                configs.WriteRow( point_i, std::valarray<double>(
+                    { (double) stage.E, (double) point.Tp,
+                      (double) stage.tau, (double) point.knn, point.theta,
+                      (double) round, (double) N_rows,
+                      ve.rho, ve.RMSE, ve.MAE } ) );
+            },
+            exec.nThreads );
+
+        search.evaluations += survivors.size() * N_rows;
+        rounds.push_back( std::valarray<double>(
+            { (double) round, (double) N_rows, (double) survivors.size(),
+              (double) ( survivors.size() * N_rows ) } ) );
+
+        if ( verbose ) {
+            std::cout << "ParameterSearch() round " << round
+                      << "  rows " << N_rows
+                      << "  configurations " << survivors.size() << std::endl;
+        }
+
+        // Rank by rho, grid order breaks ties
+        std::stable_sort( survivors.begin(), survivors.end(),
+                          [&rho]( size_t a, size_t b ) {
+                              return rho[ a ] > rho[ b ];
+                          } );
+
+        if ( N_rows == N_pred ) {
+            break;
+        }
+
+        size_t N_keep = (size_t) std::ceil( survivors.size() / eta );
+        survivors.resize( std::max( N_keep, (size_t) 1 ) );
+
+        N_rows = std::min( N_pred, (size_t) std::ceil( N_rows * eta ) );
+    }
+
+    //------------------------------------------------------------
+    // Output
+    //------------------------------------------------------------
+    search.Configs = configs;
+
+    search.Best = DataFrame< double >( 1, configs.NColumns(),
+                                       "E Tp tau knn theta round "
+                                       "rows rho RMSE MAE" );
+    search.Best.WriteRow( 0, configs.Row( survivors.front() ) );
+
+    search.Rounds = DataFrame< double >( rounds.size(), 4,
+                                         "round rows configs evaluations" );
+    for ( size_t i = 0; i < rounds.size(); i++ ) {
+        search.Rounds.WriteRow( i, rounds[ i ] );
+    }
+
+    if ( verbose ) {
+        std::cout << "ParameterSearch() evaluations " << search.evaluations
+                  << "  exhaustive " << search.exhaustive << std::endl;
+    }
+
+    if ( predictFile.size() ) {
+        configs.WriteData( pathOut, predictFile );
+    }
+
+    return search;
+}
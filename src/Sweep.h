@@ -0,0 +1,101 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "Common.h"
+#include "Parameter.h"
+#include "Neighbors.h"
+#include "AuxFunc.h"
+
+//----------------------------------------------------------------
+// Parameter grid of ParameterSweep()
+// An empty theta list evaluates Simplex, otherwise SMap.
+//----------------------------------------------------------------
+struct SweepGrid {
+    std::vector< int >    E;
+    std::vector< int >    Tp;
+    std::vector< int >    tau;
+    std::vector< int >    knn;   // 0 : Simplex E+1, SMap all neighbors
+    std::vector< double > theta;
+
+    SweepGrid() {}
+    SweepGrid( std::string E_str,   std::string Tp_str,
+               std::string tau_str, std::string knn_str,
+               std::string theta_str );
+
+    bool SMap() const { return theta.size() > 0; }
+};
+
+//----------------------------------------------------------------
+// Embedding and candidate neighbors shared by all grid points of
+// one (E, tau) pair.
+//
+// Candidates of a prediction row are the nearest library rows that
+// are valid neighbors at one or more Tp of the grid, sorted by
+// distance.  There are enough candidates that the first knn of them
+// valid at a given Tp are the knn nearest neighbors at that Tp, so
+// the neighbors of every (Tp, knn) are selected without a search.
+//
+// Candidates are found for the first N_rows prediction rows, and
+// can be extended to more rows with SweepCandidates().
+//----------------------------------------------------------------
+struct SweepStage {
+    int                 E;
+    int                 tau;
+    Parameters          param;        // lib, pred, columns, target
+    DataEmbedNN         embedNN;      // embedding & target, no neighbors
+    std::vector< int >  Tp;           // Tp of the grid
+    size_t              N_candidates; // candidate columns
+    DataFrame< size_t > candidates;   // library rows, nearest first
+    DataFrame< double > distances;    // distances of candidates
+    std::vector<size_t> N_valid;      // candidates found in each row
+    size_t              N_rows;       // prediction rows with candidates
+    DataFrame< double > block;        // aligned rows of the embedding,
+                                      // made by the first SweepCandidates()
+};
+
+// One grid point: knn is resolved ( > 0 )
+struct SweepPoint {
+    size_t stage;   // index of the (E, tau) stage
+    int    Tp;
+    int    knn;
+    double theta;
+};
+
+// Prototypes
+int SweepKnn( const SweepGrid &grid, int knn, int E, int Tp, size_t N_lib );
+
+SweepStage MakeSweepStage( const DataFrameView< double > &data,
+                           const SweepGrid               &grid,
+                           int                            E,
+                           int                            tau,
+                           std::string                    lib,
+                           std::string                    pred,
+                           std::string                    columns,
+                           std::string                    target,
+                           bool                           embedded,
+                           ExecutionContext               exec );
+
+std::vector< SweepStage > SweepStages( const DataFrameView< double > &data,
+                                       const SweepGrid               &grid,
+                                       std::string                    lib,
+                                       std::string                    pred,
+                                       std::string                    columns,
+                                       std::string                    target,
+                                       bool                           embedded,
+                                       ExecutionContext               exec );
+
+std::vector< SweepPoint > SweepPoints( const SweepGrid &grid,
+                                       const std::vector<SweepStage> &stages );
+
+void SweepCandidates( SweepStage &stage, size_t N_rows,
+                      ExecutionContext exec );
+
+Neighbors SweepNeighbors( const SweepStage &stage, int Tp, int knn,
+                          size_t N_rows );
+
+VectorError SweepEvaluate( const SweepStage &stage,
+                           const SweepGrid  &grid,
+                           const SweepPoint &point,
+                           size_t            N_rows,
+                           ExecutionContext  exec );
+#endif
@@ -0,0 +1,294 @@
+
+#include <exception>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ThreadPool.h"
+
+namespace EDM_Pool {
+    // Identify pool workers so nested calls push onto their own deque
+    thread_local ThreadPool *workerPool = nullptr;
+    thread_local size_t      worker_i   = 0;
+
+    std::mutex                   sharedMtx;
+    std::unique_ptr< ThreadPool > sharedPool;
+
+    //------------------------------------------------------------
+    // State of one ParallelFor() call, shared with its helper tasks.
+    // Helpers that start after all indices are claimed do nothing.
+    //------------------------------------------------------------
+    struct Job {
+        size_t                N;
+        size_t                grain;
+        std::atomic< size_t > next;  // next unclaimed index
+        std::atomic< size_t > done;  // indices completed or skipped
+
+        const std::function< void(size_t,size_t) > *func;
+
+        std::mutex              mtx;
+        std::condition_variable cv;
+        std::exception_ptr      error;
+
+        Job( size_t N, size_t grain,
+             const std::function< void(size_t,size_t) > *func ) :
+            N( N ), grain( grain ), next( 0 ), done( 0 ), func( func ) {}
+
+        //--------------------------------------------------------
+        // Claim and run blocks until the range is exhausted
+        //--------------------------------------------------------
+        void Run() {
+            size_t start = next.fetch_add( grain );
+
+            while ( start < N ) {
+                size_t stop = std::min( start + grain, N );
+                try {
+                    (*func)( start, stop );
+                }
+                catch ( ... ) {
+                    {
+                        std::lock_guard< std::mutex > lck( mtx );
+                        if ( not error ) { error = std::current_exception(); }
+                    }
+                    // Cancel unclaimed blocks: count them as done
+                    size_t unclaimed = next.exchange( N );
+                    if ( unclaimed < N ) { Finish( N - unclaimed ); }
+                }
+                Finish( stop - start );
+                start = next.fetch_add( grain );
+            }
+        }
+
+        void Finish( size_t n ) {
+            if ( done.fetch_add( n ) + n == N ) {
+                std::lock_guard< std::mutex > lck( mtx );
+                cv.notify_all();
+            }
+        }
+
+        void Wait() {
+            std::unique_lock< std::mutex > lck( mtx );
+            cv.wait( lck, [this]{ return done.load() >= N; } );
+        }
+    };
+}
+
+//----------------------------------------------------------------
+// Constructor: nThreads = 0 uses one thread per core
+//----------------------------------------------------------------
+ThreadPool::ThreadPool( unsigned nThreads, bool pinThreads ) :
+    pending( 0 ), nextQueue( 0 ), stop( false ), pinThreads( pinThreads )
+{
+    if ( nThreads == 0 ) {
+        nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+
+    for ( unsigned i = 0; i < nThreads; i++ ) {
+        queues.push_back( std::unique_ptr< TaskQueue >( new TaskQueue() ) );
+    }
+
+    for ( unsigned i = 0; i < nThreads; i++ ) {
+        workers.push_back( std::thread( &ThreadPool::WorkerLoop, this, i ) );
+
+#ifdef __linux__
+        if ( pinThreads ) {
+            unsigned nCPU = std::max( 1u, std::thread::hardware_concurrency() );
+            cpu_set_t cpuSet;
+            CPU_ZERO( &cpuSet );
+            CPU_SET( i % nCPU, &cpuSet );
+            pthread_setaffinity_np( workers.back().native_handle(),
+                                    sizeof( cpu_set_t ), &cpuSet );
+        }
+#endif
+    }
+}
+
+//----------------------------------------------------------------
+// Destructor: drain queued tasks and join workers
+//----------------------------------------------------------------
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard< std::mutex > lck( mtx );
+        stop = true;
+    }
+    cv.notify_all();
+
+    for ( auto &thrd : workers ) {
+        thrd.join();
+    }
+}
+
+//----------------------------------------------------------------
+// Queue a task: on the calling worker's deque if the caller is
+// a worker of this pool, otherwise round robin over the deques.
+//----------------------------------------------------------------
+void ThreadPool::Push( Task task ) {
+
+    size_t queue_i;
+    if ( EDM_Pool::workerPool == this ) {
+        queue_i = EDM_Pool::worker_i;
+    }
+    else {
+        queue_i = nextQueue.fetch_add( 1 ) % queues.size();
+    }
+
+    // Counted before the task is visible: a thief that pops it
+    // decrements pending after this increment, never below zero
+    {
+        std::lock_guard< std::mutex > lck( mtx );
+        pending++;
+    }
+    {
+        std::lock_guard< std::mutex > lck( queues[ queue_i ]->mtx );
+        queues[ queue_i ]->tasks.push_back( std::move( task ) );
+    }
+    cv.notify_one();
+}
+
+//----------------------------------------------------------------
+// Pop from the back of our own deque, else steal from the front
+// of the other deques.
+//----------------------------------------------------------------
+bool ThreadPool::TryPop( size_t worker_i, Task &task ) {
+
+    {
+        TaskQueue &q = *queues[ worker_i ];
+        std::lock_guard< std::mutex > lck( q.mtx );
+        if ( not q.tasks.empty() ) {
+            task = std::move( q.tasks.back() );
+            q.tasks.pop_back();
+            pending--;
+            return true;
+        }
+    }
+
+    for ( size_t i = 1; i < queues.size(); i++ ) {
+        TaskQueue &q = *queues[ ( worker_i + i ) % queues.size() ];
+        std::lock_guard< std::mutex > lck( q.mtx );
+        if ( not q.tasks.empty() ) {
+            task = std::move( q.tasks.front() );
+            q.tasks.pop_front();
+            pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------
+// Worker thread
+//----------------------------------------------------------------
+void ThreadPool::WorkerLoop( size_t worker_i ) {
+
+    EDM_Pool::workerPool = this;
+    EDM_Pool::worker_i   = worker_i;
+
+    Task task;
+
+    while ( true ) {
+        if ( TryPop( worker_i, task ) ) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock< std::mutex > lck( mtx );
+        cv.wait( lck, [this]{ return stop or pending.load() > 0; } );
+
+        if ( stop and pending.load() == 0 ) {
+            break;
+        }
+    }
+}
+
+//----------------------------------------------------------------
+// ParallelForRange: func( start, stop ) over blocks of grain indices
+// maxWorkers : maximum number of threads including the caller,
+//              0 : pool size
+//----------------------------------------------------------------
+void ThreadPool::ParallelForRange(
+    size_t N, size_t grain,
+    const std::function< void(size_t,size_t) > &func,
+    unsigned maxWorkers )
+{
+    if ( N == 0 ) { return; }
+    if ( grain == 0 ) { grain = 1; }
+
+    size_t nBlocks = ( N + grain - 1 ) / grain;
+
+    if ( maxWorkers == 0 or maxWorkers > NThreads() ) {
+        maxWorkers = NThreads();
+    }
+
+    // Caller is one of the workers
+    size_t nHelpers = std::min( (size_t) maxWorkers, nBlocks ) - 1;
+
+    if ( nHelpers == 0 ) {
+        func( 0, N );
+        return;
+    }
+
+    std::shared_ptr< EDM_Pool::Job > job =
+        std::make_shared< EDM_Pool::Job >( N, grain, &func );
+
+    for ( size_t i = 0; i < nHelpers; i++ ) {
+        Push( [job]() { job->Run(); } );
+    }
+
+    job->Run();
+    job->Wait();
+
+    if ( job->error ) {
+        std::rethrow_exception( job->error );
+    }
+}
+
+//----------------------------------------------------------------
+// ParallelFor: func( i ) for each index
+//----------------------------------------------------------------
+void ThreadPool::ParallelFor( size_t N,
+                              const std::function< void( size_t ) > &func,
+                              unsigned maxWorkers )
+{
+    ParallelForRange( N, 1,
+                      [&func]( size_t start, size_t stop ) {
+                          for ( size_t i = start; i < stop; i++ ) {
+                              func( i );
+                          }
+                      },
+                      maxWorkers );
+}
+
+//----------------------------------------------------------------
+// ExecutionContext
+//----------------------------------------------------------------
+ThreadPool &ExecutionContext::Pool() const {
+    return pool ? *pool : SharedThreadPool();
+}
+
+ExecutionContext ExecutionContext::Limit( unsigned n ) const {
+    ExecutionContext exec( *this );
+    if ( n and ( exec.nThreads == 0 or n < exec.nThreads ) ) {
+        exec.nThreads = n;
+    }
+    return exec;
+}
+
+//----------------------------------------------------------------
+// Shared library pool
+//----------------------------------------------------------------
+ThreadPool &SharedThreadPool() {
+    std::lock_guard< std::mutex > lck( EDM_Pool::sharedMtx );
+    if ( not EDM_Pool::sharedPool ) {
+        EDM_Pool::sharedPool.reset( new ThreadPool() );
+    }
+    return *EDM_Pool::sharedPool;
+}
+
+void ConfigureSharedThreadPool( unsigned nThreads, bool pinThreads ) {
+    std::lock_guard< std::mutex > lck( EDM_Pool::sharedMtx );
+    EDM_Pool::sharedPool.reset( new ThreadPool( nThreads, pinThreads ) );
+}
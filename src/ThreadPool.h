@@ -0,0 +1,96 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+
+//----------------------------------------------------------------
+// ThreadPool
+// Persistent work-stealing thread pool shared by all EDM engines.
+//
+// Each worker owns a task deque: it pops from the back of its own
+// deque and steals from the front of the other deques when idle.
+//
+// ParallelFor() splits an index range over up to maxWorkers threads.
+// The calling thread participates in the loop. A ParallelFor() issued
+// from inside a worker (nested parallelism: Multiview combos ->
+// neighbor rows, CCM directions -> samples) queues its helper tasks
+// on the worker's own deque where idle workers can steal them. No
+// threads are created, so nesting never oversubscribes the machine.
+//----------------------------------------------------------------
+class ThreadPool {
+
+public:
+    ThreadPool( unsigned nThreads = 0, bool pinThreads = false );
+    ~ThreadPool();
+
+    unsigned NThreads() const { return workers.size(); }
+    bool     Pinned()   const { return pinThreads;     }
+
+    // Call func( i ) for i in [0, N)
+    void ParallelFor( size_t N,
+                      const std::function< void( size_t ) > &func,
+                      unsigned maxWorkers = 0 );
+
+    // Call func( start, stop ) for consecutive blocks of grain indices
+    void ParallelForRange( size_t N, size_t grain,
+                           const std::function< void(size_t,size_t) > &func,
+                           unsigned maxWorkers = 0 );
+
+private:
+    typedef std::function< void() > Task;
+
+    // One task deque per worker
+    struct TaskQueue {
+        std::mutex        mtx;
+        std::deque< Task > tasks;
+    };
+
+    std::vector< std::thread >                  workers;
+    std::vector< std::unique_ptr< TaskQueue > > queues;
+
+    std::mutex              mtx;      // Sleep/wake of idle workers
+    std::condition_variable cv;
+    std::atomic< size_t >   pending;  // Tasks pushed, not yet started:
+                                      // counted before they are queued
+    std::atomic< size_t >   nextQueue;// Round robin for external pushes
+    bool                    stop;
+    bool                    pinThreads;
+
+    void Push      ( Task task );
+    bool TryPop    ( size_t worker_i, Task &task );
+    void WorkerLoop( size_t worker_i );
+};
+
+//----------------------------------------------------------------
+// ExecutionContext
+// Accepted by the API functions to select the pool and the maximum
+// concurrency of a call.  The default is the shared library pool
+// with no limit beyond the pool size.
+//----------------------------------------------------------------
+struct ExecutionContext {
+    ThreadPool *pool;     // nullptr : SharedThreadPool()
+    unsigned    nThreads; // maximum concurrency, 0 : pool size
+
+    ExecutionContext( ThreadPool *pool = nullptr, unsigned nThreads = 0 ) :
+        pool( pool ), nThreads( nThreads ) {}
+
+    ThreadPool &Pool() const;
+
+    // Context with concurrency limited to nThreads (0 : unchanged)
+    ExecutionContext Limit( unsigned n ) const;
+};
+
+// Library wide pool, created on first use with one thread per core
+ThreadPool &SharedThreadPool();
+
+// Replace the shared pool. Must not be called while work is running.
+void ConfigureSharedThreadPool( unsigned nThreads   = 0,
+                                bool     pinThreads = false );
+#endif
@@ -0,0 +1,331 @@
+// Arrow C Data Interface test
+
+#include "TestCommon.h"
+
+//----------------------------------------------------------------
+// Host (producer) release callbacks: count calls
+//----------------------------------------------------------------
+int schemaReleased = 0;
+int arrayReleased  = 0;
+
+void HostReleaseSchema( struct ArrowSchema *schema ) {
+    schemaReleased++;
+    schema->release = nullptr;
+}
+
+void HostReleaseArray( struct ArrowArray *array ) {
+    arrayReleased++;
+    array->release = nullptr;
+}
+
+//----------------------------------------------------------------
+// Host struct array of 2 float64 children over values, rows from
+// offset, validity of the struct
+//----------------------------------------------------------------
+struct HostStruct {
+    const void        *aBuffers[ 2 ];
+    const void        *bBuffers[ 2 ];
+    const void        *sBuffers[ 1 ];
+    struct ArrowSchema aSchema;
+    struct ArrowSchema bSchema;
+    struct ArrowSchema *childSchema[ 2 ];
+    struct ArrowSchema schema;
+    struct ArrowArray  aArray;
+    struct ArrowArray  bArray;
+    struct ArrowArray  *childArray[ 2 ];
+    struct ArrowArray  array;
+
+    HostStruct( const double  *a,        int64_t aOffset,
+                const double  *b,        int64_t bOffset,
+                int64_t        length,   int64_t offset,
+                int64_t        childLength,
+                const uint8_t *validity, int64_t nullCount ) {
+        aBuffers[ 0 ] = nullptr;  aBuffers[ 1 ] = a;
+        bBuffers[ 0 ] = nullptr;  bBuffers[ 1 ] = b;
+        sBuffers[ 0 ] = validity;
+
+        aSchema = { "g", "a", nullptr, 0, 0, nullptr, nullptr,
+                    HostReleaseSchema, nullptr };
+        bSchema = { "g", "b", nullptr, 0, 0, nullptr, nullptr,
+                    HostReleaseSchema, nullptr };
+        childSchema[ 0 ] = &aSchema;
+        childSchema[ 1 ] = &bSchema;
+        schema = { "+s", "", nullptr, 0, 2, childSchema, nullptr,
+                   HostReleaseSchema, nullptr };
+
+        aArray = { childLength, 0, aOffset, 2, 0, aBuffers, nullptr,
+                   nullptr, HostReleaseArray, nullptr };
+        bArray = { childLength, 0, bOffset, 2, 0, bBuffers, nullptr,
+                   nullptr, HostReleaseArray, nullptr };
+        childArray[ 0 ] = &aArray;
+        childArray[ 1 ] = &bArray;
+        array = { length, nullCount, offset, 1, 2, sBuffers, childArray,
+                  nullptr, HostReleaseArray, nullptr };
+    }
+};
+
+int main () {
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // Export, then import: values and column names round trip
+    //---------------------------------------------------------
+    DataFrame< double > data( "../data/", "LorenzData1000.csv" );
+
+    struct ArrowSchema schema;
+    struct ArrowArray  array;
+    ExportArrow( data, &schema, &array );
+
+    if ( std::string( schema.format ) != "+s" or
+         schema.n_children != (int64_t) data.NColumns() or
+         array.length      != (int64_t) data.NRows() or
+         std::string( schema.children[ 1 ]->name ) !=
+         data.ColumnNames()[ 1 ] ) {
+        failed++;
+        std::cout << RED_TEXT << "ExportArrow(): schema or array differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    // Columns of the export are one block: imported in place
+    const void *exported = array.children[ 0 ]->buffers[ 1 ];
+
+    DataFrame< double > imported = ImportArrow( &schema, &array );
+
+    if ( imported.Data() != exported ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): exported columns copied"
+                  << RESET_TEXT << std::endl;
+    }
+
+    if ( schema.release or array.release ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): schema or array not"
+                  << " released" << RESET_TEXT << std::endl;
+    }
+    if ( imported.ColumnNames() != data.ColumnNames() ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): column names differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    MakeTest( "Arrow round trip", data, imported );
+
+    //---------------------------------------------------------
+    // Host struct array: float64 and float32 children, struct
+    // offset of 1, one null in x
+    //---------------------------------------------------------
+    double  x[] = { 9., 1., 2., 3., 4. };
+    float   y[] = { 9.f, 0.5f, 1.5f, 2.5f, 3.5f };
+    uint8_t xValid[] = { 0x17 }; // rows 0 1 2 4 valid: x[ 3 ] null
+
+    const void *xBuffers[] = { xValid, x };
+    const void *yBuffers[] = { nullptr, y };
+    const void *sBuffers[] = { nullptr };
+
+    struct ArrowSchema xSchema = { "g", "x", nullptr, ARROW_FLAG_NULLABLE,
+                                   0, nullptr, nullptr,
+                                   HostReleaseSchema, nullptr };
+    struct ArrowSchema ySchema = { "f", "y", nullptr, 0,
+                                   0, nullptr, nullptr,
+                                   HostReleaseSchema, nullptr };
+    struct ArrowSchema *childSchema[] = { &xSchema, &ySchema };
+    struct ArrowSchema  hostSchema = { "+s", "", nullptr, 0,
+                                       2, childSchema, nullptr,
+                                       HostReleaseSchema, nullptr };
+
+    struct ArrowArray xArray = { 5, 1, 0, 2, 0, xBuffers, nullptr, nullptr,
+                                 HostReleaseArray, nullptr };
+    struct ArrowArray yArray = { 5, 0, 0, 2, 0, yBuffers, nullptr, nullptr,
+                                 HostReleaseArray, nullptr };
+    struct ArrowArray *childArray[] = { &xArray, &yArray };
+    struct ArrowArray  hostArray = { 4, 0, 1, 1, 2, sBuffers, childArray,
+                                     nullptr, HostReleaseArray, nullptr };
+
+    DataFrame< double > host = ImportArrow( &hostSchema, &hostArray );
+
+    DataFrame< double > expected( 4, 2, "x y" );
+    double values[] = { 1., 0.5, 2., 1.5, NAN, 2.5, 4., 3.5 };
+    for ( size_t i = 0; i < 8; i++ ) {
+        expected( i / 2, i % 2 ) = values[ i ];
+    }
+
+    bool equal = host.NRows() == 4 and host.NColumns() == 2 and
+                 host.ColumnNames() == expected.ColumnNames();
+    for ( size_t i = 0; equal and i < 8; i++ ) {
+        double a = host( i / 2, i % 2 );
+        double b = expected( i / 2, i % 2 );
+        equal = a == b or ( std::isnan( a ) and std::isnan( b ) );
+    }
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): host struct array values"
+                  << " differ" << RESET_TEXT << std::endl;
+    }
+    if ( schemaReleased != 1 or arrayReleased != 1 ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): host release callbacks"
+                  << " differ" << RESET_TEXT << std::endl;
+    }
+
+    MakeTest( "Arrow host struct array", expected, host );
+
+    //---------------------------------------------------------
+    // Exported children moved out by the consumer outlive the
+    // released parent
+    //---------------------------------------------------------
+    ExportArrow( data, &schema, &array );
+
+    struct ArrowSchema movedSchema = *schema.children[ 2 ];
+    struct ArrowArray  moved       = *array.children[ 2 ];
+    schema.children[ 2 ]->release = nullptr;
+    array.children [ 2 ]->release = nullptr;
+
+    schema.release( &schema );
+    array.release ( &array );
+
+    const double *column = static_cast< const double * >( moved.buffers[ 1 ] );
+    equal = std::string( movedSchema.name ) == data.ColumnNames()[ 2 ] and
+            moved.length == (int64_t) data.NRows();
+    for ( size_t row = 0; equal and row < data.NRows(); row++ ) {
+        equal = column[ row ] == data( row, 2 );
+    }
+    movedSchema.release( &movedSchema );
+    moved.release( &moved );
+
+    if ( not equal or movedSchema.release or moved.release ) {
+        failed++;
+        std::cout << RED_TEXT << "ExportArrow(): moved child differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Export of a column-major DataFrame: its columns are the
+    // children buffers, held after the DataFrame is written
+    //---------------------------------------------------------
+    {
+        DataFrame< double > columnMajor =
+            data.ToLayout( DataFrameLayout::ColumnMajor );
+        const double *values = columnMajor.Data();
+
+        DataFrameCopies().bytesCopied = 0;
+        ExportArrow( columnMajor, &schema, &array );
+
+        equal = DataFrameCopies().bytesCopied == 0;
+        for ( size_t col = 0; col < data.NColumns(); col++ ) {
+            equal = equal and array.children[ col ]->buffers[ 1 ] ==
+                              values + col * columnMajor.Stride();
+        }
+
+        columnMajor( 0, 1 ) = -1.;
+        column = static_cast< const double * >(
+            array.children[ 1 ]->buffers[ 1 ] );
+        equal = equal and column == values + columnMajor.Stride() and
+                column[ 0 ] == data( 0, 1 );
+    }
+    for ( size_t row = 0; equal and row < data.NRows(); row++ ) {
+        equal = column[ row ] == data( row, 1 );
+    }
+    schema.release( &schema );
+    array.release ( &array );
+
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "ExportArrow(): column-major values copied"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Separate float64 column buffers: copied to column-major
+    //---------------------------------------------------------
+    double a[] = { 1., 2., 3. };
+    double b[] = { 10., 20., 30., 40. };
+    {
+        HostStruct separate( a, 0, b, 1, 3, 0, 3, nullptr, 0 );
+        DataFrame< double > copied = ImportArrow( &separate.schema,
+                                                  &separate.array );
+
+        equal = copied.Layout() == DataFrameLayout::ColumnMajor and
+                copied( 2, 0 ) == 3. and copied( 0, 1 ) == 20. and
+                copied( 2, 1 ) == 40.;
+    }
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): separate columns differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // float64 columns one after the other are used in place, and
+    // the array is released when the values are copied
+    //---------------------------------------------------------
+    double block[] = { 9., 1., 2., 3., 10., 20., 30., 99. };
+
+    DataFrame< double > inPlaceExpected( 3, 2, "a b" );
+    for ( size_t row = 0; row < 3; row++ ) {
+        inPlaceExpected( row, 0 ) = block[ 1 + row ];
+        inPlaceExpected( row, 1 ) = block[ 4 + row ];
+    }
+
+    schemaReleased = 0;
+    arrayReleased  = 0;
+    {
+        HostStruct host( block, 0, block, 3, 3, 1, 4, nullptr, 0 );
+        DataFrame< double > inPlace = ImportArrow( &host.schema,
+                                                   &host.array );
+
+        equal = inPlace.Data() == block + 1 and schemaReleased == 1 and
+                arrayReleased == 0;
+
+        MakeTest( "Arrow import in place", inPlaceExpected, inPlace );
+
+        inPlace( 0, 0 ) = 5.;
+        equal = equal and block[ 1 ] == 1. and inPlace( 0, 0 ) == 5. and
+                arrayReleased == 1;
+    }
+    if ( not equal or arrayReleased != 1 ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): in place values differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Null rows of the struct are nan in every column
+    //---------------------------------------------------------
+    uint8_t structValid[] = { 0x0B }; // bit 2 clear: row 1 of offset 1
+    HostStruct nullRows( block, 0, block, 3, 3, 1, 4, structValid, 1 );
+    DataFrame< double > nulls = ImportArrow( &nullRows.schema,
+                                             &nullRows.array );
+
+    equal = nulls.NRows() == 3 and nulls( 0, 0 ) == 1. and
+            std::isnan( nulls( 1, 0 ) ) and std::isnan( nulls( 1, 1 ) ) and
+            nulls( 2, 1 ) == 30.;
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): struct null rows differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Children shorter than the struct offset + length: error,
+    // schema and array released
+    //---------------------------------------------------------
+    schemaReleased = 0;
+    arrayReleased  = 0;
+    HostStruct shortChild( block, 0, block, 3, 4, 1, 4, nullptr, 0 );
+    bool thrown = false;
+    try {
+        ImportArrow( &shortChild.schema, &shortChild.array );
+    }
+    catch ( const std::exception & ) {
+        thrown = true;
+    }
+    if ( not thrown or schemaReleased != 1 or arrayReleased != 1 or
+         shortChild.schema.release or shortChild.array.release ) {
+        failed++;
+        std::cout << RED_TEXT << "ImportArrow(): short child not an error"
+                  << RESET_TEXT << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+// SimplexBatch test
+
+#include "TestCommon.h"
+
+//----------------------------------------------------------------
+// Simplex() of each series, stacked as the SimplexBatch() output
+//----------------------------------------------------------------
+DataFrame< double > SimplexSeries( std::vector< DataFrame< double > > data,
+                                   std::string target, int predRows,
+                                   int E, int Tp, int tau ) {
+
+    std::vector< DataFrame< double > > outputs;
+    size_t N_rows = 0;
+
+    for ( size_t i = 0; i < data.size(); i++ ) {
+        // Rows of the embedding, the last predRows are predicted
+        int N_embed = data[ i ].NRows() - tau * ( E - 1 );
+
+        std::stringstream lib, pred;
+        lib  << "1 " << N_embed - predRows;
+        pred << N_embed - predRows + 1 << " " << N_embed;
+
+        outputs.push_back( Simplex( data[ i ], "./", "",
+                                    lib.str(), pred.str(),
+                                    E, Tp, 0, tau, target, target,
+                                    false, false ) );
+        N_rows += outputs.back().NRows();
+    }
+
+    DataFrame< double > stacked( N_rows, 4 );
+    size_t row = 0;
+    for ( size_t i = 0; i < outputs.size(); i++ ) {
+        for ( size_t j = 0; j < outputs[ i ].NRows(); j++ ) {
+            std::valarray< double > outRow( 4 );
+            outRow[ 0 ] = i;
+            outRow[ std::slice( 1, 3, 1 ) ] = outputs[ i ].Row( j );
+            stacked.WriteRow( row++, outRow );
+        }
+    }
+    return stacked;
+}
+
+int main () {
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // Wide DataFrame: one series per column
+    //---------------------------------------------------------
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    DataFrame < double > batch = SimplexBatch( lorenz, "./", "", "",
+                                               100, 3, 2, 0, 2 );
+
+    // Each column as its own DataFrame for Simplex()
+    std::vector< DataFrame< double > > columns;
+    for ( size_t col = 1; col < lorenz.NColumns(); col++ ) {
+        DataFrame< double > column( lorenz.NRows(), 2, "Time x" );
+        column.WriteColumn( 0, lorenz.Column( 0 ) );
+        column.WriteColumn( 1, lorenz.Column( col ) );
+        columns.push_back( column );
+    }
+
+    DataFrame < double > series_S = SimplexSeries( columns, "x",
+                                                   100, 3, 2, 2 );
+
+    MakeTest ( "SimplexBatch Lorenz columns", series_S, batch );
+
+    if ( MaxDifference( series_S, batch ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "SimplexBatch Lorenz columns differs by "
+                  << MaxDifference( series_S, batch ) << RESET_TEXT
+                  << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Collection of series of different lengths
+    //---------------------------------------------------------
+    DataFrame < double > tent( "../data/", "TentMap_rEDM.csv" );
+    std::valarray< double > tentMap = tent.VectorColumnName( "TentMap" );
+
+    std::vector< std::valarray< double > > series;
+    std::vector< DataFrame< double > >     frames;
+
+    for ( size_t start = 0; start < 800; start += 100 ) {
+        size_t length = 150 + start / 2;
+        series.push_back( tentMap[ std::slice( start, length, 1 ) ] );
+
+        DataFrame< double > frame( length, 2, "Time x" );
+        for ( size_t row = 0; row < length; row++ ) {
+            frame( row, 0 ) = row + 1;
+            frame( row, 1 ) = series.back()[ row ];
+        }
+        frames.push_back( frame );
+    }
+
+    batch = SimplexBatch( series, "./", "", 20, 2, 1, 0, 1 );
+
+    series_S = SimplexSeries( frames, "x", 20, 2, 1, 1 );
+
+    MakeTest ( "SimplexBatch TentMap series", series_S, batch );
+
+    if ( MaxDifference( series_S, batch ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "SimplexBatch TentMap series differs by "
+                  << MaxDifference( series_S, batch ) << RESET_TEXT
+                  << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+// Binary DataFrame file test
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "TestCommon.h"
+
+int main () {
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // CSV -> binary -> DataFrame round trip
+    //---------------------------------------------------------
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    lorenz.WriteBinary( "./", "LorenzData1000.bin" );
+
+    DataFrame < double > lorenzBin( "./", "LorenzData1000.bin" );
+
+    if ( not lorenzBin.Mapped() ) {
+        failed++;
+        std::cout << RED_TEXT << "Binary DataFrame was copied, not mapped"
+                  << RESET_TEXT << std::endl;
+    }
+
+    MakeTest ( "LorenzData1000 binary round trip", lorenz, lorenzBin );
+
+    //---------------------------------------------------------
+    // n_rows x n_columns x 8 bytes that overflows: an error
+    //---------------------------------------------------------
+    std::ifstream binStream( "LorenzData1000.bin", std::ios::binary );
+    std::string   bytes( ( std::istreambuf_iterator< char >( binStream ) ),
+                         std::istreambuf_iterator< char >() );
+
+    // n_rows 2^61: n_rows x 6 x 8 is 0 in 64 bits
+    uint64_t n_rows = (uint64_t) 1 << 61;
+    memcpy( &bytes[ 24 ], &n_rows, sizeof( n_rows ) );
+
+    std::ofstream overflowStream( "Overflow.bin", std::ios::binary );
+    overflowStream.write( bytes.data(), bytes.size() );
+    overflowStream.close();
+
+    bool thrown = false;
+    try { DataFrame < double > overflow( "./", "Overflow.bin" ); }
+    catch ( const std::exception & ) { thrown = true; }
+
+    if ( not thrown ) {
+        failed++;
+        std::cout << RED_TEXT << "Binary DataFrame of overflowing size "
+                  << "not thrown" << RESET_TEXT << std::endl;
+    }
+    std::remove( "Overflow.bin" );
+
+    //---------------------------------------------------------
+    // Simplex from the binary file
+    //---------------------------------------------------------
+    DataFrame < double > S = Simplex( "../data/", "LorenzData1000.csv",
+                                      "./", "", "1 500", "501 900",
+                                      3, 1, 0, 2, "V1 V3", "V1",
+                                      false, false );
+
+    DataFrame < double > S_bin = Simplex( "./", "LorenzData1000.bin",
+                                          "./", "", "1 500", "501 900",
+                                          3, 1, 0, 2, "V1 V3", "V1",
+                                          false, false );
+
+    MakeTest ( "Simplex LorenzData1000 binary", S, S_bin );
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+// Embedding cache test: cached neighbors and CCM distances
+
+#include "TestCommon.h"
+
+int main () {
+
+    DataFrame < double > lorenz ( "../data/", "LorenzData1000.csv" );
+    DataFrame < double > sardine( "../data/", "sardine_anchovy_sst.csv" );
+
+    EmbeddingCache &cache = SharedEmbeddingCache();
+    int             failed = 0;
+
+    //---------------------------------------------------------
+    // Disabled by default: nothing cached
+    //---------------------------------------------------------
+    DataFrame < double > S_ref = Simplex( lorenz, "./", "", "1 500",
+                                          "501 995", 3, 1, 0, 1,
+                                          "V1", "V3", false, false );
+    if ( cache.Enabled() or cache.Entries() or cache.Misses() ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingCache not disabled"
+                  << RESET_TEXT << std::endl;
+    }
+
+    ConfigureEmbeddingCache( 64 << 20 );
+
+    //---------------------------------------------------------
+    // Simplex: a miss, then a hit with the same result
+    //---------------------------------------------------------
+    DataFrame < double > S_miss = Simplex( lorenz, "./", "", "1 500",
+                                           "501 995", 3, 1, 0, 1,
+                                           "V1", "V3", false, false );
+    DataFrame < double > S_hit  = Simplex( lorenz, "./", "", "1 500",
+                                           "501 995", 3, 1, 0, 1,
+                                           "V1", "V3", false, false );
+
+    MakeTest( "Simplex EmbeddingCache miss", S_ref, S_miss );
+    MakeTest( "Simplex EmbeddingCache hit",  S_ref, S_hit  );
+
+    // SMap with the neighbors of Simplex: knn E + 1
+    SMapValues SM_ref = SMap( lorenz, "./", "", "1 500", "501 995",
+                              3, 1, 4, 1, 2., "V1", "V3", "", "",
+                              false, false );
+
+    // Different E, lib: misses
+    Simplex( lorenz, "./", "", "1 500", "501 995", 4, 1, 0, 1,
+             "V1", "V3", false, false );
+    Simplex( lorenz, "./", "", "1 400", "501 995", 3, 1, 0, 1,
+             "V1", "V3", false, false );
+
+    if ( cache.Hits() != 2 or cache.Misses() != 3 or cache.Entries() != 3 ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingCache Simplex hits "
+                  << cache.Hits() << " misses " << cache.Misses()
+                  << " differ" << RESET_TEXT << std::endl;
+    }
+
+    // Changed data values: a miss, not the cached neighbors
+    DataFrame < double > lorenz2 = lorenz;
+    lorenz2( 600, 1 ) = lorenz2( 600, 1 ) + 1;
+    Simplex( lorenz2, "./", "", "1 500", "501 995", 3, 1, 0, 1,
+             "V1", "V3", false, false );
+
+    if ( cache.Hits() != 2 or cache.Misses() != 4 ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingCache of changed data differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    // Signs of two values flipped: hashes differ, a miss
+    DataFrame < double > flip1( 1, 4 );
+    DataFrame < double > flip2( 1, 4 );
+    double values1[] = {  0.5, 1.25, -3.0, 7.0 };
+    double values2[] = { -0.5, 1.25,  3.0, 7.0 };
+    for ( size_t col = 0; col < 4; col++ ) {
+        flip1( 0, col ) = values1[ col ];
+        flip2( 0, col ) = values2[ col ];
+    }
+    if ( HashValues( flip1.View() ) == HashValues( flip2.View() ) ) {
+        failed++;
+        std::cout << RED_TEXT << "HashValues of sign flipped values equal"
+                  << RESET_TEXT << std::endl;
+    }
+
+    DataFrame < double > lorenz3 = lorenz;
+    lorenz3( 600, 1 ) = -lorenz3( 600, 1 );
+    lorenz3( 700, 1 ) = -lorenz3( 700, 1 );
+    Simplex( lorenz3, "./", "", "1 500", "501 995", 3, 1, 0, 1,
+             "V1", "V3", false, false );
+
+    if ( cache.Hits() != 2 or cache.Misses() != 5 ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingCache of sign flipped data "
+                  << "differs" << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // CCM: distances of both columns reused
+    //---------------------------------------------------------
+    ConfigureEmbeddingCache( 0 );
+    DataFrame < double > CCM_ref = CCM( sardine, "./", "", 3, 0, 0, 1,
+                                        "anchovy", "np_sst", "10 70 10",
+                                        0, false, 0, false );
+    ConfigureEmbeddingCache( 64 << 20 );
+
+    size_t hits = cache.Hits();
+    CCM( sardine, "./", "", 3, 0, 0, 1, "anchovy", "np_sst", "10 70 10",
+         0, false, 0, false );
+    DataFrame < double > CCM_hit = CCM( sardine, "./", "", 3, 0, 0, 1,
+                                        "anchovy", "np_sst", "10 70 10",
+                                        0, false, 0, false );
+
+    MakeTest( "CCM EmbeddingCache hit", CCM_ref, CCM_hit );
+
+    if ( cache.Hits() != hits + 2 ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingCache CCM hits differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Least recent entries evicted over the size bound
+    //---------------------------------------------------------
+    ConfigureEmbeddingCache( 0 );
+    ConfigureEmbeddingCache( 40000 ); // two Simplex neighbors
+
+    size_t evictions = cache.Evictions();
+    for ( int E = 2; E < 6; E++ ) {
+        Simplex( lorenz, "./", "", "1 500", "501 995", E, 1, 0, 1,
+                 "V1", "V3", false, false );
+    }
+    if ( cache.Bytes() > 40000 or cache.Evictions() == evictions ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingCache eviction differs "
+                  << cache.Bytes() << " bytes" << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Concurrent engines share the cache
+    //---------------------------------------------------------
+    ConfigureEmbeddingCache( 64 << 20 );
+
+    ThreadPool pool( 4 );
+    std::vector< DataFrame< double > > S( 8 );
+    pool.ParallelFor( S.size(), [&]( size_t i ) {
+        S[ i ] = Simplex( lorenz, "./", "", "1 500", "501 995",
+                          3, 1, 0, 1, "V1", "V3", false, false );
+    } );
+
+    bool equal = true;
+    for ( size_t i = 0; i < S.size(); i++ ) {
+        equal = equal and S[ i ].NRows() == S_ref.NRows();
+        for ( size_t row = 0; equal and row < S_ref.NRows(); row++ ) {
+            equal = equal and ( S[ i ]( row, 2 ) == S_ref( row, 2 ) or
+                                std::isnan( S_ref( row, 2 ) ) );
+        }
+    }
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingCache concurrent Simplex differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    ConfigureEmbeddingCache( 0 );
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+// DataFrame copy-on-write test
+
+#include "TestCommon.h"
+#include "Embed.h"
+
+int main () {
+
+    int failed = 0;
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    //---------------------------------------------------------
+    // A copy shares values until one of the DataFrames is written
+    //---------------------------------------------------------
+    DataFrame < double > copy( lorenz );
+
+    if ( copy.Data() != lorenz.Data() ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame copy does not share values"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Reads of a mutable DataFrame do not copy shared values
+    //---------------------------------------------------------
+    DataFrameCopies().bytesCopied = 0;
+
+    double value = lorenz( 10, 2 );
+    double sum   = 0;
+    for ( size_t row = 0; row < copy.NRows(); row++ ) {
+        sum += copy( row, 2 );
+    }
+
+    if ( copy.Data() != lorenz.Data() or sum == 0 or
+         DataFrameCopies().bytesCopied ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame read copies shared values"
+                  << RESET_TEXT << std::endl;
+    }
+
+    copy( 10, 2 ) = value + 1;
+    copy.ColumnNames()[ 0 ] = "t";
+
+    if ( copy.Data() == lorenz.Data() or lorenz( 10, 2 ) != value or
+         copy( 10, 2 ) != value + 1 or lorenz.ColumnNames()[ 0 ] != "Time" ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame copy on write differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    copy( 10, 2 ) = value;
+    copy.ColumnNames()[ 0 ] = "Time";
+    MakeTest( "DataFrame copy on write", lorenz, copy );
+
+    //---------------------------------------------------------
+    // Bytes of values shared and copied per Simplex() call
+    //---------------------------------------------------------
+    const size_t N = 10;
+    DataFrameCopies().bytesShared = 0;
+    DataFrameCopies().bytesCopied = 0;
+
+    for ( size_t i = 0; i < N; i++ ) {
+        DataFrame < double > S = Simplex( lorenz, "./", "", "1 500",
+                                          "501 995", 3, 1, 0, 1,
+                                          "V1", "V3", false, false );
+    }
+
+    size_t shared = DataFrameCopies().bytesShared / N;
+    size_t copied = DataFrameCopies().bytesCopied / N;
+
+    std::cout << "Simplex(): bytes shared " << shared << " copied "
+              << copied << " per call" << std::endl;
+
+    if ( copied > lorenz.size() * sizeof( double ) ) {
+        failed++;
+        std::cout << RED_TEXT << "Simplex() copies more than its data"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Embedded Simplex(): the data block is copied once, its
+    // aligned rows are searched in place
+    //---------------------------------------------------------
+    DataFrame < double > block = Embed( lorenz, 3, 1, "V1" );
+    DataFrame < double > embedded( lorenz.NRows() - 2, 4,
+                                   "Time V1(t-0) V1(t-1) V1(t-2)" );
+    for ( size_t row = 0; row < block.NRows(); row++ ) {
+        embedded( row, 0 ) = lorenz( row + 2, 0 );
+        for ( size_t col = 0; col < 3; col++ ) {
+            embedded( row, col + 1 ) = block( row, col );
+        }
+    }
+
+    DataFrameCopies().bytesCopied = 0;
+    Simplex( embedded, "./", "", "1 500", "501 995", 3, 1, 0, 1,
+             "V1(t-0) V1(t-1) V1(t-2)", "V1(t-0)", true, false );
+
+    size_t blockBytes = block.size() * sizeof( double );
+    std::cout << "Simplex() embedded: bytes copied "
+              << DataFrameCopies().bytesCopied << " block "
+              << blockBytes << std::endl;
+
+    if ( not block.Aligned() or
+         DataFrameCopies().bytesCopied > blockBytes ) {
+        failed++;
+        std::cout << RED_TEXT << "Simplex() embedded block copied twice"
+                  << RESET_TEXT << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
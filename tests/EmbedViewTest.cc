@@ -0,0 +1,122 @@
+// EmbeddingView test: embedding that is not materialized
+
+#include "TestCommon.h"
+#include "Neighbors.h"
+
+int main () {
+
+    int failed = 0;
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    //---------------------------------------------------------
+    // Elements, rows and MakeBlock() of the view: as Embed()
+    //---------------------------------------------------------
+    DataFrame     < double > embed     = Embed    ( lorenz, 3, 2, "V1 V3" );
+    EmbeddingView < double > embedView = EmbedView( lorenz, 3, 2, "V1 V3" );
+
+    MakeTest( "MakeBlock of EmbeddingView", embed, MakeBlock( embedView ) );
+
+    std::vector< double > row( embedView.NColumns() );
+    bool equal = embedView.NRows()    == embed.NRows() and
+                 embedView.NColumns() == embed.NColumns();
+    for ( size_t i = 0; equal and i < embed.NRows(); i++ ) {
+        embedView.Row( i, row.data() );
+        for ( size_t j = 0; j < embed.NColumns(); j++ ) {
+            equal = equal and embedView( i, j ) == embed( i, j ) and
+                              row[ j ] == embed( i, j );
+        }
+    }
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingView elements differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // MakeBlock() of wide data on a pool: each value from its lag
+    //---------------------------------------------------------
+    DataFrame < double > block3sp( "../data/", "block_3sp.csv" );
+    DataFrameView< double > columns3sp = block3sp.View().Columns(
+        { "x_t", "x_t-1", "x_t-2", "y_t", "y_t-1", "y_t-2",
+          "z_t", "z_t-1", "z_t-2" } );
+
+    ThreadPool pool( 4 );
+    DataFrame < double > wide = MakeBlock( columns3sp, 4, 3,
+                                           columns3sp.ColumnNames(), false,
+                                           ExecutionContext( &pool ) );
+
+    equal = wide.NRows()    == block3sp.NRows() - 9 and
+            wide.NColumns() == 36;
+    for ( size_t i = 0; equal and i < wide.NRows(); i++ ) {
+        for ( size_t j = 0; j < wide.NColumns(); j++ ) {
+            equal = equal and wide( i, j ) ==
+                columns3sp( i + 9 - ( j % 4 ) * 3, j / 4 );
+        }
+    }
+    if ( not equal or wide.ColumnNames()[ 5 ] != "x_t-1(t-1)" ) {
+        failed++;
+        std::cout << RED_TEXT << "MakeBlock of wide data differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Neighbors of the view: as those of the Embed() DataFrame
+    //---------------------------------------------------------
+    Parameters param = Parameters( Method::Simplex, "", "", "", "",
+                                   "1 600", "601 990", 3, 1, 0, 2, 0,
+                                   "V1 V3", "V3", false, false );
+
+    Neighbors N_block = FindNeighbors( embed,     param );
+    Neighbors N_view  = FindNeighbors( embedView, param );
+
+    MakeTest( "EmbeddingView neighbor distances",
+              N_block.distances, N_view.distances );
+
+    equal = true;
+    for ( size_t i = 0; i < N_block.neighbors.NRows(); i++ ) {
+        for ( size_t j = 0; j < N_block.neighbors.NColumns(); j++ ) {
+            equal = equal and
+                N_block.neighbors( i, j ) == N_view.neighbors( i, j );
+        }
+    }
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "EmbeddingView neighbors differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // SMap of the view, as of the embedded block
+    //---------------------------------------------------------
+    std::vector< std::string > names( 1, "Time" );
+    names.insert( names.end(), embed.ColumnNames().begin(),
+                  embed.ColumnNames().end() );
+    DataFrame < double > block( embed.NRows(), embed.NColumns() + 1, names );
+    for ( size_t i = 0; i < embed.NRows(); i++ ) {
+        block( i, 0 ) = lorenz( i + 4, 0 );
+        for ( size_t j = 0; j < embed.NColumns(); j++ ) {
+            block( i, j + 1 ) = embed( i, j );
+        }
+    }
+
+    SMapValues SM_view  = SMap( lorenz, "./", "", "5 600", "601 990",
+                                3, 1, 100, 2, 3., "V1", "V3", "", "",
+                                false, false );
+    SMapValues SM_block = SMap( block, "./", "", "5 600", "601 990",
+                                3, 1, 100, 2, 3., "V1(t-0) V1(t-1) V1(t-2)",
+                                "V3(t-0)", "", "", true, false );
+
+    MakeTest( "SMap of EmbeddingView", SM_block.predictions,
+              SM_view.predictions );
+
+    // Coefficients of the aligned block: as of the view, that reads
+    // column E as column 0 of the next row
+    if ( MaxDifference( SM_block.coefficients, SM_view.coefficients ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "SMap coefficients of EmbeddingView differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
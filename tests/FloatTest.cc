@@ -0,0 +1,121 @@
+// float32 pipeline test: deviation of float32 from double results
+
+#include "TestCommon.h"
+#include "Embed.h"
+
+//----------------------------------------------------------------
+// Largest absolute difference of the non-nan values of a column
+//----------------------------------------------------------------
+double MaxDeviation( const DataFrame< double > &D1,
+                     const DataFrame< double > &D2, size_t col ) {
+    double deviation = 0;
+    for ( size_t row = 0; row < D1.NRows(); row++ ) {
+        double d = std::abs( D1( row, col ) - D2( row, col ) );
+        if ( not std::isnan( d ) ) {
+            deviation = std::max( deviation, d );
+        }
+    }
+    return deviation;
+}
+
+//----------------------------------------------------------------
+// Report the deviation of the float32 predictions and rho
+// @return: 1 if rho deviates more than maxRho, else 0
+//----------------------------------------------------------------
+int Deviation( std::string name, const DataFrame< double > &S_double,
+                const DataFrame< double > &S_float, double maxRho ) {
+
+    VectorError ve_double = ComputeError(
+        S_double.VectorColumnName( "Observations" ),
+        S_double.VectorColumnName( "Predictions"  ) );
+    VectorError ve_float = ComputeError(
+        S_float.VectorColumnName( "Observations" ),
+        S_float.VectorColumnName( "Predictions"  ) );
+
+    double rho = std::abs( ve_double.rho - ve_float.rho );
+
+    std::cout << name << ": float32 prediction deviation "
+              << MaxDeviation( S_double, S_float, 2 ) << " rho deviation "
+              << rho << std::endl;
+
+    if ( S_double.NRows() != S_float.NRows() or not ( rho <= maxRho ) ) {
+        std::cout << RED_TEXT << name << " float32 rho differs"
+                  << RESET_TEXT << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main () {
+
+    int failed = 0;
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+    DataFrame < float  > lorenzFloat( lorenz );
+
+    DataFrame < double > block( "../data/", "block_3sp.csv" );
+    DataFrame < float  > blockFloat( block );
+
+    DataFrame < double > sardine( "../data/", "sardine_anchovy_sst.csv" );
+    DataFrame < float  > sardineFloat( sardine );
+
+    //---------------------------------------------------------
+    // Embed: float32 of the double embedding
+    //---------------------------------------------------------
+    DataFrame < double > E_double = Embed( lorenz,      3, 2, "V1 V3" );
+    DataFrame < double > E_float( Embed( lorenzFloat, 3, 2, "V1 V3" ) );
+
+    MakeTest( "Embed float32", E_double, E_float );
+
+    //---------------------------------------------------------
+    // Simplex
+    //---------------------------------------------------------
+    failed += Deviation( "Simplex Lorenz",
+        Simplex( lorenz, "./", "", "1 500", "501 995",
+                 3, 1, 0, 1, "V1", "V3", false, false ),
+        Simplex( lorenzFloat, "./", "", "1 500", "501 995",
+                 3, 1, 0, 1, "V1", "V3", false, false ), 1E-3 );
+
+    failed += Deviation( "Simplex block_3sp embedded",
+        Simplex( block, "./", "", "1 99", "100 195", 3, 1, 0, 1,
+                 "x_t y_t z_t", "x_t", true, false ),
+        Simplex( blockFloat, "./", "", "1 99", "100 195", 3, 1, 0, 1,
+                 "x_t y_t z_t", "x_t", true, false ), 1E-3 );
+
+    //---------------------------------------------------------
+    // SMap
+    //---------------------------------------------------------
+    SMapValues SM_double = SMap( lorenz, "./", "", "1 500", "501 995",
+                                 3, 1, 0, 1, 3., "V1", "V3", "", "",
+                                 false, false );
+    SMapValues SM_float  = SMap( lorenzFloat, "./", "", "1 500", "501 995",
+                                 3, 1, 0, 1, 3., "V1", "V3", "", "",
+                                 false, false );
+
+    failed += Deviation( "SMap Lorenz", SM_double.predictions,
+                         SM_float.predictions, 1E-3 );
+
+    //---------------------------------------------------------
+    // CCM
+    //---------------------------------------------------------
+    DataFrame < double > CCM_double = CCM( sardine, "./", "", 3, 0, 0, 1,
+                                           "anchovy", "np_sst",
+                                           "10 70 10", 0, false, 0, false );
+    DataFrame < double > CCM_float  = CCM( sardineFloat, "./", "", 3, 0, 0,
+                                           1, "anchovy", "np_sst",
+                                           "10 70 10", 0, false, 0, false );
+
+    double rho = std::max( MaxDeviation( CCM_double, CCM_float, 1 ),
+                           MaxDeviation( CCM_double, CCM_float, 2 ) );
+
+    std::cout << "CCM sardine_anchovy_sst: float32 rho deviation "
+              << rho << std::endl;
+
+    if ( not ( rho <= 1E-3 ) ) {
+        failed++;
+        std::cout << RED_TEXT << "CCM float32 rho differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+// DataFrame row-major, column-major layout test
+
+#include "TestCommon.h"
+#include "Embed.h"
+
+int main () {
+
+    int failed = 0;
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    //---------------------------------------------------------
+    // Column-major values: element access as row-major
+    //---------------------------------------------------------
+    DataFrame < double > columnMajor =
+        lorenz.ToLayout( DataFrameLayout::ColumnMajor );
+
+    if ( columnMajor.Layout() != DataFrameLayout::ColumnMajor or
+         columnMajor.Data()[ 1 ] != lorenz( 1, 0 ) or
+         columnMajor.Data()[ lorenz.NRows() ] != lorenz( 0, 1 ) ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame column-major values differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    MakeTest( "DataFrame column-major", lorenz, columnMajor );
+
+    DataFrame < double > rowMajor =
+        columnMajor.ToLayout( DataFrameLayout::RowMajor );
+
+    if ( rowMajor.Layout() != DataFrameLayout::RowMajor or
+         std::abs( rowMajor.Data()[ 1 ] - lorenz.Data()[ 1 ] ) > 0 or
+         rowMajor.ColumnNames() != lorenz.ColumnNames() ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame row-major values differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Row, column, views and writes of a column-major DataFrame
+    //---------------------------------------------------------
+    std::valarray< double > row    = columnMajor.Row( 20 );
+    std::valarray< double > column = columnMajor.VectorColumnName( "V2" );
+    std::valarray< double > viewColumn = columnMajor.View().Rows( 20, 10 ).
+        Columns( std::vector< std::string >( 1, "V2" ) ).Column( 0 );
+
+    if ( row[ 2 ] != lorenz( 20, 2 ) or column[ 20 ] != lorenz( 20, 2 ) or
+         viewColumn[ 0 ] != lorenz( 20, 2 ) ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame column-major row, column differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    columnMajor.WriteNpy( "./", "layout.npy" );
+    DataFrame < double > npy( "./", "layout.npy" );
+    npy.ColumnNames() = lorenz.ColumnNames();
+
+    MakeTest( "DataFrame column-major WriteNpy", lorenz, npy );
+
+    //---------------------------------------------------------
+    // Aligned DataFrame: rows padded with zeros
+    //---------------------------------------------------------
+    DataFrame < double > aligned =
+        lorenz.ToLayout( DataFrameLayout::RowMajor, true );
+
+    const double *values = aligned.Data();
+    bool zeroPadding = true;
+    for ( size_t row = 0; row < aligned.NRows(); row++ ) {
+        for ( size_t i = aligned.NColumns(); i < aligned.Stride(); i++ ) {
+            zeroPadding = zeroPadding and
+                          values[ row * aligned.Stride() + i ] == 0;
+        }
+    }
+    if ( not aligned.Aligned() or aligned.Stride() != 8 or not zeroPadding or
+         reinterpret_cast< uintptr_t >( values ) % DataFrameAlignment ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame aligned rows differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    MakeTest( "DataFrame aligned", lorenz, aligned );
+
+    DataFrame < double > alignedCopy( aligned );
+    alignedCopy( 3, 4 ) = 0;
+    if ( alignedCopy.Data() == aligned.Data() or
+         reinterpret_cast< uintptr_t >( alignedCopy.Data() ) %
+         DataFrameAlignment or alignedCopy( 3, 5 ) != lorenz( 3, 5 ) or
+         aligned( 3, 4 ) != lorenz( 3, 4 ) ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame aligned copy on write differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    std::valarray< double > elements = aligned.Elements();
+    if ( elements.size() != lorenz.size() or
+         elements[ lorenz.NColumns() ] != lorenz( 1, 0 ) ) {
+        failed++;
+        std::cout << RED_TEXT << "DataFrame aligned elements differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Simplex and Embed of a column-major DataFrame
+    //---------------------------------------------------------
+    DataFrame < double > S_row = Simplex( lorenz, "./", "", "1 500",
+                                          "501 995", 3, 1, 0, 1,
+                                          "V1", "V3", false, false );
+
+    DataFrame < double > S_col = Simplex( columnMajor, "./", "", "1 500",
+                                          "501 995", 3, 1, 0, 1,
+                                          "V1", "V3", false, false );
+
+    MakeTest( "Simplex of column-major DataFrame", S_row, S_col );
+
+    DataFrame < double > E_row = Embed( lorenz,      3, 2, "V1 V3" );
+    DataFrame < double > E_col = Embed( columnMajor, 3, 2, "V1 V3" );
+
+    MakeTest( "Embed of column-major DataFrame", E_row, E_col );
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,263 @@
+// StreamLibrary test: appended observations, windows, kd tree knn
+
+#include "TestCommon.h"
+#include "Library.h"
+
+// Neighbors as distance, row pairs
+typedef std::vector< std::pair< double, size_t > > NeighborList;
+
+//----------------------------------------------------------------
+// Neighbors of row 0 sorted by distance, then row
+//----------------------------------------------------------------
+NeighborList Sorted( const Neighbors &nn, size_t shift ) {
+    NeighborList sorted;
+    for ( size_t k = 0; k < nn.neighbors.NColumns(); k++ ) {
+        sorted.push_back( std::make_pair( nn.distances( 0, k ),
+                                          nn.neighbors( 0, k ) + shift ) );
+    }
+    std::sort( sorted.begin(), sorted.end() );
+    return sorted;
+}
+
+//----------------------------------------------------------------
+// DataFrame of neighbors: rows of distance, row
+//----------------------------------------------------------------
+DataFrame< double > NeighborFrame( const NeighborList &neighbors ) {
+    DataFrame< double > frame( neighbors.size(), 2, "distance row" );
+    for ( size_t k = 0; k < neighbors.size(); k++ ) {
+        frame( k, 0 ) = neighbors[ k ].first;
+        frame( k, 1 ) = neighbors[ k ].second;
+    }
+    return frame;
+}
+
+int main () {
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // Neighbors of the newest state: as FindNeighbors() of the
+    // Embed() rows observed so far
+    //---------------------------------------------------------
+    int    E     = 3;
+    int    tau   = 2;
+    size_t shift = ( E - 1 ) * tau;
+    size_t knn   = 7;
+
+    DataFrame < double > embed = Embed( lorenz, E, tau, "V1 V3" );
+
+    std::string embedColumns;
+    for ( size_t col = 0; col < embed.NColumns(); col++ ) {
+        embedColumns += embed.ColumnNames()[ col ] + " ";
+    }
+
+    StreamLibrary library( E, 1, tau, 2 );
+
+    NeighborList blockAll;
+    NeighborList streamAll;
+
+    bool equal = true;
+    for ( size_t t = 0; t < lorenz.NRows(); t++ ) {
+        library.Append( { lorenz( t, 1 ), lorenz( t, 3 ) } );
+
+        if ( t != 100 and t != 500 and t != lorenz.NRows() - 1 ) {
+            continue;
+        }
+
+        std::string lib  = "1 " + std::to_string( t - shift + 1 );
+        std::string pred = std::to_string( t - shift + 1 ) + " " +
+                           std::to_string( t - shift + 1 );
+
+        Parameters param = Parameters( Method::Simplex, "", "", "", "",
+                                       lib, pred, embed.NColumns(), 1,
+                                       knn, 1, 0, embedColumns, "",
+                                       true, false );
+
+        NeighborList block  = Sorted( FindNeighbors( embed, param ), shift );
+        NeighborList stream = Sorted( library.Nearest( knn ), 0 );
+
+        equal = equal and library.LibrarySize() == t - shift;
+        for ( size_t k = 0; k < knn; k++ ) {
+            equal = equal and block[ k ].second == stream[ k ].second and
+                    std::abs( block[ k ].first - stream[ k ].first ) < 1E-12;
+        }
+        blockAll.insert ( blockAll.end(),  block.begin(),  block.end()  );
+        streamAll.insert( streamAll.end(), stream.begin(), stream.end() );
+    }
+    MakeTest( "StreamLibrary neighbors", NeighborFrame( blockAll ),
+              NeighborFrame( streamAll ) );
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "StreamLibrary neighbors differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // KDTree: as brute force, depth O(log N) of ordered inserts
+    //---------------------------------------------------------
+    KDTree tree( 2 );
+    std::vector< double > points;
+    for ( size_t i = 0; i < 5000; i++ ) {
+        double point[ 2 ] = { (double) ( i % 71 ), (double) i / 7 };
+        tree.Insert( i, point );
+        points.insert( points.end(), point, point + 2 );
+    }
+
+    equal = tree.Size() == 5000 and tree.Depth() <= 26;
+
+    NeighborList treeAll;
+    NeighborList bruteAll;
+
+    std::vector< size_t > ids( 10 );
+    std::vector< double > distances( 10 );
+    for ( size_t q = 0; q < 200; q++ ) {
+        double query[ 2 ] = { q * 0.37, q * 3.51 };
+        tree.Nearest( query, 10, ids.data(), distances.data() );
+
+        std::vector< std::pair< double, size_t > > brute;
+        for ( size_t i = 0; i < 5000; i++ ) {
+            double dx = points[ 2 * i ]     - query[ 0 ];
+            double dy = points[ 2 * i + 1 ] - query[ 1 ];
+            brute.push_back( std::make_pair( dx * dx + dy * dy, i ) );
+        }
+        std::partial_sort( brute.begin(), brute.begin() + 10, brute.end() );
+
+        for ( size_t k = 0; k < 10; k++ ) {
+            equal = equal and ids[ k ] == brute[ k ].second and
+                    distances[ k ] == sqrt( brute[ k ].first );
+            treeAll.push_back ( std::make_pair( distances[ k ], ids[ k ] ) );
+            bruteAll.push_back( std::make_pair( sqrt( brute[ k ].first ),
+                                                brute[ k ].second ) );
+        }
+    }
+    MakeTest( "KDTree neighbors", NeighborFrame( bruteAll ),
+              NeighborFrame( treeAll ) );
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "KDTree neighbors differ, depth "
+                  << tree.Depth() << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // KDTree removal: as brute force of the points kept
+    //---------------------------------------------------------
+    bool removed = true;
+    for ( size_t i = 0; i < 5000; i++ ) {
+        if ( i % 5 ) {
+            removed = removed and tree.Remove( i, &points[ 2 * i ] );
+        }
+    }
+    removed = removed and not tree.Remove( 1, &points[ 2 ] );
+
+    equal = removed and tree.Size() == 1000 and tree.Depth() <= 22;
+
+    treeAll.clear();
+    bruteAll.clear();
+    for ( size_t q = 0; q < 200; q++ ) {
+        double query[ 2 ] = { q * 0.37, q * 3.51 };
+        tree.Nearest( query, 10, ids.data(), distances.data() );
+
+        std::vector< std::pair< double, size_t > > brute;
+        for ( size_t i = 0; i < 5000; i += 5 ) {
+            double dx = points[ 2 * i ]     - query[ 0 ];
+            double dy = points[ 2 * i + 1 ] - query[ 1 ];
+            brute.push_back( std::make_pair( dx * dx + dy * dy, i ) );
+        }
+        std::partial_sort( brute.begin(), brute.begin() + 10, brute.end() );
+
+        for ( size_t k = 0; k < 10; k++ ) {
+            equal = equal and ids[ k ] == brute[ k ].second and
+                    distances[ k ] == sqrt( brute[ k ].first );
+            treeAll.push_back ( std::make_pair( distances[ k ], ids[ k ] ) );
+            bruteAll.push_back( std::make_pair( sqrt( brute[ k ].first ),
+                                                brute[ k ].second ) );
+        }
+    }
+    MakeTest( "KDTree neighbors after removal", NeighborFrame( bruteAll ),
+              NeighborFrame( treeAll ) );
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "KDTree neighbors after removal differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Window of W observations: as FindNeighbors() of the Embed()
+    // rows of a DataFrame of the last W observations
+    //---------------------------------------------------------
+    size_t W = 200;
+    size_t M = W - shift; // embedded rows of the window
+
+    StreamLibrary windowed( E, 1, tau, 2, W );
+
+    NeighborList sliceAll;
+    streamAll.clear();
+
+    equal = true;
+    for ( size_t t = 0; t < lorenz.NRows(); t++ ) {
+        windowed.Append( { lorenz( t, 1 ), lorenz( t, 3 ) } );
+
+        if ( t != 300 and t != 650 and t != lorenz.NRows() - 1 ) {
+            continue;
+        }
+
+        // Embed() row i is observation row i + shift
+        DataFrame < double > block( M, embed.NColumns() );
+        for ( size_t row = 0; row < M; row++ ) {
+            for ( size_t col = 0; col < embed.NColumns(); col++ ) {
+                block( row, col ) = embed( t - W + 1 + row, col );
+            }
+        }
+
+        Parameters param = Parameters( Method::Simplex, "", "", "", "",
+                                       "1 " + std::to_string( M ),
+                                       std::to_string( M ) + " " +
+                                       std::to_string( M ),
+                                       embed.NColumns(), 1, knn, 1, 0,
+                                       embedColumns, "", true, false );
+
+        NeighborList slice  = Sorted( FindNeighbors( block, param ),
+                                      t - W + 1 + shift );
+        NeighborList stream = Sorted( windowed.Nearest( knn ), 0 );
+
+        equal = equal and windowed.LibrarySize() == M - 1 and
+                windowed.NRows() - windowed.FirstRow() < 2 * W;
+        for ( size_t k = 0; k < knn; k++ ) {
+            equal = equal and slice[ k ].second == stream[ k ].second and
+                    std::abs( slice[ k ].first - stream[ k ].first ) < 1E-12;
+        }
+        sliceAll.insert ( sliceAll.end(),  slice.begin(),  slice.end()  );
+        streamAll.insert( streamAll.end(), stream.begin(), stream.end() );
+    }
+    MakeTest( "StreamLibrary window neighbors", NeighborFrame( sliceAll ),
+              NeighborFrame( streamAll ) );
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "StreamLibrary window neighbors differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Library too small
+    //---------------------------------------------------------
+    StreamLibrary small( 2, 1, 1 );
+    for ( size_t t = 0; t < 5; t++ ) {
+        small.Append( lorenz( t, 1 ) );
+    }
+    bool thrown = false;
+    try {
+        small.Nearest( 4 );
+    }
+    catch ( const std::exception & ) {
+        thrown = true;
+    }
+    if ( not thrown or small.LibrarySize() != 3 ) {
+        failed++;
+        std::cout << RED_TEXT << "StreamLibrary of 3 rows resolved 4 knn"
+                  << RESET_TEXT << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
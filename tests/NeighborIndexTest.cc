@@ -0,0 +1,201 @@
+// Neighbor index file test: neighbors saved and mapped for reuse
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "TestCommon.h"
+#include "Neighbors.h"
+
+//----------------------------------------------------------------
+// Neighbor index files in path
+//----------------------------------------------------------------
+std::vector< std::string > IndexFiles( std::string path ) {
+    std::vector< std::string > files;
+    DIR *dir = opendir( path.c_str() );
+    for ( dirent *entry = readdir( dir ); entry; entry = readdir( dir ) ) {
+        std::string name( entry->d_name );
+        if ( name.size() > 6 and
+             name.compare( name.size() - 6, 6, ".edmnn" ) == 0 ) {
+            files.push_back( name );
+        }
+    }
+    closedir( dir );
+    return files;
+}
+
+//----------------------------------------------------------------
+// Bytes of a file, and the file of bytes
+//----------------------------------------------------------------
+std::string ReadBytes( std::string fileName ) {
+    std::ifstream stream( fileName, std::ios::binary );
+    return std::string( std::istreambuf_iterator< char >( stream ),
+                        std::istreambuf_iterator< char >() );
+}
+
+void WriteBytes( std::string fileName, const std::string &bytes ) {
+    std::ofstream stream( fileName, std::ios::binary );
+    stream.write( bytes.data(), bytes.size() );
+}
+
+ino_t Inode( std::string fileName ) {
+    struct stat fileStat;
+    stat( fileName.c_str(), &fileStat );
+    return fileStat.st_ino;
+}
+
+int main () {
+
+    int failed = 0;
+
+    std::vector< std::string > stale = IndexFiles( "./" );
+    for ( size_t i = 0; i < stale.size(); i++ ) {
+        std::remove( stale[ i ].c_str() );
+    }
+
+    DataFrame < double > lorenz ( "../data/", "LorenzData1000.csv" );
+
+    //---------------------------------------------------------
+    // Write, map and read back neighbors
+    //---------------------------------------------------------
+    Parameters param = Parameters( Method::Simplex, "", "", "", "",
+                                   "1 500", "501 990", 3, 1, 4, 1, 0,
+                                   "V1 V2 V3", "V1", true, false );
+    DataFrame < double > block = lorenz.DataFrameFromColumnNames(
+        std::vector< std::string >( { "V1", "V2", "V3" } ) );
+
+    Neighbors nn = FindNeighbors( block, param );
+
+    WriteNeighborIndex( "./", "NeighborIndexTest.edmnn", "Test key", nn );
+
+    Neighbors nnRead;
+    bool found = ReadNeighborIndex( "./", "NeighborIndexTest.edmnn",
+                                    "Test key", nnRead );
+
+    if ( not found or not nnRead.neighbors.Mapped() or
+         not nnRead.distances.Mapped() ) {
+        failed++;
+        std::cout << RED_TEXT << "ReadNeighborIndex() not mapped"
+                  << RESET_TEXT << std::endl;
+    }
+
+    bool equal = nnRead.neighbors.NRows()    == nn.neighbors.NRows() and
+                 nnRead.neighbors.NColumns() == nn.neighbors.NColumns();
+    for ( size_t row = 0; equal and row < nn.neighbors.NRows(); row++ ) {
+        for ( size_t k = 0; k < nn.neighbors.NColumns(); k++ ) {
+            equal = equal and
+                nnRead.neighbors( row, k ) == nn.neighbors( row, k ) and
+                nnRead.distances( row, k ) == nn.distances( row, k );
+        }
+    }
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "ReadNeighborIndex() neighbors differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    // Other key, no file: not found
+    Neighbors nnOther;
+    if ( ReadNeighborIndex( "./", "NeighborIndexTest.edmnn",
+                            "Other key", nnOther ) or
+         ReadNeighborIndex( "./", "NoNeighborIndex.edmnn",
+                            "Test key", nnOther ) ) {
+        failed++;
+        std::cout << RED_TEXT << "ReadNeighborIndex() of other key found"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Changed values, and n_rows x knn that overflows: errors
+    //---------------------------------------------------------
+    std::string bytes = ReadBytes( "NeighborIndexTest.edmnn" );
+
+    std::string changed = bytes;
+    changed[ changed.size() - 1 ] ^= 0x80; // sign of the last distance
+    WriteBytes( "NeighborIndexTest.edmnn", changed );
+
+    size_t thrown = 0;
+    try { ReadNeighborIndex( "./", "NeighborIndexTest.edmnn", "Test key",
+                             nnOther ); }
+    catch ( const std::exception & ) { thrown++; }
+
+    // n_rows 2^62 + 1, knn 4: n_rows x knn is 4 in 64 bits
+    std::string overflow = bytes;
+    uint64_t    n_rows   = ( (uint64_t) 1 << 62 ) + 1;
+    uint64_t    knn      = 4;
+    memcpy( &overflow[ 16 ], &n_rows, sizeof( n_rows ) );
+    memcpy( &overflow[ 24 ], &knn,    sizeof( knn ) );
+    WriteBytes( "NeighborIndexTest.edmnn", overflow );
+
+    try { ReadNeighborIndex( "./", "NeighborIndexTest.edmnn", "Test key",
+                             nnOther ); }
+    catch ( const std::exception & ) { thrown++; }
+
+    if ( thrown != 2 ) {
+        failed++;
+        std::cout << RED_TEXT << "ReadNeighborIndex() of a changed file "
+                  << "not thrown" << RESET_TEXT << std::endl;
+    }
+    std::remove( "NeighborIndexTest.edmnn" );
+
+    //---------------------------------------------------------
+    // Simplex: neighbors saved, then read, not searched
+    //---------------------------------------------------------
+    DataFrame < double > S_ref = Simplex( lorenz, "./", "", "1 500",
+                                          "501 995", 3, 1, 0, 1,
+                                          "V1", "V3", false, false );
+    ConfigureNeighborIndex( "./" );
+
+    DataFrame < double > S_save = Simplex( lorenz, "./", "", "1 500",
+                                           "501 995", 3, 1, 0, 1,
+                                           "V1", "V3", false, false );
+    std::vector< std::string > files = IndexFiles( "./" );
+    ino_t saved = files.size() == 1 ? Inode( files[ 0 ] ) : 0;
+
+    DataFrame < double > S_read = Simplex( lorenz, "./", "", "1 500",
+                                           "501 995", 3, 1, 0, 1,
+                                           "V1", "V3", false, false );
+
+    MakeTest( "Simplex neighbor index saved", S_ref, S_save );
+    MakeTest( "Simplex neighbor index read",  S_ref, S_read );
+
+    if ( files.size() != 1 or IndexFiles( "./" ).size() != 1 or
+         Inode( files[ 0 ] ) != saved ) {
+        failed++;
+        std::cout << RED_TEXT << "Simplex neighbor index not reused"
+                  << RESET_TEXT << std::endl;
+    }
+
+    // SMap of the Simplex neighbors: knn E + 1
+    SMapValues SM_ref = SMap( lorenz, "./", "", "1 500", "501 995",
+                              3, 1, 4, 1, 2., "V1", "V3", "", "",
+                              false, false );
+    ConfigureNeighborIndex( "" );
+    SMapValues SM_search = SMap( lorenz, "./", "", "1 500", "501 995",
+                                 3, 1, 4, 1, 2., "V1", "V3", "", "",
+                                 false, false );
+
+    MakeTest( "SMap neighbor index read", SM_search.predictions,
+              SM_ref.predictions );
+
+    //---------------------------------------------------------
+    // Changed data values: another index
+    //---------------------------------------------------------
+    ConfigureNeighborIndex( "./" );
+    DataFrame < double > lorenz2 = lorenz;
+    lorenz2( 600, 1 ) = lorenz2( 600, 1 ) + 1;
+    Simplex( lorenz2, "./", "", "1 500", "501 995", 3, 1, 0, 1,
+             "V1", "V3", false, false );
+
+    if ( IndexFiles( "./" ).size() != 2 ) {
+        failed++;
+        std::cout << RED_TEXT << "Neighbor index of changed data differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    ConfigureNeighborIndex( "" );
+
+    return failed ? 1 : 0;
+}
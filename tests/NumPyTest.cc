@@ -0,0 +1,99 @@
+// NumPy .npy and .npz file test
+
+#include <cstdio>
+#include <fstream>
+
+#include "TestCommon.h"
+
+int main () {
+
+    int failed = 0;
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    //---------------------------------------------------------
+    // .npy: 2-D array, mapped in place
+    //---------------------------------------------------------
+    lorenz.WriteNpy( "./", "LorenzData1000.npy" );
+
+    DataFrame < double > lorenzNpy( "./", "LorenzData1000.npy" );
+
+    if ( not lorenzNpy.Mapped() ) {
+        failed++;
+        std::cout << RED_TEXT << ".npy DataFrame was copied, not mapped"
+                  << RESET_TEXT << std::endl;
+    }
+
+    MakeTest ( "LorenzData1000 .npy round trip", lorenz, lorenzNpy );
+
+    //---------------------------------------------------------
+    // .npy of a shape whose size overflows: an error
+    //---------------------------------------------------------
+    std::ifstream npyStream( "LorenzData1000.npy", std::ios::binary );
+    std::string   bytes( ( std::istreambuf_iterator< char >( npyStream ) ),
+                         std::istreambuf_iterator< char >() );
+
+    // shape ( 2^61, 6 ): 2^61 x 6 x 8 bytes is 0 in 64 bits. The
+    // header keeps its length: padding spaces are removed.
+    std::string shape   = "(1000, 6)";
+    std::string crafted = "(2305843009213693952, 6)";
+    size_t      shape_i = bytes.find( shape );
+    size_t      end_i   = bytes.find( '\n' );
+    bytes.erase( end_i - ( crafted.size() - shape.size() ),
+                 crafted.size() - shape.size() );
+    bytes.replace( shape_i, shape.size(), crafted );
+
+    std::ofstream overflowStream( "Overflow.npy", std::ios::binary );
+    overflowStream.write( bytes.data(), bytes.size() );
+    overflowStream.close();
+
+    bool thrown = false;
+    try { DataFrame < double > overflow( "./", "Overflow.npy" ); }
+    catch ( const std::exception & ) { thrown = true; }
+
+    if ( not thrown ) {
+        failed++;
+        std::cout << RED_TEXT << ".npy of overflowing shape not thrown"
+                  << RESET_TEXT << std::endl;
+    }
+    std::remove( "Overflow.npy" );
+
+    //---------------------------------------------------------
+    // .npz: one array per column, named by the column
+    //---------------------------------------------------------
+    lorenz.WriteNpz( "./", "LorenzData1000.npz" );
+
+    DataFrame < double > lorenzNpz( "./", "LorenzData1000.npz" );
+
+    if ( lorenzNpz.ColumnNames() != lorenz.ColumnNames() ) {
+        failed++;
+        std::cout << RED_TEXT << ".npz column names differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    MakeTest ( "LorenzData1000 .npz round trip", lorenz, lorenzNpz );
+
+    DataFrame < double > lorenzNpzProj( "./", "LorenzData1000.npz",
+                                        "V3 V1" );
+
+    MakeTest ( "LorenzData1000 .npz column projection",
+               lorenz.DataFrameFromColumnNames( { "Time", "V1", "V3" } ),
+               lorenzNpzProj );
+
+    //---------------------------------------------------------
+    // Simplex from the .npz file
+    //---------------------------------------------------------
+    DataFrame < double > S = Simplex( "../data/", "LorenzData1000.csv",
+                                      "./", "", "1 500", "501 900",
+                                      3, 1, 0, 2, "V1 V3", "V1",
+                                      false, false );
+
+    DataFrame < double > S_npz = Simplex( "./", "LorenzData1000.npz",
+                                          "./", "", "1 500", "501 900",
+                                          3, 1, 0, 2, "V1 V3", "V1",
+                                          false, false );
+
+    MakeTest ( "Simplex LorenzData1000 .npz", S, S_npz );
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+// OnlineEngine test: forecasts as Simplex() and SMap() of the
+// observations so far, windows, errors. Checks that Update() and
+// Forecast() of a window do not allocate, reports their p50/p99
+// latency.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#include "TestCommon.h"
+#include "Online.h"
+
+//----------------------------------------------------------------
+// Allocations: of operator new, and of malloc in the objects linked
+// with -Wl,--wrap=malloc: the test and libEDM, with Eigen of SMap
+//----------------------------------------------------------------
+std::atomic< size_t > allocations( 0 );
+
+extern "C" void *__real_malloc( size_t size );
+extern "C" void *__wrap_malloc( size_t size ) {
+    allocations++;
+    return __real_malloc( size );
+}
+
+void *operator new( size_t size ) {
+    void *memory = std::malloc( size ); // counted by __wrap_malloc
+    if ( not memory ) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete( void *memory ) noexcept {
+    std::free( memory );
+}
+
+//----------------------------------------------------------------
+// DataFrame of rows [ start, stop ) of data
+//----------------------------------------------------------------
+DataFrame< double > Rows( const DataFrame< double > &data,
+                          size_t start, size_t stop ) {
+    DataFrame< double > rows( stop - start, data.NColumns() );
+    for ( size_t row = start; row < stop; row++ ) {
+        for ( size_t col = 0; col < data.NColumns(); col++ ) {
+            rows( row - start, col ) = data( row, col );
+        }
+    }
+    rows.ColumnNames() = data.ColumnNames();
+    return rows;
+}
+
+//----------------------------------------------------------------
+// Percentile of sorted latencies, microseconds
+//----------------------------------------------------------------
+double Percentile( const std::vector< double > &sorted, double p ) {
+    return 1E6 * sorted[ (size_t) ( p * ( sorted.size() - 1 ) ) ];
+}
+
+int main () {
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // Forecast of observation t: as the prediction of row t with
+    // library rows 1 to t of the embedding, rows of which are
+    // observation rows less (E-1) tau
+    //---------------------------------------------------------
+    size_t N0 = 300;
+    DataFrame < double > head = Rows( lorenz, 0, N0 );
+
+    OnlineEngine simplex( head, "V1", "V1", Method::Simplex, 3, 1, 0, 2 );
+    OnlineEngine smap( head, "V1", "V5", Method::SMap, 3, 1, 0, 1, 2. );
+
+    DataFrame < double > online( 3, 2, "Simplex SMap" );
+    DataFrame < double > batch ( 3, 2, "Simplex SMap" );
+    size_t               check = 0;
+
+    bool equal = true;
+    for ( size_t t = N0; t < lorenz.NRows(); t++ ) {
+        simplex.Update( lorenz( t, 1 ) );
+        smap.Update( { lorenz( t, 1 ), lorenz( t, 5 ) } );
+
+        if ( t != 400 and t != 600 and t != lorenz.NRows() - 1 ) {
+            continue;
+        }
+
+        std::string row = std::to_string( t - 4 + 1 );
+        DataFrame < double > simplexBlock =
+            Simplex( lorenz, "./", "", "1 " + row, row + " " + row,
+                     3, 1, 0, 2, "V1", "V1", false, false );
+
+        row = std::to_string( t - 2 + 1 );
+        SMapValues smapBlock =
+            SMap( lorenz, "./", "", "1 " + row, row + " " + row,
+                  3, 1, 0, 1, 2., "V1", "V5", "", "", false, false );
+
+        online( check, 0 ) = simplex.Forecast();
+        online( check, 1 ) = smap.Forecast();
+        batch ( check, 0 ) = simplexBlock( 1, 2 );
+        batch ( check, 1 ) = smapBlock.predictions( 1, 2 );
+
+        equal = equal and simplex.Knn() == 4 and smap.Knn() == t - 2 and
+            std::abs( online( check, 0 ) - batch( check, 0 ) ) < 1E-10 and
+            std::abs( online( check, 1 ) - batch( check, 1 ) ) < 1E-10;
+        check++;
+    }
+    MakeTest( "OnlineEngine forecasts", batch, online );
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "OnlineEngine forecasts differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Window of W observations: as Simplex() of a DataFrame of
+    // the last W observations
+    //---------------------------------------------------------
+    size_t W = 200;
+    size_t M = W - 2; // embedded rows of the window
+
+    OnlineEngine windowed( head, "V1 V3", "V1", Method::Simplex,
+                           3, 1, 5, 1, 0, W );
+
+    DataFrame < double > windowOnline( 3, 1, "Simplex" );
+    DataFrame < double > windowBatch ( 3, 1, "Simplex" );
+    check = 0;
+
+    equal = true;
+    for ( size_t t = N0; t < lorenz.NRows(); t++ ) {
+        windowed.Update( { lorenz( t, 1 ), lorenz( t, 3 ) } );
+
+        if ( t != 450 and t != 800 and t != lorenz.NRows() - 1 ) {
+            continue;
+        }
+
+        DataFrame < double > block = Simplex( Rows( lorenz, t - W + 1, t + 1 ),
+                                              "./", "",
+                                              "1 " + std::to_string( M ),
+                                              std::to_string( M ) + " " +
+                                              std::to_string( M ),
+                                              3, 1, 5, 1, "V1 V3", "V1",
+                                              false, false );
+
+        windowOnline( check, 0 ) = windowed.Forecast();
+        windowBatch ( check, 0 ) = block( 1, 2 );
+
+        equal = equal and windowed.Library().LibrarySize() == M - 1 and
+            std::abs( windowOnline( check, 0 ) - windowBatch( check, 0 ) ) <
+            1E-10;
+        check++;
+    }
+    MakeTest( "OnlineEngine window forecasts", windowBatch, windowOnline );
+    if ( not equal ) {
+        failed++;
+        std::cout << RED_TEXT << "OnlineEngine window forecasts differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Errors: method, columns, knn, observation values
+    //---------------------------------------------------------
+    size_t thrown = 0;
+    try { OnlineEngine( head, "V1", "V1", Method::Embed, 3 ); }
+    catch ( const std::exception & ) { thrown++; }
+    try { OnlineEngine( head, "", "V1", Method::Simplex, 3 ); }
+    catch ( const std::exception & ) { thrown++; }
+    try { OnlineEngine( head, "V1", "V1", Method::Simplex, 3, 1, 3 ); }
+    catch ( const std::exception & ) { thrown++; }
+    try { OnlineEngine( head, "V1", "V9", Method::SMap, 3 ); }
+    catch ( const std::exception & ) { thrown++; }
+    try { smap.Update( lorenz( 0, 1 ) ); }
+    catch ( const std::exception & ) { thrown++; }
+
+    if ( thrown != 5 ) {
+        failed++;
+        std::cout << RED_TEXT << "OnlineEngine errors not thrown"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Latency and allocations of Update() and Forecast() of a
+    // window, over the observations replayed. None allocate once
+    // the library holds a window.
+    //---------------------------------------------------------
+    OnlineEngine simplexTick( head, "V1 V3", "V1", Method::Simplex,
+                              3, 1, 0, 1, 0, W );
+    OnlineEngine smapTick( head, "V1 V3", "V1", Method::SMap,
+                           3, 1, 20, 1, 2., W );
+
+    std::vector< double > simplexTime;
+    std::vector< double > smapTime;
+    std::vector< double > observation( 2 );
+    size_t                ticks = 5000;
+    size_t                warm  = 0;
+    simplexTime.reserve( ticks );
+    smapTime.reserve( ticks );
+
+    for ( size_t t = 0; t < ticks; t++ ) {
+        if ( t == 2 * W ) {
+            warm = allocations;
+        }
+        size_t row = ( N0 + t ) % lorenz.NRows();
+        observation[ 0 ] = lorenz( row, 1 );
+        observation[ 1 ] = lorenz( row, 3 );
+
+        auto start = std::chrono::steady_clock::now();
+        simplexTick.Update( observation.data() );
+        simplexTick.Forecast();
+        auto middle = std::chrono::steady_clock::now();
+        smapTick.Update( observation.data() );
+        smapTick.Forecast();
+        auto stop = std::chrono::steady_clock::now();
+
+        simplexTime.push_back( std::chrono::duration< double >
+                               ( middle - start ).count() );
+        smapTime.push_back( std::chrono::duration< double >
+                            ( stop - middle ).count() );
+    }
+    size_t allocated = allocations - warm;
+
+    if ( allocated ) {
+        failed++;
+        std::cout << RED_TEXT << "OnlineEngine window ticks allocated "
+                  << allocated << " times" << RESET_TEXT << std::endl;
+    }
+    std::sort( simplexTime.begin(), simplexTime.end() );
+    std::sort( smapTime.begin(), smapTime.end() );
+
+    std::cout << "OnlineEngine window " << W << " tick (us): Simplex p50 "
+              << Percentile( simplexTime, 0.5 ) << " p99 "
+              << Percentile( simplexTime, 0.99 ) << "  SMap knn 20 p50 "
+              << Percentile( smapTime, 0.5 ) << " p99 "
+              << Percentile( smapTime, 0.99 ) << std::endl;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,42 @@
+// Column projection at load time test
+
+#include "TestCommon.h"
+
+int main () {
+
+    //---------------------------------------------------------
+    // CSV: time and the named columns, in file order
+    //---------------------------------------------------------
+    DataFrame < double > block( "../data/", "block_3sp.csv" );
+
+    DataFrame < double > blockProj( "../data/", "block_3sp.csv",
+                                    "z_t x_t" );
+
+    MakeTest ( "block_3sp CSV column projection",
+               block.DataFrameFromColumnNames( { "time", "x_t", "z_t" } ),
+               blockProj );
+
+    //---------------------------------------------------------
+    // Binary DataFrame file
+    //---------------------------------------------------------
+    block.WriteBinary( "./", "block_3sp.bin" );
+
+    DataFrame < double > blockBinProj( "./", "block_3sp.bin", "z_t x_t" );
+
+    MakeTest ( "block_3sp binary column projection", blockProj,
+               blockBinProj );
+
+    //---------------------------------------------------------
+    // Simplex on a projected file load vs the DataFrame overload
+    //---------------------------------------------------------
+    DataFrame < double > S = Simplex( block, "./", "", "1 99", "100 195",
+                                      3, 1, 0, 1, "y_t", "x_t",
+                                      false, false );
+
+    DataFrame < double > S_proj = Simplex( "../data/", "block_3sp.csv",
+                                           "./", "", "1 99", "100 195",
+                                           3, 1, 0, 1, "y_t", "x_t",
+                                           false, false );
+
+    MakeTest ( "Simplex block_3sp column projection", S, S_proj );
+}
@@ -0,0 +1,97 @@
+// RollingOrigin test
+
+#include "TestCommon.h"
+
+//----------------------------------------------------------------
+// Skill of each fold from Simplex() or SMap() on the fold lib, pred
+//----------------------------------------------------------------
+DataFrame< double > FoldSkill( DataFrame< double > data,
+                               DataFrame< double > folds,
+                               Method method, int E, int Tp, int knn,
+                               int tau, double theta,
+                               std::string columns, std::string target,
+                               bool embedded ) {
+
+    DataFrame< double > skill( folds.NRows(), folds.NColumns() );
+
+    for ( size_t f = 0; f < folds.NRows(); f++ ) {
+        std::stringstream lib, pred;
+        lib  << folds( f, 1 ) << " " << folds( f, 2 );
+        pred << folds( f, 3 ) << " " << folds( f, 4 );
+
+        DataFrame< double > S;
+        if ( method == Method::SMap ) {
+            S = SMap( data, "./", "", lib.str(), pred.str(),
+                      E, Tp, knn, tau, theta, columns, target,
+                      "", "", embedded, false ).predictions;
+        }
+        else {
+            S = Simplex( data, "./", "", lib.str(), pred.str(),
+                         E, Tp, knn, tau, columns, target,
+                         embedded, false );
+        }
+
+        VectorError ve = ComputeError( S.VectorColumnName("Observations"),
+                                       S.VectorColumnName("Predictions") );
+
+        std::valarray< double > row = folds.Row( f );
+        row[ 5 ] = ve.rho;
+        row[ 6 ] = ve.RMSE;
+        row[ 7 ] = ve.MAE;
+        skill.WriteRow( f, row );
+    }
+    return skill;
+}
+
+int main () {
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // Simplex, overlapping folds: neighbors updated across folds
+    //---------------------------------------------------------
+    DataFrame < double > tentData( "../data/", "TentMap_rEDM.csv" );
+
+    RollingValues rolling = RollingOrigin( tentData, "./", "", "1 300",
+                                           100, 50, 0, Method::Simplex,
+                                           3, 1, 0, 1, 0,
+                                           "TentMap", "TentMap",
+                                           false, false );
+
+    DataFrame < double > skill = FoldSkill( tentData, rolling.Folds,
+                                            Method::Simplex, 3, 1, 0, 1, 0,
+                                            "TentMap", "TentMap", false );
+
+    MakeTest ( "Simplex rolling origin TentMap", skill, rolling.Folds );
+
+    if ( MaxDifference( skill, rolling.Folds ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "Simplex rolling origin TentMap differs by "
+                  << MaxDifference( skill, rolling.Folds ) << RESET_TEXT
+                  << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // SMap, disjoint folds
+    //  - already embedded
+    //---------------------------------------------------------
+    DataFrame < double > circleData( "../data/", "circle.csv" );
+
+    rolling = RollingOrigin( circleData, "./", "", "1 60", 20, 0, 0,
+                             Method::SMap, 2, 1, 15, 1, 4,
+                             "x y", "x", true, false );
+
+    skill = FoldSkill( circleData, rolling.Folds, Method::SMap,
+                       2, 1, 15, 1, 4, "x y", "x", true );
+
+    MakeTest ( "SMap rolling origin circle", skill, rolling.Folds );
+
+    if ( MaxDifference( skill, rolling.Folds ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "SMap rolling origin circle differs by "
+                  << MaxDifference( skill, rolling.Folds ) << RESET_TEXT
+                  << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+// ParameterSearch test
+// Successive halving compared to the exhaustive ParameterSweep():
+// reports the speedup and the loss of rho of the selected configuration
+
+#include <chrono>
+
+#include "TestCommon.h"
+
+//----------------------------------------------------------------
+// Run ParameterSweep() and ParameterSearch() on one data set
+//----------------------------------------------------------------
+void CompareSearch( std::string testName, std::string dataFile,
+                    std::string lib,      std::string pred,
+                    std::string E,        std::string Tp,
+                    std::string tau,      std::string knn,
+                    std::string theta,    std::string columns,
+                    std::string target,   bool        embedded ) {
+
+    DataFrame < double > data( "../data/", dataFile );
+
+    auto start = std::chrono::steady_clock::now();
+
+    DataFrame < double > sweep = ParameterSweep( data, "./", "", lib, pred,
+                                                 E, Tp, tau, knn, theta,
+                                                 columns, target,
+                                                 embedded, false );
+
+    auto middle = std::chrono::steady_clock::now();
+
+    SearchValues search = ParameterSearch( data, "./", "", lib, pred,
+                                           E, Tp, tau, knn, theta,
+                                           columns, target,
+                                           embedded, false );
+
+    auto stop = std::chrono::steady_clock::now();
+
+    // Best rho of the exhaustive sweep
+    std::valarray< double > rho = sweep.VectorColumnName( "rho" );
+    double rhoSweep = rho.max();
+
+    // rho of the selected configuration on all prediction rows
+    double rhoSearch = search.Best( 0, 7 );
+
+    std::chrono::duration< double > sweepTime  = middle - start;
+    std::chrono::duration< double > searchTime = stop   - middle;
+
+    std::cout << testName << ": configurations " << sweep.NRows()
+              << "  evaluations " << search.evaluations
+              << " of " << search.exhaustive
+              << "  speedup " << sweepTime.count() / searchTime.count()
+              << "  rho loss " << rhoSweep - rhoSearch << std::endl;
+
+    DataFrame < double > rhoBest( 1, 1 );
+    DataFrame < double > rhoSelected( 1, 1 );
+    rhoBest    ( 0, 0 ) = rhoSweep;
+    rhoSelected( 0, 0 ) = rhoSearch;
+
+    MakeTest( testName, rhoBest, rhoSelected );
+}
+
+int main () {
+
+    CompareSearch( "Simplex search TentMap", "TentMap_rEDM.csv",
+                   "1 500", "501 950", "1 2 3 4 5 6 7 8 9 10", "1 2 3",
+                   "1 2", "0", "", "TentMap", "TentMap", false );
+
+    CompareSearch( "Simplex search TentMapNoise", "TentMapNoise_rEDM.csv",
+                   "1 500", "501 950", "1 2 3 4 5 6 7 8 9 10", "1 2 3",
+                   "1 2", "0", "", "TentMap", "TentMap", false );
+
+    CompareSearch( "Simplex search Lorenz", "LorenzData1000.csv",
+                   "1 500", "501 950", "1 2 3 4 5 6 7 8", "1 5 10",
+                   "1 3 5", "0", "", "V1", "V1", false );
+
+    CompareSearch( "SMap search circle_noise", "circle_noise.csv",
+                   "1 100", "101 198", "2", "1 2", "1", "10 20 40",
+                   "0 0.5 1 2 4 8", "x y", "x", true );
+
+    CompareSearch( "SMap search block_3sp", "block_3sp.csv",
+                   "1 99", "100 190", "1 2 3 4", "1", "1", "0",
+                   "0 0.5 1 2 4", "x_t", "x_t", false );
+}
@@ -0,0 +1,105 @@
+// ResultSink test
+
+#include "TestCommon.h"
+
+//----------------------------------------------------------------
+// Values equal, or both nan
+// @return: 1 if they differ, else 0
+//----------------------------------------------------------------
+int CheckValues( std::string testName,
+                 DataFrame< double > &data1, DataFrame< double > &data2 ) {
+    if ( data1.NRows() != data2.NRows() or
+         data1.NColumns() != data2.NColumns() or
+         data1.ColumnNames() != data2.ColumnNames() ) {
+        std::cout << RED_TEXT << testName << ": dimensions or column names"
+                  << " differ" << RESET_TEXT << std::endl;
+        return 1;
+    }
+    for ( size_t row = 0; row < data1.NRows(); row++ ) {
+        for ( size_t col = 0; col < data1.NColumns(); col++ ) {
+            double x = data1( row, col );
+            double y = data2( row, col );
+            if ( x != y and not ( std::isnan( x ) and std::isnan( y ) ) ) {
+                std::cout << RED_TEXT << testName << ": value differs at"
+                          << " row " << row << " column " << col
+                          << RESET_TEXT << std::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main () {
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // Series long enough for several blocks of sink rows
+    //---------------------------------------------------------
+    DataFrame< double > data( 12000, 3, "Time x y" );
+    for ( size_t row = 0; row < data.NRows(); row++ ) {
+        data( row, 0 ) = 0.5 * row;
+        data( row, 1 ) = sin( 0.05 * row ) + 0.3 * sin( 0.31 * row );
+        data( row, 2 ) = cos( 0.07 * row );
+    }
+
+    //---------------------------------------------------------
+    // Simplex: memory, CSV and binary sinks
+    //---------------------------------------------------------
+    DataFrame< double > S = Simplex( data, "./", "SimplexSink.csv",
+                                     "1 2000", "2001 11990",
+                                     3, 3, 0, 2, "x y", "x",
+                                     false, false );
+
+    MemorySink memory;
+    Simplex( data, memory, "1 2000", "2001 11990",
+             3, 3, 0, 2, "x y", "x", false, false );
+
+    DataFrame< double > S_memory = memory.Data();
+
+    failed += CheckValues( "Simplex memory sink", S, S_memory );
+    MakeTest( "Simplex memory sink", S, S_memory );
+
+    CSVSink csv( "./", "SimplexSink2.csv" );
+    Simplex( data, csv, "1 2000", "2001 11990",
+             3, 3, 0, 2, "x y", "x", false, false );
+
+    DataFrame< double > S_file  ( "./", "SimplexSink.csv"  );
+    DataFrame< double > S_csv   ( "./", "SimplexSink2.csv" );
+
+    failed += CheckValues( "Simplex CSV sink", S_file, S_csv );
+
+    BinarySink binary( "./", "SimplexSink.bin" );
+    Simplex( data, binary, "1 2000", "2001 11990",
+             3, 3, 0, 2, "x y", "x", false, false );
+
+    DataFrame< double > S_binary( "./", "SimplexSink.bin" );
+
+    failed += CheckValues( "Simplex binary sink", S, S_binary );
+    MakeTest( "Simplex binary sink", S, S_binary );
+
+    //---------------------------------------------------------
+    // SMap: predictions and coefficients
+    //---------------------------------------------------------
+    SMapValues SM = SMap( data, "./", "", "1 1000", "1001 9000",
+                          2, 1, 0, 1, 2., "x", "x", "", "",
+                          false, false );
+
+    MemorySink predictions, coefficients;
+    SMap( data, predictions, &coefficients, "1 1000", "1001 9000",
+          2, 1, 0, 1, 2., "x", "x", false, false );
+
+    DataFrame< double > SM_predictions  = predictions.Data();
+    DataFrame< double > SM_coefficients = coefficients.Data();
+
+    failed += CheckValues( "SMap predictions sink", SM.predictions,
+                           SM_predictions );
+    failed += CheckValues( "SMap coefficients sink", SM.coefficients,
+                           SM_coefficients );
+
+    MakeTest( "SMap predictions sink", SM.predictions, SM_predictions );
+    MakeTest( "SMap coefficients sink", SM.coefficients, SM_coefficients );
+
+    return failed ? 1 : 0;
+}
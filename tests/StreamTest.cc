@@ -0,0 +1,80 @@
+// Streaming CSV reader and SimplexStream test
+
+#include "TestCommon.h"
+
+int main () {
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // CSVChunkReader: chunks of selected columns
+    //---------------------------------------------------------
+    DataFrame < double > block( "../data/", "block_3sp.csv" );
+
+    CSVChunkReader reader( "../data/", "block_3sp.csv", 17 );
+    reader.SelectColumns( std::vector< std::string >{ "time", "z_t", "x_t" } );
+
+    DataFrame < double > chunks( block.NRows(), 3, reader.ColumnNames() );
+    CSVData chunk;
+    size_t  row = 0;
+
+    while ( reader.NextChunk( chunk ) ) {
+        for ( size_t i = 0; i < chunk.n_rows; i++ ) {
+            chunks.WriteRow( row++,
+                             chunk.elements[ std::slice( i * 3, 3, 1 ) ] );
+        }
+    }
+
+    DataFrame < double > columns =
+        block.DataFrameFromColumnNames( reader.ColumnNames() );
+
+    MakeTest ( "CSVChunkReader block_3sp columns", columns, chunks );
+
+    if ( MaxDifference( columns, chunks ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "CSVChunkReader block_3sp columns differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // SimplexStream: embedded
+    //---------------------------------------------------------
+    DataFrame < double > S = Simplex( "../data/", "block_3sp.csv", "./", "",
+                                      "1 99", "100 198", 3, 1, 0, 1,
+                                      "x_t y_t z_t", "x_t", true, false );
+
+    DataFrame < double > S_stream = SimplexStream(
+        "../data/", "block_3sp.csv", "./", "", "1 99", "100 198", 3, 1, 0, 1,
+        "x_t y_t z_t", "x_t", true, false, 23 );
+
+    MakeTest ( "SimplexStream block_3sp embedded", S, S_stream );
+
+    if ( MaxDifference( S, S_stream ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "SimplexStream block_3sp embedded differs by "
+                  << MaxDifference( S, S_stream ) << RESET_TEXT
+                  << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // SimplexStream: multivariable embedding, tau 2, Tp 3
+    //---------------------------------------------------------
+    S = Simplex( "../data/", "LorenzData1000.csv", "./", "",
+                 "1 600", "601 900", 3, 3, 0, 2,
+                 "V1 V3", "V1", false, false );
+
+    S_stream = SimplexStream( "../data/", "LorenzData1000.csv", "./", "",
+                              "1 600", "601 900", 3, 3, 0, 2,
+                              "V1 V3", "V1", false, false, 50 );
+
+    MakeTest ( "SimplexStream Lorenz V1 V3", S, S_stream );
+
+    if ( MaxDifference( S, S_stream ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "SimplexStream Lorenz V1 V3 differs by "
+                  << MaxDifference( S, S_stream ) << RESET_TEXT
+                  << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
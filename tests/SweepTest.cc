@@ -0,0 +1,94 @@
+// ParameterSweep test
+
+#include "TestCommon.h"
+
+int main () {
+
+    int failed = 0;
+
+    //---------------------------------------------------------
+    // Simplex grid over E, Tp, tau compared to Simplex() calls
+    //---------------------------------------------------------
+    DataFrame < double > tentData( "../data/", "TentMap_rEDM.csv" );
+
+    DataFrame < double > sweep = ParameterSweep( tentData, "./", "",
+                                                 "1 100", "201 500",
+                                                 "1 2 3 4", "1 2 3", "1 2",
+                                                 "0", "", "TentMap",
+                                                 "TentMap", false, false );
+
+    DataFrame < double > expect( sweep.NRows(), sweep.NColumns() );
+
+    for ( size_t row = 0; row < sweep.NRows(); row++ ) {
+        int E   = sweep( row, 0 );
+        int Tp  = sweep( row, 1 );
+        int tau = sweep( row, 2 );
+        int knn = sweep( row, 3 );
+
+        DataFrame < double > S = Simplex( tentData, "./", "",
+                                          "1 100", "201 500",
+                                          E, Tp, 0, tau,
+                                          "TentMap", "TentMap",
+                                          false, false );
+
+        VectorError ve = ComputeError( S.VectorColumnName("Observations"),
+                                       S.VectorColumnName("Predictions") );
+
+        expect.WriteRow( row, std::valarray<double>(
+            { (double) E, (double) Tp, (double) tau, (double) knn, 0,
+              ve.rho, ve.RMSE, ve.MAE } ) );
+    }
+
+    MakeTest ( "Simplex sweep TentMap", expect, sweep );
+
+    if ( MaxDifference( expect, sweep ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "Simplex sweep TentMap differs by "
+                  << MaxDifference( expect, sweep ) << RESET_TEXT
+                  << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // SMap grid over Tp, knn, theta compared to SMap() calls
+    //  - already embedded
+    //---------------------------------------------------------
+    DataFrame < double > circleData( "../data/", "circle.csv" );
+
+    sweep = ParameterSweep( circleData, "./", "", "1 100", "101 198",
+                            "2", "1 2", "1", "10 20", "0 1 4",
+                            "x y", "x", true, false );
+
+    expect = DataFrame < double >( sweep.NRows(), sweep.NColumns() );
+
+    for ( size_t row = 0; row < sweep.NRows(); row++ ) {
+        int    E     = sweep( row, 0 );
+        int    Tp    = sweep( row, 1 );
+        int    knn   = sweep( row, 3 );
+        double theta = sweep( row, 4 );
+
+        SMapValues smapVals = SMap( circleData, "./", "",
+                                    "1 100", "101 198",
+                                    E, Tp, knn, 1, theta,
+                                    "x y", "x", "", "", true, false );
+
+        DataFrame < double > S = smapVals.predictions;
+
+        VectorError ve = ComputeError( S.VectorColumnName("Observations"),
+                                       S.VectorColumnName("Predictions") );
+
+        expect.WriteRow( row, std::valarray<double>(
+            { (double) E, (double) Tp, 1, (double) knn, theta,
+              ve.rho, ve.RMSE, ve.MAE } ) );
+    }
+
+    MakeTest ( "SMap sweep circle", expect, sweep );
+
+    if ( MaxDifference( expect, sweep ) > 0 ) {
+        failed++;
+        std::cout << RED_TEXT << "SMap sweep circle differs by "
+                  << MaxDifference( expect, sweep ) << RESET_TEXT
+                  << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
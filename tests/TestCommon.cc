@@ -125,3 +125,36 @@ void MakeTest (std::string testName, DataFrame< double > data1,
     
     std::cout << RESET_TEXT << std::endl << std::flush;
 }
+
+//----------------------------------------------------------------
+// Largest absolute difference of two DataFrames
+// @param data1:    first DataFrame to check
+// @param data2:    second DataFrame to check
+// @return:         0 if all values are equal, nan in the same
+//                  places are equal; infinity if dimensions differ
+//----------------------------------------------------------------
+double MaxDifference ( const DataFrame< double > &data1,
+                       const DataFrame< double > &data2 ) {
+
+    if ( data1.NRows()    != data2.NRows() or
+         data1.NColumns() != data2.NColumns() ) {
+        return std::numeric_limits< double >::infinity();
+    }
+
+    double maxDiff = 0;
+    for ( size_t rowIdx = 0; rowIdx < data1.NRows(); rowIdx++ ) {
+        for ( size_t colIdx = 0; colIdx < data1.NColumns(); colIdx++ ) {
+            double value1 = data1( rowIdx, colIdx );
+            double value2 = data2( rowIdx, colIdx );
+
+            if ( std::isnan( value1 ) or std::isnan( value2 ) ) {
+                if ( not ( std::isnan( value1 ) and std::isnan( value2 ) ) ) {
+                    return std::numeric_limits< double >::infinity();
+                }
+                continue;
+            }
+            maxDiff = std::max( maxDiff, std::abs( value1 - value2 ) );
+        }
+    }
+    return maxDiff;
+}
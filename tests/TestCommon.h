@@ -7,6 +7,7 @@
 #include <iomanip>
 #include <string>
 #include <cmath>
+#include <limits>
 #include "Common.h"
 
 #define STR_LINE_SEP "-------------------------------------------------"
@@ -23,4 +24,8 @@ const std::string RESET_TEXT ("\033[0m"   );
 void MakeTest ( std::string testName,
                 DataFrame< double > data1, 
                 DataFrame< double > data2 );
+
+// 0 if data1 and data2 are the same values
+double MaxDifference ( const DataFrame< double > &data1,
+                       const DataFrame< double > &data2 );
 #endif
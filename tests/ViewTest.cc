@@ -0,0 +1,73 @@
+// DataFrameView test
+
+#include "TestCommon.h"
+#include "Embed.h"
+
+int main () {
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    //---------------------------------------------------------
+    // Rows and columns of a view are those of the DataFrame
+    //---------------------------------------------------------
+    DataFrameView< double > view =
+        lorenz.View().Rows( 100, 500 ).Columns( { "Time", "V3", "V1" } );
+
+    std::vector< std::string > names = { "Time", "V3", "V1" };
+    size_t frameColumn[] = { 0, 3, 1 };
+
+    bool equal = view.NRows() == 500 and view.NColumns() == 3 and
+                 view.ColumnNames() == names;
+    for ( size_t row = 0; equal and row < view.NRows(); row++ ) {
+        for ( size_t col = 0; col < view.NColumns(); col++ ) {
+            equal = equal and
+                view( row, col ) == lorenz( row + 100, frameColumn[ col ] );
+        }
+    }
+    if ( not equal ) {
+        std::cout << RED_TEXT << "DataFrameView rows and columns differ"
+                  << RESET_TEXT << std::endl;
+    }
+
+    // Views of a view
+    DataFrameView< double > view2 = view.Rows( 10, 20 ).Columns(
+        std::vector< size_t >( 1, 1 ) );
+    if ( view2.ColumnNames()[ 0 ] != "V3" or
+         view2( 5, 0 ) != lorenz( 115, 3 ) or
+         view2.VectorColumnName( "V3" ).size() != 20 ) {
+        std::cout << RED_TEXT << "DataFrameView of a view differs"
+                  << RESET_TEXT << std::endl;
+    }
+
+    //---------------------------------------------------------
+    // Copy of a view: as the DataFrame row and column copies
+    //---------------------------------------------------------
+    DataFrame < double > columns =
+        lorenz.DataFrameFromColumnNames( { "Time", "V3", "V1" } );
+    DataFrame < double > rows( 500, 3, names );
+    for ( size_t row = 0; row < rows.NRows(); row++ ) {
+        rows.WriteRow( row, columns.Row( row + 100 ) );
+    }
+
+    DataFrame < double > viewCopy( view );
+
+    MakeTest( "DataFrameView copy", rows, viewCopy );
+
+    //---------------------------------------------------------
+    // Simplex and Embed of a view: as of its copy
+    //---------------------------------------------------------
+    DataFrame < double > S_view = Simplex( view, "./", "", "1 300",
+                                           "301 495", 3, 1, 0, 1,
+                                           "V1", "V3", false, false );
+
+    DataFrame < double > S_copy = Simplex( viewCopy, "./", "", "1 300",
+                                           "301 495", 3, 1, 0, 1,
+                                           "V1", "V3", false, false );
+
+    MakeTest( "Simplex of DataFrameView", S_copy, S_view );
+
+    DataFrame < double > E_view = Embed( view,     3, 2, "V1 V3" );
+    DataFrame < double > E_copy = Embed( viewCopy, 3, 2, "V1 V3" );
+
+    MakeTest( "Embed of DataFrameView", E_copy, E_view );
+}
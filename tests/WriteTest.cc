@@ -0,0 +1,135 @@
+// DataFrame::WriteData() CSV output test
+
+#include <fstream>
+#include "TestCommon.h"
+
+//----------------------------------------------------------------
+// Contents of a file
+//----------------------------------------------------------------
+std::string FileText( std::string fileName ) {
+    std::ifstream     file( fileName );
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+//----------------------------------------------------------------
+// CSV text of data as the stream formatted WriteData() output
+//----------------------------------------------------------------
+std::string StreamText( DataFrame< double > &data, int precision ) {
+    std::stringstream text;
+    text.precision( precision );
+    text.setf( std::ios::fixed, std::ios::floatfield );
+
+    for ( size_t col = 0; col < data.NColumns(); col++ ) {
+        text << data.ColumnNames()[ col ]
+             << ( col + 1 < data.NColumns() ? "," : "\n" );
+    }
+    for ( size_t row = 0; row < data.NRows(); row++ ) {
+        for ( size_t col = 0; col < data.NColumns(); col++ ) {
+            text << data( row, col )
+                 << ( col + 1 < data.NColumns() ? "," : "\n" );
+        }
+    }
+    return text.str();
+}
+
+//----------------------------------------------------------------
+void CheckText( std::string testName, std::string text1, std::string text2 ) {
+    if ( text1 != text2 ) {
+        std::cout << RED_TEXT << testName << ": file text differs"
+                  << RESET_TEXT << std::endl;
+    }
+}
+
+//----------------------------------------------------------------
+void CheckValues( std::string testName,
+                  DataFrame< double > &data1, DataFrame< double > &data2 ) {
+    for ( size_t row = 0; row < data1.NRows(); row++ ) {
+        for ( size_t col = 0; col < data1.NColumns(); col++ ) {
+            if ( data1( row, col ) != data2( row, col ) ) {
+                std::cout << RED_TEXT << testName << ": value differs at"
+                          << " row " << row << " column " << col
+                          << RESET_TEXT << std::endl;
+                return;
+            }
+        }
+    }
+}
+
+int main () {
+
+    //---------------------------------------------------------
+    // Fixed precision: same text as the stream formatting
+    //---------------------------------------------------------
+    double values[] = { 0, -0., 1, -1, 0.5, 0.00005, -0.00005, 0.00015,
+                        1.00005, 2.5E-5, -1.E-9, 123456.78905, 1.E15,
+                        -3.14159265358979, 9.99995, 1.E300, -1.E-300,
+                        NAN, INFINITY, -INFINITY, 4503599627370495.5 };
+    size_t N_values = sizeof( values ) / sizeof( values[ 0 ] );
+
+    DataFrame< double > edge( N_values, 2, "x y" );
+    for ( size_t row = 0; row < N_values; row++ ) {
+        edge( row, 0 ) = values[ row ];
+        edge( row, 1 ) = values[ row ] / 3;
+    }
+
+    for ( int precision = 0; precision < 8; precision++ ) {
+        edge.WriteData( "./", "WriteEdge.csv", precision );
+        CheckText( "Fixed precision " + std::to_string( precision ),
+                   FileText( "./WriteEdge.csv" ),
+                   StreamText( edge, precision ) );
+    }
+
+    DataFrame < double > lorenz( "../data/", "LorenzData1000.csv" );
+
+    lorenz.WriteData( "./", "LorenzWrite.csv" );
+    CheckText( "LorenzData1000 precision 4",
+               FileText( "./LorenzWrite.csv" ), StreamText( lorenz, 4 ) );
+
+    DataFrame < double > lorenzFixed( "./", "LorenzWrite.csv" );
+
+    MakeTest ( "LorenzData1000 WriteData precision 4", lorenz, lorenzFixed );
+
+    //---------------------------------------------------------
+    // Round trip precision: values read back unchanged
+    //---------------------------------------------------------
+    lorenz.WriteData( "./", "LorenzWrite.csv", PrecisionRoundTrip );
+
+    DataFrame < double > lorenzRoundTrip( "./", "LorenzWrite.csv" );
+
+    CheckValues( "LorenzData1000 round trip", lorenz, lorenzRoundTrip );
+
+    MakeTest ( "LorenzData1000 WriteData round trip", lorenz,
+               lorenzRoundTrip );
+
+    //---------------------------------------------------------
+    // Parallel formatting: same text as one thread
+    //---------------------------------------------------------
+    ThreadPool pool( 4 );
+
+    DataFrame< double > tall( 50000, 3, "Time x y" );
+    for ( size_t row = 0; row < tall.NRows(); row++ ) {
+        tall( row, 0 ) = row + 1;
+        tall( row, 1 ) = sin( 0.01 * row ) * 1000;
+        tall( row, 2 ) = cos( 0.37 * row ) / ( row + 1 );
+    }
+
+    for ( int precision = 4; precision >= PrecisionRoundTrip;
+          precision -= 5 ) {
+        tall.WriteData( "./", "TallWrite.csv", precision,
+                        ExecutionContext( &pool, 1 ) );
+        std::string serial = FileText( "./TallWrite.csv" );
+
+        tall.WriteData( "./", "TallWrite.csv", precision,
+                        ExecutionContext( &pool ) );
+        CheckText( "Parallel precision " + std::to_string( precision ),
+                   FileText( "./TallWrite.csv" ), serial );
+    }
+
+    DataFrame < double > tallRead( "./", "TallWrite.csv" );
+
+    CheckValues( "Parallel round trip", tall, tallRead );
+
+    MakeTest ( "WriteData parallel rows", tall, tallRead );
+}